@@ -200,6 +200,8 @@ internal void MixSounds(SoundMixer *mixer, uint32 sampleFrequency, __m128 *realC
         
         if(soundFinished)
         {
+            if(playingSound->SourceReferenceCount)
+                _InterlockedDecrement((volatile long*)playingSound->SourceReferenceCount);
             *playingSoundPtr = playingSound->Next;
             playingSound->Next = mixer->FirstFreePlayingSound;
             mixer->FirstFreePlayingSound = playingSound;
@@ -211,7 +213,13 @@ internal void MixSounds(SoundMixer *mixer, uint32 sampleFrequency, __m128 *realC
     }
 }
 
-internal PlayingSound* PlaySound(SoundMixer *mixer, Sound *sound, real32 volume = 1.0f, real32 pitch = 1.0f, bool32 loop = false)
+// NOTE(Joey): referenceCount (if any) is incremented for as long as the sound plays
+internal PlayingSound* PlaySound(SoundMixer *mixer, 
+                                 Sound *sound, 
+                                 real32 volume = 1.0f, 
+                                 real32 pitch = 1.0f, 
+                                 bool32 loop = false, 
+                                 volatile u32 *referenceCount = 0)
 {
     // NOTE(Joey): get new|free PlayingSound at top of linked list
     PlayingSound *playingSound = 0;
@@ -230,6 +238,9 @@ internal PlayingSound* PlaySound(SoundMixer *mixer, Sound *sound, real32 volume
     
     // NOTE(Joey): initialize playing sound
     playingSound->Source = sound; 
+    playingSound->SourceReferenceCount = referenceCount;
+    if(referenceCount)
+        _InterlockedIncrement((volatile long*)referenceCount);
     playingSound->SamplesPlayed = 0;
     playingSound->Loop = loop;
     playingSound->CurrentVolume[0] = playingSound->TargetVolume[0] = volume;
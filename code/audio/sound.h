@@ -27,6 +27,7 @@ struct PlayingSound
     // TODO(Joey): replace with unique Asset ID scheme | GUID
     // I don't want to chase too much pointers.
     Sound *Source; 
+    volatile u32 *SourceReferenceCount; // NOTE(Joey): released once the sound finishes; keeps its asset from being evicted
     
     r32 SamplesPlayed;
     b32 Loop;
@@ -35,9 +35,10 @@ inline riff_iterator NextChunk(riff_iterator iter)
     return(iter);
 }
              
+// NOTE(Joey): a chunk is only valid if its header lies within the contents
 inline bool32 IsValid(riff_iterator iter)
 {    
-    bool32 result = (iter.At < iter.Stop);
+    bool32 result = (iter.At < iter.Stop) && ((memory_index)(iter.Stop - iter.At) >= sizeof(WAVEChunk));
     
     return(result);
 }
@@ -65,86 +66,99 @@ inline uint32 GetChunkDataSize(riff_iterator iter)
     return(result);
 }
 
-internal Sound LoadWAV(debug_platform_read_entire_file *readEntireFile, char *fileName)
+/* NOTE(Joey):
+
+  Locates the samples in the file's contents w/o touching them. Every
+  chunk is bounded by both the RIFF header's size and the file's, so a
+  truncated or malformed file can't make it read past the contents. Files
+  that aren't 16 bit PCM at 48000 Hz w/ 1 or 2 channels aren't supported;
+  these, as well as malformed files, return an empty result (0 channels).
+
+*/
+internal wav_samples ParseWAV(void *contents, memory_index size)
 {
-    Sound result = {};
+    wav_samples result = {};
+    
+    WAVEHeader *header = (WAVEHeader*)contents;
+    if(size < sizeof(WAVEHeader) || header->RIFFID != WAVE_ID_RIFF || header->WAVEID != WAVE_ID_WAVE)
+        return(result);
+    
+    // NOTE(Joey): the RIFF size counts the WAVE id, but not the RIFF id and size fields
+    memory_index riffSize = Minimum((memory_index)header->Size, size - 2*sizeof(uint32));
+    if(riffSize < sizeof(uint32))
+        return(result);
     
-    debug_read_file_result readResult = readEntireFile(fileName);    
-    if(readResult.ContentSize != 0)
+    uint32 channelCount = 0;
+    uint32 sampleDataSize = 0;
+    int16 *sampleData = 0;
+    for(riff_iterator iter = ParseChunkAt(header + 1, (uint8 *)(header + 1) + riffSize - sizeof(uint32));
+        IsValid(iter);
+        iter = NextChunk(iter))
     {
-        WAVEHeader *header = (WAVEHeader*)readResult.Contents;
-        Assert(header->RIFFID == WAVE_ID_RIFF);
-        Assert(header->WAVEID == WAVE_ID_WAVE);        
+        uint32 chunkSize = GetChunkDataSize(iter);
+        if(chunkSize > (memory_index)(iter.Stop - (uint8*)GetChunkData(iter)))
+            return(result);
         
-        uint32 channelCount = 0;
-        uint32 sampleDataSize = 0;
-        int16 *sampleData = 0;
-        for(riff_iterator iter = ParseChunkAt(header + 1, (uint8 *)(header + 1) + header->Size - 4);
-            IsValid(iter);
-            iter = NextChunk(iter))
+        switch(GetType(iter))
         {
-            switch(GetType(iter))
-            {
-                case WAVE_ID_FMT:
-                {
-                    WAVEFormat *fmt = (WAVEFormat*)GetChunkData(iter);
-                    Assert(fmt->WFormatTag == 1); // NOTE(Joey): only support PCM WAV files
-                    Assert(fmt->NSamplesPerSec == 48000);
-                    Assert(fmt->WBitsPerSample == 16);
-                    Assert(fmt->NBlockAlign == (sizeof(int16)*fmt->NChannels));
-                    channelCount = fmt->NChannels;
-                } break;
-
-                case WAVE_ID_DATA:
-                {
-                    sampleData = (int16 *)GetChunkData(iter);
-                    sampleDataSize = GetChunkDataSize(iter);
-                } break;
-
-                case WAVE_ID_RIFF:
+            case WAVE_ID_FMT:
+            {   // NOTE(Joey): only the fields up to WBitsPerSample are required for PCM
+                WAVEFormat *fmt = (WAVEFormat*)GetChunkData(iter);
+                if(chunkSize < 16 ||
+                   fmt->WFormatTag != 1 || // NOTE(Joey): only support PCM WAV files
+                   fmt->NSamplesPerSec != 48000 ||
+                   fmt->WBitsPerSample != 16 ||
+                   (fmt->NChannels != 1 && fmt->NChannels != 2) ||
+                   fmt->NBlockAlign != (sizeof(int16)*fmt->NChannels))
                 {
-                    int x = 5;
-                    break;
+                    return(result);
                 }
-                case WAVE_ID_WAVE:
-                {
-                    int x = 5;
-                    break;
-                }
-            }
-        }
+                channelCount = fmt->NChannels;
+            } break;
 
-        Assert(channelCount && sampleData);
+            case WAVE_ID_DATA:
+            {
+                sampleData = (int16 *)GetChunkData(iter);
+                sampleDataSize = chunkSize;
+            } break;
+        }
+    }
 
+    if(channelCount && sampleData)
+    {
         result.ChannelCount = channelCount;
         result.SampleCount = sampleDataSize / (channelCount*sizeof(int16));
-        if(channelCount == 1)
-        {
-            result.Samples[0] = sampleData;
-            result.Samples[1] = 0;
-        }
-        else if(channelCount == 2)
-        {
-            result.Samples[0] = sampleData;
-            result.Samples[1] = sampleData + result.SampleCount;
-            
-            for(uint32 sampleIndex = 0;
-                sampleIndex < result.SampleCount;
-                ++sampleIndex)
-            {
-                // TODO(Joey): work on proper 2-channel support
-                int16 source = sampleData[2*sampleIndex];
-                sampleData[2*sampleIndex] = sampleData[sampleIndex];
-                sampleData[sampleIndex] = source;
-            }
-        }
-        else
-        {
-            Assert(!"Invalid channel count in WAV file");
-        }
-        // NOTE(Joey): enforce 1 channel support for now
-        result.ChannelCount = 1;
+        result.Interleaved = sampleData;
     }
+    return(result);
+}
 
-    return(result);    
-}
\ No newline at end of file
+// NOTE(Joey): size of the samples DecodeWAV writes
+inline memory_index GetDecodedWAVSize(wav_samples *samples)
+{
+    return (memory_index)samples->SampleCount*sizeof(int16);
+}
+
+/* NOTE(Joey):
+
+  De-interleaves the first channel of the samples into dest, which may be the
+  samples' own memory (each sample is written at or before where it's read). 
+  The mixer only plays the first channel for now, so that's all that's kept.
+  
+*/
+internal Sound DecodeWAV(wav_samples *samples, int16 *dest)
+{
+    Sound result = {};
+    
+    // TODO(Joey): work on proper 2-channel support
+    int16 *source = samples->Interleaved;
+    for(uint32 sampleIndex = 0; sampleIndex < samples->SampleCount; ++sampleIndex)
+        dest[sampleIndex] = source[sampleIndex*samples->ChannelCount];
+    
+    // NOTE(Joey): enforce 1 channel support for now
+    result.ChannelCount = 1;
+    result.SampleCount = samples->SampleCount;
+    result.Samples[0] = dest;
+    result.Samples[1] = 0;
+    return(result);
+}
@@ -47,4 +47,12 @@ struct WAVEFormat
     uint32 DwChannelMask;
     uint8  SubFormat[16];    
 };
-#pragma pack(pop)
\ No newline at end of file
+#pragma pack(pop)
+
+// NOTE(Joey): where a .WAV's interleaved samples are in the file's contents; see ParseWAV
+struct wav_samples
+{
+    uint32 ChannelCount;
+    uint32 SampleCount; // NOTE(Joey): per channel
+    int16 *Interleaved;
+};
\ No newline at end of file
@@ -16,6 +16,9 @@ cl %CommonCompilerFlags% W:\code\voidt.cpp -LD /link -incremental:no -PDB:voidt_
 del lock.tmp
 cl %CommonCompilerFlags% W:\code\win32_voidt.cpp /link %CommonLinkerFlags%
 
+REM asset packer; run from the data directory: asset_packer W:\code\tools\voidt_assets.txt assets.vpak
+cl %CommonCompilerFlags% -D_CRT_SECURE_NO_WARNINGS W:\code\tools\asset_packer.cpp /link -incremental:no -opt:ref
+
 popd
 
 :: note when building for devices like windows xp with -subsystem:windows5.1 ; if you're building x64 machine code this should be windows,5.02 instead of 5.1
\ No newline at end of file
@@ -18,185 +18,679 @@ inline bool32 StringCompare(char *a, char *b)
     return strcmp(a, b) == 0;
 }
 
-struct LoadAssetData 
+/* NOTE(Joey):
+
+  Maps the asset pack (see vpak.h). Assets found in it are never loaded: 
+  interning one points it straight at its data in the mapping, which stays
+  mapped for the lifetime of the GameAssets. The OS pages their data in on
+  first use and it doesn't count against the asset memory budget. Assets 
+  that aren't in the pack still load from their own files.
+  
+  Call before any asset is requested.
+
+*/
+internal bool32 OpenAssetPack(GameAssets *assets, char *fileName)
 {
-    GameAssets *Assets;
-    char *FileName;
-};
+    Assert(assets->AssetCount == 0 && !assets->Pack);
+    platform_mapped_file *pack = PlatformAPI.MapFile(fileName);
+    if(!pack)
+        return false;
+    
+    vpak_header *header = (vpak_header*)pack->Memory;
+    bool32 valid = !pack->HasErrors && pack->Size >= sizeof(vpak_header) &&
+                   header->Magic == VPAK_MAGIC && header->Version == VPAK_VERSION &&
+                   IsPackRangeValid(header->EntriesOffset, (u64)header->EntryCount*sizeof(vpak_entry), pack->Size) &&
+                   IsPackRangeValid(header->NamesOffset, header->NamesSize, pack->Size) &&
+                   header->NamesSize > 0 && ((char*)pack->Memory)[header->NamesOffset + header->NamesSize - 1] == 0;
+    if(!valid)
+    {
+        PlatformAPI.UnmapFile(pack);
+        return false;
+    }
+    
+    assets->Pack           = pack;
+    assets->PackEntries    = (vpak_entry*)((u8*)pack->Memory + header->EntriesOffset);
+    assets->PackEntryCount = header->EntryCount;
+    assets->PackNames      = (char*)pack->Memory + header->NamesOffset;
+    assets->PackNamesSize  = header->NamesSize;
+    return true;
+}
 
-void DoBackgroundTextureLoadWork(platform_work_queue *queue, void* data)
+internal vpak_entry* FindPackEntry(GameAssets *assets, char *name, u32 hash)
 {
-    LoadAssetData *assetData = (LoadAssetData*)data;
+    // NOTE(Joey): lower bound of the hash; then compare the names of all entries w/ that hash
+    u32 first = 0;
+    u32 count = assets->PackEntryCount;
+    while(count > 0)
+    {
+        u32 step = count / 2;
+        if(assets->PackEntries[first + step].NameHash < hash)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+            count = step;
+    }
+    for(u32 i = first; i < assets->PackEntryCount && assets->PackEntries[i].NameHash == hash; ++i)
+    {
+        vpak_entry *entry = assets->PackEntries + i;
+        // NOTE(Joey): the names are zero terminated as a whole (see OpenAssetPack)
+        if(entry->NameOffset < assets->PackNamesSize && StringCompare(assets->PackNames + entry->NameOffset, name))
+            return entry;
+    }
+    return 0;
+}
+
+// NOTE(Joey): an entry that doesn't fit the pack, or is misaligned, is ignored s.t. the asset loads 
+// from its own file instead
+internal bool32 MapPackedAsset(GameAssets *assets, Asset *asset, u16 type)
+{
+    u16 entryType = type == ASSET_TYPE_TEXTURE ? VPAK_ENTRY_TEXTURE : VPAK_ENTRY_SOUND;
+    vpak_entry *entry = FindPackEntry(assets, asset->Name, asset->NameHash);
+    if(!entry || entry->Type != entryType || entry->DataOffset % VPAK_ALIGNMENT != 0 ||
+       !IsPackRangeValid(entry->DataOffset, entry->DataSize, assets->Pack->Size))
+        return false;
     
-    uint32 currTexturePos = assetData->Assets->LoadedTextureCount;
-    uint32 nextTexturePos = _InterlockedCompareExchange((volatile long*)&assetData->Assets->LoadedTextureCount,
-                                                currTexturePos + 1, 
-                                                currTexturePos);
-    if(nextTexturePos == currTexturePos)
-    {
-        Texture texture = LoadTexture(PlatformAPI.DEBUGReadEntireFile, assetData->FileName);
-                
-        LoadedTexture loaded;
-        loaded.Asset = texture;
-        loaded.Name = assetData->FileName;
+    u8 *data = (u8*)assets->Pack->Memory + entry->DataOffset;
+    if(type == ASSET_TYPE_TEXTURE)
+    {
+        texture_format format = (texture_format)entry->Format;
+        if(entry->Format > TEXTURE_FORMAT_BLOCK4X4 || 
+           entry->Width == 0 || entry->Height == 0 ||
+           entry->DataSize < GetTextureDataSize(entry->Width, entry->Height, format))
+            return false;
+        if(entry->SpansOffset && (entry->Width < 2 || entry->Height < 2 || entry->SpansOffset % sizeof(u32) != 0 ||
+           !IsPackRangeValid(entry->SpansOffset, GetPackedTextureSpansSize(entry->Width, entry->Height, entry->SpanCount),
+                             assets->Pack->Size)))
+            return false;
         
-        assetData->Assets->Textures[nextTexturePos] = loaded;
-    }       
+        Texture *texture = &asset->TextureAsset;
+        *texture = {};
+        texture->Width  = entry->Width;
+        texture->Height = entry->Height;
+        texture->Texels = (uint32*)data;
+        texture->Pitch  = GetTexturePitch(entry->Width, format);
+        texture->Format = format;
+        if(format == TEXTURE_FORMAT_PALETTE8)
+            texture->Palette = (uint32*)(data + GetTexturePaletteOffset(entry->Width, entry->Height));
+        if(entry->SpansOffset)
+        {
+            MapPackedTextureSpans(&asset->PackedSpans, entry->Width, entry->Height, entry->SpanCount,
+                                  (u8*)assets->Pack->Memory + entry->SpansOffset);
+            texture->Spans = &asset->PackedSpans;
+        }
+        asset->Format = format;
+        _InterlockedIncrement((volatile long*)&assets->LoadedTextureCount);
+    }
+    else
+    {
+        if(entry->DataSize < (u64)entry->SampleCount*sizeof(int16))
+            return false;
+        asset->SoundAsset = {};
+        asset->SoundAsset.ChannelCount = 1;
+        asset->SoundAsset.SampleCount  = entry->SampleCount;
+        asset->SoundAsset.Samples[0]   = (int16*)data;
+        _InterlockedIncrement((volatile long*)&assets->LoadedSoundCount);
+    }
+    asset->Prepared = true;
+    asset->Flags = type | ASSET_STATE_LOADED;
+    return true;
 }
 
-void DoBackgroundSoundLoadWork(platform_work_queue *queue, void* data)
+/* NOTE(Joey):
+
+  Fonts in the pack are baked already (see vpak_font): their metrics and
+  glyph texels stay in the mapping, only the glyph textures are pushed on
+  the asset arena. Returns 0 if the font isn't in the pack.
+
+*/
+internal game_font* GetPackedFont(GameAssets *assets, char *name)
 {
-    LoadAssetData *assetData = (LoadAssetData*)data;
-     
-    uint32 currSoundPos = assetData->Assets->LoadedSoundCount;
-    uint32 nextSoundPos = _InterlockedCompareExchange((volatile long*)&assetData->Assets->LoadedSoundCount,
-                                                currSoundPos + 1, 
-                                                currSoundPos);
-    if(nextSoundPos == currSoundPos)
+    if(!assets->Pack)
+        return 0;
+    vpak_entry *entry = FindPackEntry(assets, name, HashAssetName(name));
+    if(!entry || entry->Type != VPAK_ENTRY_FONT || entry->DataSize < sizeof(vpak_font) ||
+       entry->DataOffset % VPAK_ALIGNMENT != 0 ||
+       !IsPackRangeValid(entry->DataOffset, entry->DataSize, assets->Pack->Size))
+        return 0;
+    
+    u8 *data = (u8*)assets->Pack->Memory + entry->DataOffset;
+    vpak_font *packed = (vpak_font*)data;
+    u32 count = packed->CodePointCount;
+    u64 glyphsOffset = sizeof(vpak_font) + (u64)count*(sizeof(vector2D) + sizeof(r32));
+    if(!IsPackRangeValid(glyphsOffset, (u64)count*sizeof(vpak_glyph), entry->DataSize))
+        return 0;
+    vpak_glyph *glyphs = (vpak_glyph*)(data + glyphsOffset);
+    for(u32 i = 0; i < count; ++i)
     {
-        Sound sound = LoadWAV(PlatformAPI.DEBUGReadEntireFile, assetData->FileName);
-        
-        LoadedSound loaded;
-        loaded.Asset = sound;
-        loaded.Name = assetData->FileName;
-        
-        assetData->Assets->Sounds[nextSoundPos] = loaded;
+        if(glyphs[i].TexelsOffset % sizeof(uint32) != 0 ||
+           !IsPackRangeValid(glyphs[i].TexelsOffset, (u64)glyphs[i].Width*glyphs[i].Height*sizeof(uint32), entry->DataSize))
+            return 0;
     }
+    
+    game_font *font = PushStruct(assets->Arena, game_font);
+    ZeroSize(font, sizeof(game_font));
+    font->IsSDF          = true;
+    font->BakeHeight     = packed->BakeHeight;
+    font->SDFSpread      = packed->SDFSpread;
+    font->LineAdvance    = packed->LineAdvance;
+    font->SpaceAdvance   = packed->SpaceAdvance;
+    font->Ascent         = packed->Ascent;
+    font->Descent        = packed->Descent;
+    font->CodePointCount = count;
+    font->GlyphOffsets   = (vector2D*)(packed + 1);
+    font->GlyphAdvances  = (r32*)(font->GlyphOffsets + count);
+    font->CodePoints     = PushArray(assets->Arena, count, Texture);
+    for(u32 i = 0; i < count; ++i)
+    {
+        Texture *glyph = font->CodePoints + i;
+        *glyph = {};
+        glyph->Width  = glyphs[i].Width;
+        glyph->Height = glyphs[i].Height;
+        glyph->Texels = (uint32*)(data + glyphs[i].TexelsOffset);
+        glyph->Pitch  = glyphs[i].Width*sizeof(uint32);
+        glyph->Format = TEXTURE_FORMAT_ARGB32;
+    }
+    return font;
 }
 
-internal Texture* GetTexture(GameAssets *assets, char *name, bool forceLoad = false)
+/* NOTE(Joey):
+
+  Interns an asset name into its asset_id; the first request of a name 
+  creates its (unloaded) asset. IDs stay valid for the lifetime of the 
+  GameAssets s.t. game code can look them up once and keep them, after 
+  which getting an asset is a plain array index.
+  
+  Only called from the main thread; background loads refer to assets by ID.
+
+*/
+internal asset_id GetAssetID(GameAssets *assets, char *name, u16 type)
 {
-    TIMING_BLOCK();
-    Texture *texture = 0;
-    for(uint32 i = 0; i < assets->LoadedTextureCount; ++i)
+    u32 hash = HashAssetName(name);
+    for(u32 probe = 0; probe < ASSET_NAME_TABLE_SIZE; ++probe)
     {
-        LoadedTexture *asset = assets->Textures + i;
-        if(asset->Asset.Texels)
+        asset_name_slot *slot = assets->NameTable + ((hash + probe) & (ASSET_NAME_TABLE_SIZE - 1));
+        if(slot->ID == 0)
         {
-            if(StringCompare(asset->Name, name))
-            {
-                texture = &asset->Asset;
-                break;
-            }
+            Assert(assets->AssetCount + 1 < MAX_ASSETS);
+            asset_id id = ++assets->AssetCount;
+            Asset *asset = assets->Assets + id;
+            asset->Name     = PushString(assets->Arena, name);
+            asset->NameHash = hash;
+            asset->Flags    = type | ASSET_STATE_UNLOADED;
+            asset->Format   = TEXTURE_FORMAT_ARGB32;
+            asset->Prepared = false;
+            if(assets->Pack)
+                MapPackedAsset(assets, asset, type);
+            
+            slot->NameHash = hash;
+            slot->ID       = id;
+            return id;
+        }
+        if(slot->NameHash == hash && StringCompare(assets->Assets[slot->ID].Name, name))
+        {
+            Assert((assets->Assets[slot->ID].Flags & ASSET_TYPE_MASK) == type);
+            return slot->ID;
         }
     }
+    InvalidCodePath;
+    return 0;
+}
+
+// NOTE(Joey): format is only used by the request that interns the texture; packed textures keep the pack's format
+inline asset_id GetTextureID(GameAssets *assets, char *name, texture_format format = TEXTURE_FORMAT_ARGB32)
+{
+    u32 assetCount = assets->AssetCount;
+    asset_id id = GetAssetID(assets, name, ASSET_TYPE_TEXTURE);
+    if(assets->AssetCount != assetCount && !assets->Assets[id].Prepared)
+        assets->Assets[id].Format = format;
+    return id;
+}
+
+inline asset_id GetSoundID(GameAssets *assets, char *name)
+{
+    return GetAssetID(assets, name, ASSET_TYPE_SOUND);
+}
+
+inline u32 GetAssetState(Asset *asset)
+{
+    return asset->Flags & ASSET_STATE_MASK;
+}
+
+// NOTE(Joey): returns false if the asset wasn't in state 'from' (anymore); see Asset for the valid transitions
+inline bool32 TransitionAssetState(Asset *asset, u32 from, u32 to)
+{
+    u32 type = asset->Flags & ASSET_TYPE_MASK;
+    u32 previous = _InterlockedCompareExchange((volatile long*)&asset->Flags, type | to, type | from);
+    return previous == (type | from);
+}
+
+// NOTE(Joey): guards the allocator; held only for the allocation itself, never while evicting
+inline void BeginAssetMemoryLock(GameAssets *assets)
+{
+    while(_InterlockedCompareExchange((volatile long*)&assets->MemoryLock, 1, 0) != 0)
+        _mm_pause();
+}
+
+inline void EndAssetMemoryLock(GameAssets *assets)
+{
+    _InterlockedExchange((volatile long*)&assets->MemoryLock, 0);
+}
+
+internal void ReleaseAssetMemory(GameAssets *assets, memory_block *block)
+{
+    BeginAssetMemoryLock(assets);
+    assets->MemoryInUse -= block->Size;
+    FreeGeneralMemory(assets->Memory, block);
+    EndAssetMemoryLock(assets);
+}
+
+internal void ShrinkAssetMemory(GameAssets *assets, memory_block *block, memory_index size)
+{
+    BeginAssetMemoryLock(assets);
+    assets->MemoryInUse -= block->Size;
+    ShrinkGeneralMemory(assets->Memory, block, size);
+    assets->MemoryInUse += block->Size;
+    EndAssetMemoryLock(assets);
+}
+
+inline bool32 IsAssetEvictable(GameAssets *assets, Asset *asset)
+{
+    // NOTE(Joey): assets requested this frame may still be referenced by the frame's render queue
+    return GetAssetState(asset) == ASSET_STATE_LOADED && asset->Memory && 
+           asset->ReferenceCount == 0 && asset->LastUsedFrame != assets->FrameIndex;
+}
+
+// NOTE(Joey): main thread only; returns false if there's no asset left that can be evicted
+internal bool32 EvictLeastRecentlyUsedAsset(GameAssets *assets)
+{
+    Asset *victim = 0;
+    for(asset_id id = 1; id <= assets->AssetCount; ++id)
+    {
+        Asset *asset = assets->Assets + id;
+        if(IsAssetEvictable(assets, asset) && (!victim || asset->LastUsedFrame < victim->LastUsedFrame))
+            victim = asset;
+    }
     
-    // NOTE(Joey): if texture wasn't found, set up background worker to load texture
-    if(!texture)
-    {           
-        if(forceLoad)
-        {   // load right now, don't wait for background thread
-    
-            Texture texturez = LoadTexture(PlatformAPI.DEBUGReadEntireFile, name);
-            assets->Textures[assets->LoadedTextureCount].Asset = texturez;
-            assets->Textures[assets->LoadedTextureCount].Name = PushString(assets->Arena, name);
-            texture = &assets->Textures[assets->LoadedTextureCount].Asset;
-            _InterlockedIncrement((volatile long*)&assets->LoadedTextureCount);
+    if(victim)
+    {
+        ReleaseAssetMemory(assets, victim->Memory);
+        if(victim->SpanMemory)
+            ReleaseAssetMemory(assets, victim->SpanMemory);
+        victim->Memory = 0;
+        victim->SpanMemory = 0;
+        victim->DataMemorySize = 0;
+        victim->Prepared = false;
+        if((victim->Flags & ASSET_TYPE_MASK) == ASSET_TYPE_TEXTURE)
+        {
+            victim->TextureAsset = {};
+            _InterlockedDecrement((volatile long*)&assets->LoadedTextureCount);
         }
         else
         {
-            LoadAssetData *data = PushStruct(assets->Arena, LoadAssetData);
-            data->Assets = assets;
-            data->FileName = PushString(assets->Arena, name);
-            
-            // TODO(Joey): make sure to de-allocate memory once task is done (see task_with_memory)
-            PlatformAPI.AddWorkEntry(PlatformAPI.WorkQueueLowPriority, DoBackgroundTextureLoadWork, data);
+            victim->SoundAsset = {};
+            _InterlockedDecrement((volatile long*)&assets->LoadedSoundCount);
         }
+        ++victim->Generation;
+        TransitionAssetState(victim, ASSET_STATE_LOADED, ASSET_STATE_UNLOADED);
+        ++assets->EvictionCount;
+    }
+    return victim != 0;
+}
+
+/* NOTE(Joey):
+
+  Allocates asset memory within the MemoryMax budget. Loads on the main thread
+  (mayEvict) make room by evicting the least recently used assets until the 
+  allocation fits; loads on worker threads never evict, as eviction needs to 
+  know no one is using the asset, and simply fail. Returns 0 on failure.
+
+*/
+internal memory_block* AcquireAssetMemory(GameAssets *assets, memory_index size, bool32 mayEvict)
+{
+    memory_block *block = 0;
+    for(;;)
+    {
+        BeginAssetMemoryLock(assets);
+        if(assets->MemoryInUse + size <= assets->MemoryMax)
+            block = GetGeneralMemory(assets->Memory, size);
+        if(block)
+            assets->MemoryInUse += block->Size;
+        EndAssetMemoryLock(assets);
+        
+        if(block || !mayEvict || !EvictLeastRecentlyUsedAsset(assets))
+            break;
+    }
+    return block;
+}
 
+/* NOTE(Joey):
 
+  Reads the asset's file into a staging block of asset memory. Loads decode it
+  into a block sized to just the final data and release the staging block right
+  after, s.t. file headers (and the sound channels that aren't played) don't 
+  stay resident and all asset data is within the budget. Returns 0 if the file
+  is missing (see missing) or there's no memory for it.
 
-     
+*/
+internal memory_block* ReadAssetFile(GameAssets *assets, 
+                                     char *name, 
+                                     bool32 mayEvict, 
+                                     memory_index *fileSize, 
+                                     bool32 *missing)
+{
+    memory_block *block = 0;
+    platform_file_handle *file = PlatformAPI.OpenFile(name);
+    *missing = !file || file->HasErrors || file->Size == 0;
+    *fileSize = 0;
+    if(!*missing)
+    {
+        *fileSize = (memory_index)file->Size;
+        block = AcquireAssetMemory(assets, *fileSize, mayEvict);
+        if(block)
+        {
+            PlatformAPI.ReadFile(file, 0, file->Size, block->Memory);
+            if(file->HasErrors)
+            {
+                ReleaseAssetMemory(assets, block);
+                block = 0;
+                *missing = true;
+            }
+        }
+    }
+    if(file)
+        PlatformAPI.CloseFile(file);
+    return block;
+}
+
+// NOTE(Joey): span tables and compression are left to the first GetTexture on the main thread
+internal void LoadTextureAsset(GameAssets *assets, Asset *asset, bool32 mayEvict)
+{
+    bool32 missing;
+    memory_index fileSize;
+    memory_block *block = 0;
+    memory_block *staging = ReadAssetFile(assets, asset->Name, mayEvict, &fileSize, &missing);
+    if(staging)
+    {
+        // NOTE(Joey): a file that can't be decoded is treated like a missing one
+        bitmap_header *header = (bitmap_header*)staging->Memory;
+        missing = fileSize < sizeof(bitmap_header) || !IsSupportedBitmap(header) || 
+                  header->BitmapOffset + GetDecodedBitmapSize(header) > fileSize;
+        if(!missing)
+        {
+            block = AcquireAssetMemory(assets, GetDecodedBitmapSize(header), mayEvict);
+            if(block)
+                asset->TextureAsset = DecodeBitmap(header, (uint32*)block->Memory);
+        }
+        ReleaseAssetMemory(assets, staging);
     }
     
-    return texture;
-}    
+    if(block || missing)
+    {
+        if(!block)
+            asset->TextureAsset = {};
+        asset->Memory = block;
+        asset->DataMemorySize = block ? (u32)block->Size : 0;
+        asset->Prepared = false;
+        // NOTE(Joey): the main thread may only see the asset as loaded once its data is written
+        _WriteBarrier();
+        TransitionAssetState(asset, ASSET_STATE_LOCKED, ASSET_STATE_LOADED);
+        _InterlockedIncrement((volatile long*)&assets->LoadedTextureCount);
+    }
+    else
+    {   // NOTE(Joey): out of budget; a later request retries once eviction made room
+        TransitionAssetState(asset, ASSET_STATE_LOCKED, ASSET_STATE_UNLOADED);
+    }
+}
 
-internal Sound* GetSound(GameAssets *assets, char *name, bool forceLoad = false)
+internal void LoadSoundAsset(GameAssets *assets, Asset *asset, bool32 mayEvict)
+{
+    bool32 missing;
+    memory_index fileSize;
+    memory_block *block = 0;
+    memory_block *staging = ReadAssetFile(assets, asset->Name, mayEvict, &fileSize, &missing);
+    if(staging)
+    {
+        // NOTE(Joey): malformed or unsupported files are treated as missing
+        wav_samples samples = ParseWAV(staging->Memory, fileSize);
+        missing = samples.ChannelCount == 0;
+        if(!missing)
+        {
+            block = AcquireAssetMemory(assets, GetDecodedWAVSize(&samples), mayEvict);
+            if(block)
+                asset->SoundAsset = DecodeWAV(&samples, (int16*)block->Memory);
+        }
+        ReleaseAssetMemory(assets, staging);
+    }
+    
+    if(block || missing)
+    {
+        if(!block)
+            asset->SoundAsset = {};
+        asset->Memory = block;
+        asset->DataMemorySize = block ? (u32)block->Size : 0;
+        _WriteBarrier();
+        TransitionAssetState(asset, ASSET_STATE_LOCKED, ASSET_STATE_LOADED);
+        _InterlockedIncrement((volatile long*)&assets->LoadedSoundCount);
+    }
+    else
+    {
+        TransitionAssetState(asset, ASSET_STATE_LOCKED, ASSET_STATE_UNLOADED);
+    }
+}
+
+void DoBackgroundTextureLoadWork(platform_work_queue *queue, void* data)
+{
+    LoadAssetData *work = (LoadAssetData*)data;
+    Asset *asset = work->Assets->Assets + work->ID;
+    // NOTE(Joey): a forced load on the main thread may have taken the asset from the queue already
+    if(TransitionAssetState(asset, ASSET_STATE_QUEUED, ASSET_STATE_LOCKED))
+        LoadTextureAsset(work->Assets, asset, false);
+}
+
+void DoBackgroundSoundLoadWork(platform_work_queue *queue, void* data)
+{
+    LoadAssetData *work = (LoadAssetData*)data;
+    Asset *asset = work->Assets->Assets + work->ID;
+    if(TransitionAssetState(asset, ASSET_STATE_QUEUED, ASSET_STATE_LOCKED))
+        LoadSoundAsset(work->Assets, asset, false);
+}
+
+// NOTE(Joey): only the request that moves the asset from UNLOADED to QUEUED adds the work entry
+internal void QueueAssetLoad(GameAssets *assets, asset_id id, platform_work_queue_func *loadWork)
+{
+    if(TransitionAssetState(assets->Assets + id, ASSET_STATE_UNLOADED, ASSET_STATE_QUEUED))
+    {
+        LoadAssetData *work = assets->LoadWork + id;
+        work->Assets = assets;
+        work->ID = id;
+        PlatformAPI.AddWorkEntry(PlatformAPI.WorkQueueLowPriority, loadWork, work);
+    }
+}
+
+// NOTE(Joey): takes the asset before a worker does; if a worker is loading it already, waits for it.
+// A worker that ran out of memory leaves it unloaded, in which case it's taken after all.
+internal bool32 LockAssetForLoad(Asset *asset)
+{
+    for(;;)
+    {
+        if(TransitionAssetState(asset, ASSET_STATE_UNLOADED, ASSET_STATE_LOCKED) || 
+           TransitionAssetState(asset, ASSET_STATE_QUEUED, ASSET_STATE_LOCKED))
+            return true;
+        if(GetAssetState(asset) == ASSET_STATE_LOADED)
+            return false;
+        _mm_pause();
+    }
+}
+
+internal Texture* GetTexture(GameAssets *assets, asset_id id, bool forceLoad = false)
 {
     TIMING_BLOCK();
-    Sound *sound = 0;
-    for(uint32 i = 0; i < assets->LoadedSoundCount; ++i)
+    Asset *asset = assets->Assets + id;
+    Assert(id > 0 && id <= assets->AssetCount && (asset->Flags & ASSET_TYPE_MASK) == ASSET_TYPE_TEXTURE);
+    
+    if(GetAssetState(asset) != ASSET_STATE_LOADED)
+    {
+        if(forceLoad)
+        {   // load right now, don't wait for background thread
+            if(LockAssetForLoad(asset))
+                LoadTextureAsset(assets, asset, true);
+            if(GetAssetState(asset) != ASSET_STATE_LOADED)
+                return 0;
+        }
+        else
+        {   // NOTE(Joey): if texture wasn't loaded yet, set up background worker to load texture
+            QueueAssetLoad(assets, id, DoBackgroundTextureLoadWork);
+            return 0;
+        }
+    }
+    asset->LastUsedFrame = assets->FrameIndex;
+    
+    // NOTE(Joey): a file that failed to load stays loaded (w/o texels) s.t. it isn't requested again
+    Texture *texture = 0;
+    if(asset->TextureAsset.Texels)
     {
-        LoadedSound *asset = assets->Sounds + i;
-        if(asset->Asset.SampleCount > 0)
+        // NOTE(Joey): background loads can't evict, so the span table of those is allocated 
+        // here, on the main thread, the first time it's requested. Spans are built from the 
+        // ARGB texels, so before the texture is compressed. W/o memory it goes w/o spans.
+        if(!asset->Prepared)
         {
-            if(StringCompare(asset->Name, name))
+            memory_index spansSize = GetTextureSpansSize(&asset->TextureAsset);
+            if(spansSize)
+                asset->SpanMemory = AcquireAssetMemory(assets, spansSize, true);
+            if(asset->SpanMemory)
             {
-                sound = &asset->Asset;
-                break;
+                memory_arena spanArena;
+                InitializeArena(&spanArena, asset->SpanMemory->Size, asset->SpanMemory->Memory);
+                BuildTextureSpans(&asset->TextureAsset, &spanArena);
+                asset->DataMemorySize += (u32)asset->SpanMemory->Size;
             }
+            // NOTE(Joey): compressed texels take up the start of the ARGB block; the rest is given back
+            Texture *compressed = &asset->TextureAsset;
+            if(CompressTexture(compressed, asset->Format, assets->Arena) && compressed->Format != TEXTURE_FORMAT_ARGB32)
+            {
+                asset->DataMemorySize -= (u32)asset->Memory->Size;
+                ShrinkAssetMemory(assets, asset->Memory, GetTextureDataSize(compressed->Width, compressed->Height, compressed->Format));
+                asset->DataMemorySize += (u32)asset->Memory->Size;
+            }
+            asset->Prepared = true;
         }
+        texture = &asset->TextureAsset;
     }
+    return texture;
+}    
+
+internal Texture* GetTexture(GameAssets *assets, 
+                             char *name, 
+                             bool forceLoad = false, 
+                             texture_format format = TEXTURE_FORMAT_ARGB32)
+{
+    return GetTexture(assets, GetTextureID(assets, name, format), forceLoad);
+}
+
+internal Sound* GetSound(GameAssets *assets, asset_id id, bool forceLoad = false)
+{
+    TIMING_BLOCK();
+    Asset *asset = assets->Assets + id;
+    Assert(id > 0 && id <= assets->AssetCount && (asset->Flags & ASSET_TYPE_MASK) == ASSET_TYPE_SOUND);
     
-    // NOTE(Joey): if texture wasn't found, set up background worker to load texture
-    if(!sound)
-    {              
+    if(GetAssetState(asset) != ASSET_STATE_LOADED)
+    {
         if(forceLoad)
         {   // load right now, don't wait for background thread
-            Sound soundz = LoadWAV(PlatformAPI.DEBUGReadEntireFile, name);
-            assets->Sounds[assets->LoadedSoundCount].Asset = soundz;
-            assets->Sounds[assets->LoadedSoundCount].Name = PushString(assets->Arena, name);
-            // TODO(Joey): make PushString and store const char* memory in arena (as memory addresses
-            // of the strings get invalidated while hot-loading DLL.            
-            sound = &assets->Sounds[assets->LoadedSoundCount].Asset;
-            _InterlockedIncrement((volatile long*)&assets->LoadedSoundCount);
+            if(LockAssetForLoad(asset))
+                LoadSoundAsset(assets, asset, true);
+            if(GetAssetState(asset) != ASSET_STATE_LOADED)
+                return 0;
         }
         else
         {
-            LoadAssetData *data = PushStruct(assets->Arena, LoadAssetData);
-            data->Assets = assets;
-            data->FileName = PushString(assets->Arena, name);
-            
-            PlatformAPI.AddWorkEntry(PlatformAPI.WorkQueueLowPriority, DoBackgroundSoundLoadWork, data);      
+            QueueAssetLoad(assets, id, DoBackgroundSoundLoadWork);
+            return 0;
         }
     }
-    
-    return sound;
+    asset->LastUsedFrame = assets->FrameIndex;
+    return asset->SoundAsset.SampleCount > 0 ? &asset->SoundAsset : 0;
 }  
 
-internal void PreFetchTexture(GameAssets *assets, char *name, bool forceLoad = false)
+internal Sound* GetSound(GameAssets *assets, char *name, bool forceLoad = false)
+{
+    return GetSound(assets, GetSoundID(assets, name), forceLoad);
+}
+
+// NOTE(Joey): the sound's asset isn't evicted for as long as it plays; 0 if it isn't loaded (yet)
+internal PlayingSound* PlaySound(SoundMixer *mixer, 
+                                 GameAssets *assets, 
+                                 asset_id id, 
+                                 real32 volume = 1.0f, 
+                                 real32 pitch = 1.0f, 
+                                 bool32 loop = false)
 {
-    GetTexture(assets, name, forceLoad);
+    PlayingSound *result = 0;
+    Sound *sound = GetSound(assets, id);
+    if(sound)
+        result = PlaySound(mixer, sound, volume, pitch, loop, &assets->Assets[id].ReferenceCount);
+    return result;
 }
 
-internal void PreFetchSound(GameAssets *assets, char *name, bool forceLoad = false)
+// NOTE(Joey): cached sprites of the texture are keyed by its asset ID and generation; the asset isn't evicted while
+// one is built. Nothing is drawn if it isn't loaded (yet).
+internal void PushTextureCached(RenderQueue *queue,
+                                sprite_cache *cache,
+                                GameAssets *assets,
+                                asset_id id,
+                                vector2D position,
+                                uint32 depth,
+                                vector2D size,
+                                vector2D basisX,
+                                vector2D basisY,
+                                vector4D color)
 {
-    GetSound(assets, name, forceLoad);
+    Texture *texture = GetTexture(assets, id);
+    Asset *asset = assets->Assets + id;
+    if(texture && !PushCachedSprite_(queue, cache, texture, id, asset->Generation, &asset->ReferenceCount,
+                                     position, depth, size, basisX, basisY, color, 0.0f))
+        PushTexture(queue, texture, position, depth, size, basisX, basisY, color);
 }
 
+// NOTE(Joey): returns the asset's ID s.t. it can be kept for per-frame lookups
+internal asset_id PreFetchTexture(GameAssets *assets, 
+                                  char *name, 
+                                  bool forceLoad = false, 
+                                  texture_format format = TEXTURE_FORMAT_ARGB32)
+{
+    asset_id id = GetTextureID(assets, name, format);
+    GetTexture(assets, id, forceLoad);
+    return id;
+}
+
+internal asset_id PreFetchSound(GameAssets *assets, char *name, bool forceLoad = false)
+{
+    asset_id id = GetSoundID(assets, name);
+    GetSound(assets, id, forceLoad);
+    return id;
+}
+
+/* NOTE(Joey):
+
+  Called once at the end of each frame. If more memory is in use than 
+  MemoryMax - MemorySafetyRegion, the least recently used assets are evicted
+  until it isn't, s.t. there's always some room left for background loads 
+  (which can't evict themselves). Assets requested this frame and assets that
+  are referenced beyond it (ReferenceCount; e.g. playing sounds) are kept.
+  
+  Recency is the frame index of an asset's last request; a linear scan over 
+  the (few) assets for the oldest one is cheaper to maintain than a list that
+  needs updating on each request.
+
+*/
 internal void EvictAssetsAsNecessary(GameAssets *assets)
 {
-    // NOTE(Joey): check if we use more memory than say -16 MB from the max
-    // we use a safety region as a soft cap, s.t. there is always some free 
-    // in case new memory gets loaded in 
     while(assets->MemoryInUse > assets->MemoryMax - assets->MemorySafetyRegion)
     {
-        /* NOTE(Joey):
-        
-          To determine which assets are the least used, since this threshold is reached
-          use reference counting on the assets. Every time an asset gets loaded increase
-          its reference count (32 bit unsigned integer). Then at this stage; sort all
-          assets based on this reference count (ascending) and delete the first on the 
-          list until the size constraint is reached again. 
-          
-          This seems like a more efficient (and easier to maintain) approach than a 
-          doubly linked list.
-          
-          Note, be sure to lock assets when doing background work (with an asset load 
-          type enum: LOADED|LOCKED|QUEUED etc. Then only evict when assets aren't 
-          being used by background threads. Enum of type asset_state.
-          
-          Then once assets have been cleared; clear ALL reference count values to 0.
-          
-          When assets are being loaded by multithreaded workers; set state to queued.
-          
-          Option: instead of keeping a memory buffer and call it once at the end of 
-          each frame; call EvictAssetsAsNecessary in the AcquireAssetMemory step, 
-          that way there is no need for a buffer; but could partially delay the system?
-          Probably wise to check out both options and select the better of them, 
-          evicting memory when requested seems the best API design.
-          
-        */
+        if(!EvictLeastRecentlyUsedAsset(assets))
+            break;
     }
-    
-}
\ No newline at end of file
+    ++assets->FrameIndex;
+}
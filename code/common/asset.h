@@ -18,7 +18,7 @@ enum asset_flags {
     ASSET_TYPE_SOUND   = 0x0001,
     ASSET_TYPE_TEXTURE = 0x0002,
     
-    // asset state
+    // asset state; see TransitionAssetState
     ASSET_STATE_MASK     = 0xFF00,
     ASSET_STATE_QUEUED   = 0x0100,
     ASSET_STATE_LOCKED   = 0x0200,
@@ -26,33 +26,44 @@ enum asset_flags {
     ASSET_STATE_LOADED   = 0x0800,
 };
 
-struct LoadedTexture
-{
-    Texture Asset;
-    char   *Name;
-};
+// NOTE(Joey): index in GameAssets::Assets; names are interned once into an ID (see GetAssetID)
+typedef u32 asset_id;
 
-struct LoadedSound
-{
-    Sound Asset;
-    char *Name;    
-};
+/* NOTE(Joey):
 
-struct loaded_font
-{
-    game_font Font;
-    char *Name;
-};
+  Asset states only move along these transitions, each done atomically 
+  (compare-exchange) by the thread that owns the transition:
+  
+    UNLOADED -> QUEUED    main thread; the single request that queues its load
+    QUEUED   -> LOCKED    load worker; or a forced load that takes it first
+    UNLOADED -> LOCKED    forced load on the main thread
+    LOCKED   -> LOADED    whoever locked it, once the asset's data is written
+    LOCKED   -> UNLOADED  a load that didn't get memory; a later request retries
+    LOADED   -> UNLOADED  eviction, on the main thread (see EvictAssetsAsNecessary)
+    
+  Requests that find an asset QUEUED or LOCKED get nothing back; the asset
+  is pending and requesting it again later doesn't queue another load.
+  Assets mapped from the asset pack start out LOADED and never leave it.
+
+*/
 
 struct Asset
 {
-    memory_block *Memory;
+    memory_block *Memory;     // NOTE(Joey): blocks of GameAssets::Memory the asset's data lives in
+    memory_block *SpanMemory; // NOTE(Joey): textures' span table
     
     char *Name;
-    u32   ReferenceCount;
+    u32   NameHash;
+    u32   LastUsedFrame;           // NOTE(Joey): GameAssets::FrameIndex of the last request
+    volatile u32 ReferenceCount;   // NOTE(Joey): holders beyond the current frame (e.g. playing sounds); never evicted while > 0
+    u32   Generation;              // NOTE(Joey): bumped on eviction; tells data derived from a previous load apart (e.g. cached sprites)
     u32   DataMemorySize;
     
-    u16   Flags;
+    volatile u32 Flags; // NOTE(Joey): asset_flags; type | state
+    
+    texture_format Format;   // NOTE(Joey): format the texture is compressed to once loaded
+    bool32         Prepared; // NOTE(Joey): span tables/compression of background loads are done on first use
+    texture_spans  PackedSpans; // NOTE(Joey): of textures mapped from the asset pack; the arrays live in the pack
     
     union
     {
@@ -63,25 +74,53 @@ struct Asset
 };
 
 const int MAX_ASSETS = 256;
+const u32 ASSET_NAME_TABLE_SIZE = 2*MAX_ASSETS; // NOTE(Joey): power of 2; kept at most half full
+
+// NOTE(Joey): open addressed (linear probing); ID 0 marks an empty slot
+struct asset_name_slot
+{
+    u32      NameHash;
+    asset_id ID;
+};
+
+struct GameAssets;
+struct LoadAssetData 
+{
+    GameAssets *Assets;
+    asset_id    ID;
+};
+
 struct GameAssets
 {
     memory_arena *Arena;
-    general_purpose_allocater *Memory;
+    general_purpose_allocater *Memory; // NOTE(Joey): all loaded asset data; see AcquireAssetMemory
     
-    LoadedTexture Textures[MAX_ASSETS];
-    LoadedSound   Sounds[MAX_ASSETS];   
     game_font     Font;
     game_font     DebugFont;
     
-    // TODO(Joey): use unified asset loading system for easy load|eviction
-    // TODO(Joey): transform unified system to hash table
-    Asset         Assets[MAX_ASSETS];
+    // NOTE(Joey): Assets[0] is never used s.t. an asset_id of 0 can mean 'no asset'
+    Asset           Assets[MAX_ASSETS];
+    u32             AssetCount;
+    asset_name_slot NameTable[ASSET_NAME_TABLE_SIZE];
+    LoadAssetData   LoadWork[MAX_ASSETS]; // NOTE(Joey): an asset has at most one load in flight; its work entry's data
+    
+    // NOTE(Joey): assets found in the pack are mapped instead of loaded; see OpenAssetPack
+    platform_mapped_file *Pack;
+    vpak_entry           *PackEntries;
+    u32                   PackEntryCount;
+    char                 *PackNames;
+    u32                   PackNamesSize;
     
+    // NOTE(Joey): once in use memory exceeds MemoryMax - MemorySafetyRegion the least recently used 
+    // assets are evicted at the end of the frame s.t. there's always room left for new loads.
     u64 MemoryInUse;
     u64 MemoryMax;
     u32 MemorySafetyRegion;
+    volatile u32 MemoryLock; // NOTE(Joey): guards Memory and MemoryInUse; loads allocate from worker threads
+    u32 FrameIndex;
+    u32 EvictionCount;
         
-    volatile u32 LoadedTextureCount;
+    volatile u32 LoadedTextureCount; // NOTE(Joey): statistics only; assets are looked up by ID
     volatile u32 LoadedSoundCount;
 };
 
@@ -26,7 +26,7 @@ internal general_purpose_allocater* GenerateGeneralPurposeAllocater(memory_arena
     result->Sentinel.Memory = 0;
     
     // NOTE(Joey): we allocate the entire memory range to the memory sentinel
-    InsertMemoryBlock(&result->Sentinel, size, PushSize_(arena, size));
+    InsertMemoryBlock(&result->Sentinel, size, PushSize_(arena, size, 16));
     
     return result;
 }
@@ -106,33 +106,11 @@ internal b32 MergeMemoryBlocks(general_purpose_allocater *allocator, memory_bloc
 */
 internal memory_block* GetGeneralMemory(general_purpose_allocater *allocator, memory_index size)
 {
+    size = Align16(size);
     memory_block *block = FindBlockWithSize(allocator, size);    
     
-    // memory_block *foundBlock = FindBlockWithSize(allocator, size);    
-    // NOTE(Joey): if there is a block found of given size
-    if(block && size <= block->Size)
-    {
-        block->Flags |= MEMORY_BLOCK_USED;
-        allocator->MemoryUsed += size;
-        
-        block->Memory = (u8*)(block + sizeof(memory_block));
-        
-        memory_index remainingSize = block->Size - size;
-        // NOTE(Joey): if remaining size is above split threshold; split the block
-        if(remainingSize > BLOCK_SPLIT_THRESHOLD)
-        {
-            block->Size -= remainingSize;
-            InsertMemoryBlock(block, remainingSize, (u8*)block->Memory + size);
-        }
-        else
-        {
-            // NOTE(Joey): record unused portion of the memory in a block so 
-            // we can later do a merge on blocks when neighbors are freed.
-        }                
-        
-    }
     // NOTE(Joey): else try and merge unused blocks to make space
-    else
+    if(!block)
     {
         for(memory_block *memoryBlock = allocator->Sentinel.Next;
             memoryBlock != &allocator->Sentinel;
@@ -147,20 +125,36 @@ internal memory_block* GetGeneralMemory(general_purpose_allocater *allocator, me
                 if(memoryBlock->Size >= size)
                 {
                     block = memoryBlock;
-                    block->Flags |= MEMORY_BLOCK_USED;
-                    block->Memory = (u8*)(block + sizeof(memory_block));
-                    
-                    allocator->MemoryUsed += size;
                     break;
                 }
             }
         }        
     }
-    Assert(block); // NOTE(Joey): if block is null pointer we need better de-fragmentation
+    
+    // NOTE(Joey): if there is a block found of given size
+    if(block)
+    {
+        block->Flags |= MEMORY_BLOCK_USED;
+        
+        memory_index remainingSize = block->Size - size;
+        // NOTE(Joey): if remaining size is above split threshold; split the block
+        if(remainingSize > BLOCK_SPLIT_THRESHOLD)
+        {
+            block->Size = size;
+            InsertMemoryBlock(block, remainingSize, (u8*)block->Memory + size);
+        }
+        else
+        {
+            // NOTE(Joey): record unused portion of the memory in a block so 
+            // we can later do a merge on blocks when neighbors are freed.
+        }                
+        allocator->MemoryUsed += block->Size;
+    }
+    // NOTE(Joey): 0 if there's no free range large enough; it's up to the caller to free memory and retry
     return block;
 }
 
-internal void *FreeGeneralMemory(general_purpose_allocater *allocator, memory_block *block)
+internal void FreeGeneralMemory(general_purpose_allocater *allocator, memory_block *block)
 {
     allocator->MemoryUsed -= block->Size;
     block->Flags &= ~MEMORY_BLOCK_USED;    
@@ -170,3 +164,19 @@ internal void *FreeGeneralMemory(general_purpose_allocater *allocator, memory_bl
         block = block->Prev;
     MergeMemoryBlocks(allocator, block, block->Next);
 }
+
+// NOTE(Joey): gives the memory of a used block past size back to the allocator; the block itself stays in place
+internal void ShrinkGeneralMemory(general_purpose_allocater *allocator, memory_block *block, memory_index size)
+{
+    size = Align16(size);
+    Assert((block->Flags & MEMORY_BLOCK_USED) && size <= block->Size);
+    
+    memory_index remainingSize = block->Size - size;
+    if(remainingSize > BLOCK_SPLIT_THRESHOLD)
+    {
+        block->Size = size;
+        allocator->MemoryUsed -= remainingSize;
+        memory_block *remainder = InsertMemoryBlock(block, remainingSize, (u8*)block->Memory + size);
+        MergeMemoryBlocks(allocator, remainder, remainder->Next);
+    }
+}
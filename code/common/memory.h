@@ -132,6 +132,7 @@ struct memory_block
     u64          Flags;
     
     void        *Memory;
+    u64          Padding; // NOTE(Joey): keeps the header 48 bytes s.t. block memory stays 16 byte aligned
 };
 
 struct general_purpose_allocater
@@ -0,0 +1,121 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef VPAK_H
+#define VPAK_H
+
+/* NOTE(Joey):
+
+  .vpak asset archive: the game's assets in a single file, stored in the 
+  layouts the engine uses at runtime s.t. the loader maps the file and points
+  textures and sounds straight at their data; nothing is parsed or copied.
+  
+    vpak_header
+    vpak_entry[EntryCount]   sorted on NameHash
+    names                    zero terminated; tell apart names w/ equal hashes
+    payloads                 each VPAK_ALIGNMENT aligned; span tables 4 byte aligned
+  
+  Texture payloads hold the texels in the entry's texture_format, including
+  the palette of TEXTURE_FORMAT_PALETTE8 (see GetTextureDataSize), followed
+  by the texture's span table if it has one (see GetPackedTextureSpansSize).
+  Sound payloads hold the 16 bit samples of the channel the mixer plays.
+  Font payloads hold pre-baked glyphs; see vpak_font.
+  
+  Unless noted otherwise offsets are from the start of the file. Packs are
+  written by the asset packer (tools/asset_packer.cpp).
+
+*/
+#define VPAK_CODE(a, b, c, d) (((u32)(a) << 0) | ((u32)(b) << 8) | ((u32)(c) << 16) | ((u32)(d) << 24))
+const u32 VPAK_MAGIC     = VPAK_CODE('v', 'p', 'a', 'k');
+const u32 VPAK_VERSION   = 2;
+const u32 VPAK_ALIGNMENT = 64; // NOTE(Joey): cache line; mapped files start page aligned
+
+// NOTE(Joey): FNV-1a; names are hashed the same in the pack and the asset name table (see GetAssetID)
+inline u32 HashAssetName(char *name)
+{
+    u32 hash = 2166136261;
+    for(char *c = name; *c; ++c)
+        hash = (hash ^ (u8)*c)*16777619;
+    return hash;
+}
+
+// NOTE(Joey): whether [offset, offset + size) lies within the pack; written s.t. it can't overflow
+inline bool32 IsPackRangeValid(u64 offset, u64 size, u64 packSize)
+{
+    return offset <= packSize && size <= packSize - offset;
+}
+
+enum vpak_entry_type
+{
+    VPAK_ENTRY_TEXTURE = 1,
+    VPAK_ENTRY_SOUND   = 2,
+    VPAK_ENTRY_FONT    = 3,
+};
+
+#pragma pack(push, 1)
+struct vpak_header
+{
+    u32 Magic;
+    u32 Version;
+    u32 EntryCount;
+    u32 NamesSize;
+    u64 EntriesOffset;
+    u64 NamesOffset;
+};
+
+struct vpak_entry
+{
+    u32 NameHash;    // NOTE(Joey): HashAssetName of the asset's name
+    u32 NameOffset;  // NOTE(Joey): from the start of the names
+    u16 Type;        // NOTE(Joey): vpak_entry_type
+    u16 Format;      // NOTE(Joey): texture_format of texture payloads
+    u16 Width;
+    u16 Height;
+    u32 SampleCount; // NOTE(Joey): of sound payloads
+    u32 SpanCount;   // NOTE(Joey): of the texture's span table
+    u64 DataOffset;
+    u64 DataSize;    // NOTE(Joey): the texels or samples; w/o the span table
+    u64 SpansOffset; // NOTE(Joey): 0 if the texture has no span table
+    u64 SourceHash;  // NOTE(Joey): of the source asset and its packing options; for incremental rebuilds
+};
+
+/* NOTE(Joey):
+
+  Font payloads: the font's glyphs for the code points from '!' onwards, 
+  baked as signed distance fields (see LoadFontGlyphsSDF), laid out as
+  
+    vpak_font
+    r32        GlyphOffsets[2*CodePointCount]   x, y pairs (vector2D)
+    r32        GlyphAdvances[CodePointCount]
+    vpak_glyph Glyphs[CodePointCount]
+    texels     ARGB32; 16 byte aligned per glyph
+    
+*/
+struct vpak_font
+{
+    u32 CodePointCount;
+    r32 BakeHeight;
+    r32 SDFSpread;
+    r32 LineAdvance;
+    r32 SpaceAdvance;
+    r32 Ascent;
+    r32 Descent;
+};
+
+struct vpak_glyph
+{
+    u16 Width;
+    u16 Height;
+    u32 TexelsOffset; // NOTE(Joey): from the start of the payload
+};
+#pragma pack(pop)
+
+#endif
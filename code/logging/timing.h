@@ -40,6 +40,10 @@ struct timing_record
     // perfectly fine to do and store directly in global array.
     char *FileName;
     char *FunctionName;
+    
+    // NOTE(Joey): counts of the last frame, as gathered by DisplayTimingRecords
+    u64 LastCycleCount;
+    u32 LastHitCount;
 };
 
 // NOTE(Joey): forward declarate from array at bottom of voidt.cpp
@@ -0,0 +1,350 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+internal void InitDebugDraw(debug_draw_buffer *buffer, memory_arena *arena, uint32 maxShapeCount)
+{
+    maxShapeCount = ((maxShapeCount + DEBUG_DRAW_SIMD_WIDTH - 1) / DEBUG_DRAW_SIMD_WIDTH) * DEBUG_DRAW_SIMD_WIDTH;
+
+    buffer->ShapeCount    = 0;
+    buffer->MaxShapeCount = maxShapeCount;
+    buffer->X0            = PushArray(arena, maxShapeCount, real32, 16);
+    buffer->Y0            = PushArray(arena, maxShapeCount, real32, 16);
+    buffer->X1            = PushArray(arena, maxShapeCount, real32, 16);
+    buffer->Y1            = PushArray(arena, maxShapeCount, real32, 16);
+    buffer->Radius        = PushArray(arena, maxShapeCount, real32, 16);
+    buffer->Colors        = PushArray(arena, maxShapeCount, uint32, 16);
+}
+
+// NOTE(Joey): clears last frame's shapes; call before anything pushes shapes this frame
+internal void BeginDebugDraw(debug_draw_buffer *buffer)
+{
+    buffer->ShapeCount = 0;
+}
+
+///////////////////////////////////////////////
+//      SHAPES
+///////////////////////////////////////////////
+// NOTE(Joey): shapes that don't fit anymore are dropped; this is debug output only
+internal void PushDebugShape(debug_draw_buffer *buffer, vector2D p0, vector2D p1, real32 radius, vector4D color)
+{
+    if(buffer->ShapeCount < buffer->MaxShapeCount)
+    {
+        uint32 index = buffer->ShapeCount++;
+        buffer->X0[index]     = p0.x;
+        buffer->Y0[index]     = p0.y;
+        buffer->X1[index]     = p1.x;
+        buffer->Y1[index]     = p1.y;
+        buffer->Radius[index] = radius;
+        buffer->Colors[index] = (RoundReal32ToUInt32(Clamp01(color.a)*255.0f) << 24) |
+                                (RoundReal32ToUInt32(Clamp01(color.r)*255.0f) << 16) |
+                                (RoundReal32ToUInt32(Clamp01(color.g)*255.0f) << 8)  |
+                                (RoundReal32ToUInt32(Clamp01(color.b)*255.0f) << 0);
+    }
+}
+
+internal void DebugDrawLine(debug_draw_buffer *buffer, vector2D from, vector2D to, vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    PushDebugShape(buffer, from, to, 0.0f, color);
+}
+
+internal void DebugDrawCircle(debug_draw_buffer *buffer, vector2D center, real32 radius, vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    if(radius > 0.0f)
+        PushDebugShape(buffer, center, center, radius, color);
+}
+
+internal void DebugDrawRectangle(debug_draw_buffer *buffer, rectangle2D rect, vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    vector2D topLeft     = { rect.Min.x, rect.Max.y };
+    vector2D bottomRight = { rect.Max.x, rect.Min.y };
+    DebugDrawLine(buffer, rect.Min, bottomRight, color);
+    DebugDrawLine(buffer, bottomRight, rect.Max, color);
+    DebugDrawLine(buffer, rect.Max, topLeft, color);
+    DebugDrawLine(buffer, topLeft, rect.Min, color);
+}
+
+///////////////////////////////////////////////
+//      BATCH
+///////////////////////////////////////////////
+internal debug_draw_batch *PrepareDebugDrawBatch(memory_arena *arena,
+                                                 debug_draw_buffer *buffer,
+                                                 vector2D screenOrigin,
+                                                 real32 metersToPixels)
+{
+    TIMING_BLOCK();
+
+    uint32 count = buffer->ShapeCount;
+    uint32 paddedCount = ((count + DEBUG_DRAW_SIMD_WIDTH - 1) / DEBUG_DRAW_SIMD_WIDTH) * DEBUG_DRAW_SIMD_WIDTH;
+
+    debug_draw_batch *batch = PushStruct(arena, debug_draw_batch);
+    batch->ShapeCount = count;
+    batch->X0         = PushArray(arena, paddedCount, real32, 16);
+    batch->Y0         = PushArray(arena, paddedCount, real32, 16);
+    batch->X1         = PushArray(arena, paddedCount, real32, 16);
+    batch->Y1         = PushArray(arena, paddedCount, real32, 16);
+    batch->Radius     = PushArray(arena, paddedCount, real32, 16);
+    batch->Colors     = buffer->Colors;
+    batch->MinX       = PushArray(arena, paddedCount, int32, 16);
+    batch->MinY       = PushArray(arena, paddedCount, int32, 16);
+    batch->MaxX       = PushArray(arena, paddedCount, int32, 16);
+    batch->MaxY       = PushArray(arena, paddedCount, int32, 16);
+
+    // NOTE(Joey): transform to screen-space and get the pixels each shape may touch; anti-aliased
+    // edges reach up to a pixel beyond the shape. Far away shapes are clamped s.t. they don't
+    // overflow the integer conversion.
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 border = _mm_set1_ps(1.0f);
+    const __m128 maxCoord = _mm_set1_ps((real32)(1 << 30));
+    const __m128 minCoord = _mm_set1_ps(-(real32)(1 << 30));
+    const __m128 originX = _mm_set1_ps(screenOrigin.x);
+    const __m128 originY = _mm_set1_ps(screenOrigin.y);
+    const __m128 scale = _mm_set1_ps(metersToPixels);
+    for(uint32 i = 0; i < paddedCount; i += 4)
+    {
+        __m128 x0 = _mm_add_ps(originX, _mm_mul_ps(scale, _mm_load_ps(buffer->X0 + i)));
+        __m128 y0 = _mm_add_ps(originY, _mm_mul_ps(scale, _mm_load_ps(buffer->Y0 + i)));
+        __m128 x1 = _mm_add_ps(originX, _mm_mul_ps(scale, _mm_load_ps(buffer->X1 + i)));
+        __m128 y1 = _mm_add_ps(originY, _mm_mul_ps(scale, _mm_load_ps(buffer->Y1 + i)));
+        __m128 radius = _mm_mul_ps(scale, _mm_load_ps(buffer->Radius + i));
+        _mm_store_ps(batch->X0 + i, x0);
+        _mm_store_ps(batch->Y0 + i, y0);
+        _mm_store_ps(batch->X1 + i, x1);
+        _mm_store_ps(batch->Y1 + i, y1);
+        _mm_store_ps(batch->Radius + i, radius);
+
+        __m128 extent = _mm_add_ps(radius, border);
+        __m128 minX = _mm_max_ps(_mm_sub_ps(_mm_min_ps(x0, x1), extent), minCoord);
+        __m128 minY = _mm_max_ps(_mm_sub_ps(_mm_min_ps(y0, y1), extent), minCoord);
+        __m128 maxX = _mm_min_ps(_mm_add_ps(_mm_max_ps(x0, x1), extent), maxCoord);
+        __m128 maxY = _mm_min_ps(_mm_add_ps(_mm_max_ps(y0, y1), extent), maxCoord);
+        _mm_store_si128((__m128i*)(batch->MinX + i), FloorToInt32_4x(minX));
+        _mm_store_si128((__m128i*)(batch->MinY + i), FloorToInt32_4x(minY));
+        // NOTE(Joey): ceil(x) = -floor(-x)
+        _mm_store_si128((__m128i*)(batch->MaxX + i), _mm_sub_epi32(_mm_setzero_si128(), FloorToInt32_4x(_mm_sub_ps(zero, maxX))));
+        _mm_store_si128((__m128i*)(batch->MaxY + i), _mm_sub_epi32(_mm_setzero_si128(), FloorToInt32_4x(_mm_sub_ps(zero, maxY))));
+    }
+    // NOTE(Joey): the last block's padding lanes hold stale shapes; give them bounds no tile overlaps
+    for(uint32 i = count; i < paddedCount; ++i)
+    {
+        batch->MinX[i] = batch->MinY[i] = 1 << 30;
+        batch->MaxX[i] = batch->MaxY[i] = -(1 << 30);
+    }
+
+    return batch;
+}
+
+///////////////////////////////////////////////
+//      RASTERIZATION
+///////////////////////////////////////////////
+// NOTE(Joey): blends color over 4 pixels by coverage (alpha premultiplied in); lanes at or beyond
+// clipMaxX belong to another tile (thread) and are left untouched.
+inline void BlendDebugDrawPixels_4x(uint32 *dest, int32 x, int32 clipMaxX, __m128 coverage,
+                                    __m128 colorR, __m128 colorG, __m128 colorB)
+{
+    if(!_mm_movemask_ps(_mm_cmpgt_ps(coverage, _mm_setzero_ps())))
+        return;
+
+    const __m128i maskFF = _mm_set1_epi32(0xFF);
+    __m128i texel = _mm_loadu_si128((__m128i*)dest);
+    __m128 destR = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texel, 16), maskFF));
+    __m128 destG = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texel, 8), maskFF));
+    __m128 destB = _mm_cvtepi32_ps(_mm_and_si128(texel, maskFF));
+    destR = _mm_add_ps(destR, _mm_mul_ps(_mm_sub_ps(colorR, destR), coverage));
+    destG = _mm_add_ps(destG, _mm_mul_ps(_mm_sub_ps(colorG, destG), coverage));
+    destB = _mm_add_ps(destB, _mm_mul_ps(_mm_sub_ps(colorB, destB), coverage));
+    __m128i out = _mm_or_si128(_mm_and_si128(texel, _mm_set1_epi32(0xFF000000)),
+                               _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(destR), 16),
+                                                         _mm_slli_epi32(_mm_cvtps_epi32(destG), 8)),
+                                            _mm_cvtps_epi32(destB)));
+
+    if(x + 4 <= clipMaxX)
+    {
+        _mm_storeu_si128((__m128i*)dest, out);
+    }
+    else
+    {
+        __m128i writeMask = _mm_cmplt_epi32(_mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3)),
+                                            _mm_set1_epi32(clipMaxX));
+        _mm_maskmoveu_si128(out, writeMask, (char*)dest);
+    }
+}
+
+/* NOTE(Joey):
+
+  Lines are 1 pixel wide and anti-aliased by their distance to the pixel
+  center. Instead of testing the line's entire bounding box (most of which
+  is empty for diagonal lines) each row only visits the pixels within a
+  pixel of the line: the row's crossing point +- the horizontal extent of
+  that band, which is length / |dy|. Shallow lines fall back to the
+  bounding box, which is then only a few rows high anyways.
+
+*/
+internal void RenderDebugLine_(Texture *target, debug_draw_batch *batch, uint32 index, rectangle2Di fillRect,
+                               __m128 colorR, __m128 colorG, __m128 colorB, __m128 alpha)
+{
+    real32 x0 = batch->X0[index];
+    real32 y0 = batch->Y0[index];
+    real32 dX = batch->X1[index] - x0;
+    real32 dY = batch->Y1[index] - y0;
+    real32 length = SquareRoot(dX*dX + dY*dY);
+    if(length < 0.001f)
+        return;
+
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 lengthSIMD = _mm_set1_ps(length);
+    __m128 dirX = _mm_set1_ps(dX / length);
+    __m128 dirY = _mm_set1_ps(dY / length);
+
+    bool32 steep = Absolute(dY) > 0.001f;
+    real32 invSlope = steep ? dX / dY : 0.0f;
+    real32 halfSpan = steep ? length / Absolute(dY) : 0.0f;
+
+    uint8 *row = (uint8*)target->Texels + fillRect.MinY*target->Pitch;
+    for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y)
+    {
+        real32 relY = (real32)y + 0.5f - y0;
+        int32 minX = fillRect.MinX;
+        int32 maxX = fillRect.MaxX;
+        if(steep)
+        {
+            real32 crossX = x0 + relY*invSlope;
+            minX = Maximum(minX, FloorReal32ToInt32(crossX - halfSpan));
+            maxX = Minimum(maxX, CeilReal32ToInt32(crossX + halfSpan));
+        }
+
+        __m128 relYSIMD = _mm_set1_ps(relY);
+        __m128 relX = _mm_sub_ps(_mm_add_ps(_mm_set1_ps((real32)minX), laneOffsets), _mm_set1_ps(x0));
+        uint32 *dest = (uint32*)row + minX;
+        for(int32 x = minX; x < maxX; x += 4)
+        {
+            // NOTE(Joey): coverage falls off w/ the distance to the line and past either end point
+            __m128 across = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_mul_ps(relX, dirY), _mm_mul_ps(relYSIMD, dirX)));
+            __m128 along = _mm_add_ps(_mm_mul_ps(relX, dirX), _mm_mul_ps(relYSIMD, dirY));
+            __m128 inside = _mm_add_ps(_mm_min_ps(along, _mm_sub_ps(lengthSIMD, along)), half);
+            __m128 coverage = _mm_mul_ps(_mm_max_ps(_mm_sub_ps(one, across), zero),
+                                         _mm_min_ps(_mm_max_ps(inside, zero), one));
+            BlendDebugDrawPixels_4x(dest, x, fillRect.MaxX, _mm_mul_ps(coverage, alpha), colorR, colorG, colorB);
+
+            relX = _mm_add_ps(relX, _mm_set1_ps(4.0f));
+            dest += 4;
+        }
+        row += target->Pitch;
+    }
+}
+
+internal void RenderDebugCircleSpan_(uint32 *row, int32 minX, int32 maxX, int32 clipMaxX,
+                                     real32 centerX, __m128 dYSq, __m128 radius,
+                                     __m128 colorR, __m128 colorG, __m128 colorB, __m128 alpha)
+{
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    __m128 dX = _mm_sub_ps(_mm_add_ps(_mm_set1_ps((real32)minX), laneOffsets), _mm_set1_ps(centerX));
+    uint32 *dest = row + minX;
+    for(int32 x = minX; x < maxX; x += 4)
+    {
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dX, dX), dYSq));
+        __m128 across = _mm_andnot_ps(signMask, _mm_sub_ps(distance, radius));
+        __m128 coverage = _mm_max_ps(_mm_sub_ps(one, across), zero);
+        BlendDebugDrawPixels_4x(dest, x, clipMaxX, _mm_mul_ps(coverage, alpha), colorR, colorG, colorB);
+
+        dX = _mm_add_ps(dX, _mm_set1_ps(4.0f));
+        dest += 4;
+    }
+}
+
+// NOTE(Joey): 1 pixel wide outline; each row only visits the (1 or 2) spans within a pixel of the circle
+internal void RenderDebugCircle_(Texture *target, debug_draw_batch *batch, uint32 index, rectangle2Di fillRect,
+                                 __m128 colorR, __m128 colorG, __m128 colorB, __m128 alpha)
+{
+    real32 centerX = batch->X0[index];
+    real32 centerY = batch->Y0[index];
+    real32 radius = batch->Radius[index];
+    real32 outerSq = (radius + 1.0f)*(radius + 1.0f);
+    real32 innerSq = radius > 1.0f ? (radius - 1.0f)*(radius - 1.0f) : 0.0f;
+    __m128 radiusSIMD = _mm_set1_ps(radius);
+
+    uint8 *row = (uint8*)target->Texels + fillRect.MinY*target->Pitch;
+    for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y, row += target->Pitch)
+    {
+        real32 dY = (real32)y + 0.5f - centerY;
+        real32 dYSq = dY*dY;
+        if(dYSq >= outerSq)
+            continue;
+
+        real32 outer = SquareRoot(outerSq - dYSq);
+        real32 inner = dYSq < innerSq ? SquareRoot(innerSq - dYSq) : 0.0f;
+        int32 leftMinX  = Maximum(fillRect.MinX, FloorReal32ToInt32(centerX - outer));
+        int32 leftMaxX  = Minimum(fillRect.MaxX, CeilReal32ToInt32(centerX - inner));
+        int32 rightMinX = Maximum(fillRect.MinX, FloorReal32ToInt32(centerX + inner));
+        int32 rightMaxX = Minimum(fillRect.MaxX, CeilReal32ToInt32(centerX + outer));
+        // NOTE(Joey): near the top and bottom both spans touch; blend them as one s.t. no pixel is blended twice
+        if(rightMinX <= leftMaxX)
+        {
+            leftMaxX = rightMaxX;
+            rightMaxX = rightMinX;
+        }
+        __m128 dYSqSIMD = _mm_set1_ps(dYSq);
+        RenderDebugCircleSpan_((uint32*)row, leftMinX, leftMaxX, fillRect.MaxX, centerX, dYSqSIMD, radiusSIMD,
+                               colorR, colorG, colorB, alpha);
+        RenderDebugCircleSpan_((uint32*)row, rightMinX, rightMaxX, fillRect.MaxX, centerX, dYSqSIMD, radiusSIMD,
+                               colorR, colorG, colorB, alpha);
+    }
+}
+
+// NOTE(Joey): shapes are culled against the tile 4 at a time on their pixel bounds; only the ones
+// that overlap it are rasterized.
+internal void RenderDebugDraw_(Texture *target, debug_draw_batch *batch, rectangle2Di clipRect)
+{
+    TIMING_BLOCK();
+
+    const __m128i clipMinX = _mm_set1_epi32(clipRect.MinX);
+    const __m128i clipMinY = _mm_set1_epi32(clipRect.MinY);
+    const __m128i clipMaxX = _mm_set1_epi32(clipRect.MaxX);
+    const __m128i clipMaxY = _mm_set1_epi32(clipRect.MaxY);
+    const real32 inv255 = 1.0f / 255.0f;
+
+    for(uint32 i = 0; i < batch->ShapeCount; i += 4)
+    {
+        __m128i overlapX = _mm_and_si128(_mm_cmplt_epi32(_mm_load_si128((__m128i*)(batch->MinX + i)), clipMaxX),
+                                         _mm_cmpgt_epi32(_mm_load_si128((__m128i*)(batch->MaxX + i)), clipMinX));
+        __m128i overlapY = _mm_and_si128(_mm_cmplt_epi32(_mm_load_si128((__m128i*)(batch->MinY + i)), clipMaxY),
+                                         _mm_cmpgt_epi32(_mm_load_si128((__m128i*)(batch->MaxY + i)), clipMinY));
+        uint32 laneMask = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(overlapX, overlapY)));
+
+        uint32 lane;
+        while(FindLeastSignificantSetBit(&lane, laneMask))
+        {
+            laneMask &= laneMask - 1;
+            uint32 index = i + lane;
+
+            rectangle2Di fillRect = { batch->MinX[index], batch->MinY[index], batch->MaxX[index], batch->MaxY[index] };
+            fillRect = Intersect(fillRect, clipRect);
+
+            uint32 color = batch->Colors[index];
+            __m128 colorR = _mm_set1_ps((real32)((color >> 16) & 0xFF));
+            __m128 colorG = _mm_set1_ps((real32)((color >> 8) & 0xFF));
+            __m128 colorB = _mm_set1_ps((real32)((color >> 0) & 0xFF));
+            __m128 alpha  = _mm_set1_ps((real32)(color >> 24)*inv255);
+            if(batch->Radius[index] > 0.0f)
+                RenderDebugCircle_(target, batch, index, fillRect, colorR, colorG, colorB, alpha);
+            else
+                RenderDebugLine_(target, batch, index, fillRect, colorR, colorG, colorB, alpha);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef DEBUG_DRAW_H
+#define DEBUG_DRAW_H
+
+// NOTE(Joey): shapes are culled per tile 4 at a time; keep capacity a multiple of that
+const uint32 DEBUG_DRAW_SIMD_WIDTH = 4;
+
+/* NOTE(Joey):
+
+  Debug shapes (lines, circle outlines and rectangle outlines) pushed from
+  anywhere during a frame, in world units. Lines and circles share the same
+  layout: a circle is a line from its center to its center w/ a radius > 0,
+  s.t. transforming and bounding them is the same operation for all shapes.
+  Rectangles are pushed as 4 lines.
+
+*/
+struct debug_draw_buffer
+{
+    uint32 ShapeCount;
+    uint32 MaxShapeCount;
+
+    real32 *X0;
+    real32 *Y0;
+    real32 *X1;
+    real32 *Y1;
+    real32 *Radius; // NOTE(Joey): 0 for lines
+    uint32 *Colors; // NOTE(Joey): 0xAARRGGBB
+};
+
+// NOTE(Joey): per-frame screen-space snapshot of a debug_draw_buffer, w/ the pixel bounds of each shape
+struct debug_draw_batch
+{
+    uint32  ShapeCount;
+    real32 *X0;
+    real32 *Y0;
+    real32 *X1;
+    real32 *Y1;
+    real32 *Radius;
+    uint32 *Colors;
+
+    int32 *MinX; // NOTE(Joey): padded w/ empty bounds up to a multiple of DEBUG_DRAW_SIMD_WIDTH
+    int32 *MinY;
+    int32 *MaxX;
+    int32 *MaxY;
+};
+
+#endif
@@ -0,0 +1,509 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+// TODO(Joey): write custom string formatting (remove dependency on c-standard library: stdio.h)
+#include <stdio.h>
+#include <stdarg.h>
+
+/* NOTE(Joey):
+
+  Immediate-mode debug UI on top of the render queue. Each frame panels and
+  their widgets are declared in order between BeginDebugUI and EndDebugUI;
+  there's no retained widget tree. Widgets are laid out top-down from the
+  panel's top-left corner (in target pixels, y up) and clipped to their
+  panel through RENDER_TYPE_CLIP items.
+
+  Laying out text is the costly part, so every widget's render items are
+  kept in a cache keyed by the widget's ID and a hash of its content (see
+  debug_ui_widget): unchanged widgets re-emit their cached span. Rebuilt
+  widgets leave their old span behind; once the item storage or the hash
+  table fills up, EndDebugUI compacts the cache down to the widgets used
+  that frame.
+
+*/
+
+const uint32 DEBUG_UI_HASH_SEED = 2166136261;
+const real32 DEBUG_UI_PADDING   = 4.0f;
+
+const vector4D DEBUG_UI_PANEL_COLOR  = { 0.08f, 0.08f, 0.10f, 1.0f };
+const vector4D DEBUG_UI_TITLE_COLOR  = { 0.20f, 0.22f, 0.30f, 1.0f };
+const vector4D DEBUG_UI_TRACK_COLOR  = { 0.20f, 0.20f, 0.24f, 1.0f };
+const vector4D DEBUG_UI_FILL_COLOR   = { 0.35f, 0.60f, 0.90f, 1.0f };
+const vector4D DEBUG_UI_HOT_COLOR    = { 0.55f, 0.80f, 1.00f, 1.0f };
+const vector4D DEBUG_UI_TEXT_COLOR   = { 0.90f, 0.90f, 0.90f, 1.0f };
+
+// NOTE(Joey): FNV-1a
+inline uint32 DebugUIHash(uint32 hash, void *data, uint32 size)
+{
+    uint8 *bytes = (uint8*)data;
+    for(uint32 i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 16777619;
+    return hash;
+}
+
+inline uint32 DebugUIHashString(uint32 hash, char *string)
+{
+    for(char *c = string; *c; ++c)
+        hash = (hash ^ (uint8)*c) * 16777619;
+    return hash;
+}
+
+internal void InitDebugUI(debug_ui *ui, memory_arena *arena, game_font *font, real32 textHeight = 14.0f)
+{
+    *ui = {};
+    ui->Font       = font && font->IsSDF ? font : 0;
+    ui->TextScale  = ui->Font ? textHeight / ui->Font->BakeHeight : 1.0f;
+    ui->LineHeight = ui->Font ? ui->TextScale*ui->Font->LineAdvance : textHeight;
+
+    ui->CachedItems  = PushArray(arena, DEBUG_UI_MAX_CACHED_ITEMS, RenderQueueItem);
+    ui->CompactItems = PushArray(arena, DEBUG_UI_MAX_CACHED_ITEMS, RenderQueueItem);
+}
+
+internal void BeginDebugUI(debug_ui *ui, RenderQueue *queue, game_input *input, Texture *target)
+{
+    ui->Queue = queue;
+    ui->FrameIndex += 1;
+    ui->ClipDepth = 0;
+    ui->CacheHits = 0;
+    ui->CacheMisses = 0;
+
+    // NOTE(Joey): the platform's mouse position is y down
+    ui->MousePosition = { (real32)input->MouseX, (real32)(target->Height - 1 - input->MouseY) };
+    ui->MouseDown     = input->MouseButtons[0].EndedDown;
+    ui->MousePressed  = ui->MouseDown && input->MouseButtons[0].HalfTransitionCount > 0;
+    if(!ui->MouseDown)
+        ui->ActiveID = 0;
+}
+
+///////////////////////////////////////////////
+//      CLIP STACK
+///////////////////////////////////////////////
+internal void PushDebugUIClip(debug_ui *ui, rectangle2Di clipRect)
+{
+    Assert(ui->ClipDepth < DEBUG_UI_MAX_CLIP_DEPTH);
+    if(ui->ClipDepth > 0)
+        clipRect = Intersect(ui->ClipStack[ui->ClipDepth - 1], clipRect);
+    ui->ClipStack[ui->ClipDepth++] = clipRect;
+    PushClipRect(ui->Queue, clipRect);
+}
+
+internal void PopDebugUIClip(debug_ui *ui)
+{
+    Assert(ui->ClipDepth > 0);
+    --ui->ClipDepth;
+    if(ui->ClipDepth > 0)
+        PushClipRect(ui->Queue, ui->ClipStack[ui->ClipDepth - 1]);
+    else
+        ResetClipRect(ui->Queue);
+}
+
+inline bool32 IsDebugUIRectVisible(debug_ui *ui, rectangle2D rect)
+{
+    bool32 result = true;
+    if(ui->ClipDepth > 0)
+    {
+        rectangle2Di clipRect = ui->ClipStack[ui->ClipDepth - 1];
+        result = rect.Max.x > clipRect.MinX && rect.Min.x < clipRect.MaxX &&
+                 rect.Max.y > clipRect.MinY && rect.Min.y < clipRect.MaxY;
+    }
+    return result;
+}
+
+inline bool32 IsDebugUIMouseOver(debug_ui *ui, rectangle2D rect)
+{
+    vector2D mouse = ui->MousePosition;
+    bool32 result = mouse.x >= rect.Min.x && mouse.x < rect.Max.x && mouse.y >= rect.Min.y && mouse.y < rect.Max.y;
+    if(result && ui->ClipDepth > 0)
+    {
+        rectangle2Di clipRect = ui->ClipStack[ui->ClipDepth - 1];
+        result = mouse.x >= clipRect.MinX && mouse.x < clipRect.MaxX && mouse.y >= clipRect.MinY && mouse.y < clipRect.MaxY;
+    }
+    return result;
+}
+
+///////////////////////////////////////////////
+//      TEXT
+///////////////////////////////////////////////
+internal real32 GetDebugUITextWidth(debug_ui *ui, char *text)
+{
+    real32 result = 0.0f;
+    game_font *font = ui->Font;
+    if(font)
+    {
+        for(char *c = text; *c; ++c)
+        {
+            if(*c == ' ')
+                result += font->SpaceAdvance;
+            else if(GetGlyph(font, *c))
+                result += font->GlyphAdvances[*c - '!'];
+        }
+    }
+    return ui->TextScale*result;
+}
+
+// NOTE(Joey): pushes a glyph per character w/ the text's baseline starting at pen
+internal void PushDebugUIText(debug_ui *ui, vector2D pen, char *text, vector4D color)
+{
+    game_font *font = ui->Font;
+    if(!font)
+        return;
+
+    real32 scale = ui->TextScale;
+    for(char *c = text; *c; ++c)
+    {
+        if(*c == ' ')
+        {
+            pen.x += scale*font->SpaceAdvance;
+            continue;
+        }
+        Texture *glyph = GetGlyph(font, *c);
+        if(!glyph)
+            continue;
+
+        uint32 glyphIndex = *c - '!';
+        vector2D size = { scale*glyph->Width, scale*glyph->Height };
+        vector2D corner = pen + scale*font->GlyphOffsets[glyphIndex];
+        PushTextureSDF(ui->Queue, glyph, corner + 0.5f*size, 0, size, font->SDFSpread, color);
+        pen.x += scale*font->GlyphAdvances[glyphIndex];
+    }
+}
+
+///////////////////////////////////////////////
+//      WIDGET CACHE
+///////////////////////////////////////////////
+// NOTE(Joey): widgets are identified by their panel and the order they're declared in
+inline uint32 GetDebugUIWidgetID(debug_ui *ui)
+{
+    uint32 result = DebugUIHash(ui->PanelID, &ui->WidgetIndex, sizeof(ui->WidgetIndex));
+    ui->WidgetIndex += 1;
+    return result ? result : 1;
+}
+
+// NOTE(Joey): finds the widget's cache slot or claims a new one; 0 if the table is full
+internal debug_ui_widget *GetDebugUIWidget(debug_ui *ui, uint32 id)
+{
+    const uint32 mask = DEBUG_UI_MAX_WIDGETS - 1;
+    for(uint32 probe = 0; probe < DEBUG_UI_MAX_WIDGETS / 4; ++probe)
+    {
+        debug_ui_widget *widget = ui->Widgets + ((id + probe) & mask);
+        if(widget->ID == id)
+            return widget;
+        if(widget->ID == 0)
+        {
+            *widget = {};
+            widget->ID = id;
+            return widget;
+        }
+    }
+    ui->CacheFull = true;
+    return 0;
+}
+
+// NOTE(Joey): widgets lay out relative to the panel's width (bars, sliders), so a resized panel 
+// invalidates their cached items as well
+inline uint32 GetDebugUIWidgetContentHash(debug_ui *ui, uint32 contentHash)
+{
+    return DebugUIHash(contentHash, &ui->ContentWidth, sizeof(ui->ContentWidth));
+}
+
+// NOTE(Joey): copies the widget's cached span to the cursor if its content is unchanged
+internal bool32 EmitCachedDebugUIWidget(debug_ui *ui, debug_ui_widget *widget, uint32 contentHash)
+{
+    contentHash = GetDebugUIWidgetContentHash(ui, contentHash);
+    if(!widget || widget->LastUsedFrame == 0 || widget->ContentHash != contentHash)
+        return false;
+
+    RenderQueue *queue = ui->Queue;
+    Assert(queue->RenderCount + widget->ItemCount < queue->MaxRenderCount);
+    RenderQueueItem *source = ui->CachedItems + widget->FirstItem;
+    RenderQueueItem *dest = queue->RenderItems + queue->RenderCount;
+    for(uint32 i = 0; i < widget->ItemCount; ++i)
+    {
+        dest[i] = source[i];
+        dest[i].Position += ui->Cursor;
+    }
+    queue->RenderCount += widget->ItemCount;
+
+    widget->LastUsedFrame = ui->FrameIndex;
+    ui->Cursor.y -= widget->Height;
+    ui->CacheHits += 1;
+    return true;
+}
+
+// NOTE(Joey): stores the items the widget pushed since firstItem in the cache and moves the cursor past it
+internal void StoreDebugUIWidget(debug_ui *ui, debug_ui_widget *widget, uint32 contentHash, uint32 firstItem, real32 height)
+{
+    ui->CacheMisses += 1;
+
+    uint32 itemCount = ui->Queue->RenderCount - firstItem;
+    if(widget)
+    {
+        widget->LastUsedFrame = 0;
+        if(ui->CachedItemCount + itemCount <= DEBUG_UI_MAX_CACHED_ITEMS)
+        {
+            RenderQueueItem *source = ui->Queue->RenderItems + firstItem;
+            RenderQueueItem *dest = ui->CachedItems + ui->CachedItemCount;
+            for(uint32 i = 0; i < itemCount; ++i)
+            {
+                dest[i] = source[i];
+                dest[i].Position = dest[i].Position - ui->Cursor;
+            }
+            widget->ContentHash   = GetDebugUIWidgetContentHash(ui, contentHash);
+            widget->FirstItem     = ui->CachedItemCount;
+            widget->ItemCount     = itemCount;
+            widget->Height        = height;
+            widget->LastUsedFrame = ui->FrameIndex;
+            ui->CachedItemCount += itemCount;
+        }
+        else
+        {
+            ui->CacheFull = true;
+        }
+    }
+    ui->Cursor.y -= height;
+}
+
+// NOTE(Joey): moves the spans of widgets used this frame to the front of the (other) item buffer
+internal void CompactDebugUICache(debug_ui *ui)
+{
+    debug_ui_widget widgets[DEBUG_UI_MAX_WIDGETS];
+    for(uint32 i = 0; i < DEBUG_UI_MAX_WIDGETS; ++i)
+    {
+        widgets[i] = ui->Widgets[i];
+        ui->Widgets[i] = {};
+    }
+
+    uint32 itemCount = 0;
+    for(uint32 i = 0; i < DEBUG_UI_MAX_WIDGETS; ++i)
+    {
+        debug_ui_widget *source = widgets + i;
+        if(source->ID && source->LastUsedFrame == ui->FrameIndex)
+        {
+            debug_ui_widget *widget = GetDebugUIWidget(ui, source->ID);
+            if(!widget)
+                continue;
+            *widget = *source;
+            widget->FirstItem = itemCount;
+            for(uint32 j = 0; j < source->ItemCount; ++j)
+                ui->CompactItems[itemCount++] = ui->CachedItems[source->FirstItem + j];
+        }
+    }
+
+    RenderQueueItem *items = ui->CachedItems;
+    ui->CachedItems = ui->CompactItems;
+    ui->CompactItems = items;
+    ui->CachedItemCount = itemCount;
+    ui->CacheFull = false;
+}
+
+internal void EndDebugUI(debug_ui *ui)
+{
+    Assert(ui->ClipDepth == 0);
+    if(ui->CacheFull)
+        CompactDebugUICache(ui);
+    ui->Queue = 0;
+}
+
+///////////////////////////////////////////////
+//      PANELS
+///////////////////////////////////////////////
+internal void BeginDebugUIPanel(debug_ui *ui, char *title, rectangle2Di rect)
+{
+    ui->PanelID = DebugUIHashString(DEBUG_UI_HASH_SEED, title);
+    ui->WidgetIndex = 0;
+    ui->Cursor = { (real32)rect.MinX, (real32)rect.MaxY };
+    ui->ContentWidth = (real32)(rect.MaxX - rect.MinX) - 2.0f*DEBUG_UI_PADDING;
+
+    // NOTE(Joey): the panel's background and title are cached as a widget of their own
+    real32 titleHeight = ui->LineHeight + 2.0f*DEBUG_UI_PADDING;
+    vector2D panelSize = { (real32)(rect.MaxX - rect.MinX), (real32)(rect.MaxY - rect.MinY) };
+    uint32 contentHash = DebugUIHash(DebugUIHashString(DEBUG_UI_HASH_SEED, title), &panelSize, sizeof(panelSize));
+    debug_ui_widget *widget = GetDebugUIWidget(ui, GetDebugUIWidgetID(ui));
+    if(!EmitCachedDebugUIWidget(ui, widget, contentHash))
+    {
+        uint32 firstItem = ui->Queue->RenderCount;
+        vector2D cursor = ui->Cursor;
+        PushRectangle(ui->Queue, cursor - vector2D{ 0.0f, panelSize.y }, 0, panelSize, DEBUG_UI_PANEL_COLOR);
+        PushRectangle(ui->Queue, cursor - vector2D{ 0.0f, titleHeight }, 0, { panelSize.x, titleHeight }, DEBUG_UI_TITLE_COLOR);
+        vector2D pen = { cursor.x + DEBUG_UI_PADDING, cursor.y - DEBUG_UI_PADDING };
+        if(ui->Font)
+            pen.y -= ui->TextScale*ui->Font->Ascent;
+        PushDebugUIText(ui, pen, title, DEBUG_UI_TEXT_COLOR);
+        StoreDebugUIWidget(ui, widget, contentHash, firstItem, titleHeight);
+    }
+
+    rectangle2Di contentRect = rect;
+    contentRect.MaxY -= (int32)titleHeight;
+    PushDebugUIClip(ui, contentRect);
+    ui->Cursor.x += DEBUG_UI_PADDING;
+    ui->Cursor.y -= DEBUG_UI_PADDING;
+}
+
+internal void EndDebugUIPanel(debug_ui *ui)
+{
+    PopDebugUIClip(ui);
+}
+
+///////////////////////////////////////////////
+//      WIDGETS
+///////////////////////////////////////////////
+inline rectangle2D GetDebugUILineRect(debug_ui *ui)
+{
+    rectangle2D result;
+    result.Min = { ui->Cursor.x, ui->Cursor.y - ui->LineHeight };
+    result.Max = { ui->Cursor.x + ui->ContentWidth, ui->Cursor.y };
+    return result;
+}
+
+inline vector2D GetDebugUIBaseline(debug_ui *ui)
+{
+    vector2D result = ui->Cursor;
+    if(ui->Font)
+        result.y -= ui->TextScale*ui->Font->Ascent;
+    return result;
+}
+
+internal void DebugUIText(debug_ui *ui, char *text, vector4D color = DEBUG_UI_TEXT_COLOR)
+{
+    uint32 id = GetDebugUIWidgetID(ui);
+    if(!IsDebugUIRectVisible(ui, GetDebugUILineRect(ui)))
+    {   // NOTE(Joey): scrolled out of its panel; only take up its space
+        ui->Cursor.y -= ui->LineHeight;
+        return;
+    }
+
+    uint32 contentHash = DebugUIHash(DebugUIHashString(DEBUG_UI_HASH_SEED, text), &color, sizeof(color));
+    debug_ui_widget *widget = GetDebugUIWidget(ui, id);
+    if(!EmitCachedDebugUIWidget(ui, widget, contentHash))
+    {
+        uint32 firstItem = ui->Queue->RenderCount;
+        PushDebugUIText(ui, GetDebugUIBaseline(ui), text, color);
+        StoreDebugUIWidget(ui, widget, contentHash, firstItem, ui->LineHeight);
+    }
+}
+
+internal void DebugUIPrintf(debug_ui *ui, char *format, ...)
+{
+    char text[DEBUG_UI_MAX_TEXT_LENGTH];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    DebugUIText(ui, text);
+}
+
+// NOTE(Joey): label w/ a bar filled to value / maxValue on the right half of the panel
+internal void DebugUIBar(debug_ui *ui, char *label, real32 value, real32 maxValue)
+{
+    uint32 id = GetDebugUIWidgetID(ui);
+    rectangle2D lineRect = GetDebugUILineRect(ui);
+    if(!IsDebugUIRectVisible(ui, lineRect))
+    {
+        ui->Cursor.y -= ui->LineHeight;
+        return;
+    }
+
+    real32 barWidth = 0.5f*ui->ContentWidth;
+    real32 fill = maxValue > 0.0f ? Clamp01(value / maxValue) : 0.0f;
+    uint32 fillWidth = RoundReal32ToUInt32(fill*barWidth);
+    uint32 contentHash = DebugUIHash(DebugUIHashString(DEBUG_UI_HASH_SEED, label), &fillWidth, sizeof(fillWidth));
+    debug_ui_widget *widget = GetDebugUIWidget(ui, id);
+    if(!EmitCachedDebugUIWidget(ui, widget, contentHash))
+    {
+        uint32 firstItem = ui->Queue->RenderCount;
+        vector2D barPosition = { lineRect.Max.x - barWidth, lineRect.Min.y + 2.0f };
+        real32 barHeight = ui->LineHeight - 4.0f;
+        PushRectangle(ui->Queue, barPosition, 0, { barWidth, barHeight }, DEBUG_UI_TRACK_COLOR);
+        if(fillWidth)
+            PushRectangle(ui->Queue, barPosition, 0, { (real32)fillWidth, barHeight }, DEBUG_UI_FILL_COLOR);
+        PushDebugUIText(ui, GetDebugUIBaseline(ui), label, DEBUG_UI_TEXT_COLOR);
+        StoreDebugUIWidget(ui, widget, contentHash, firstItem, ui->LineHeight);
+    }
+}
+
+// NOTE(Joey): returns true if clicked this frame (and value flipped)
+internal bool32 DebugUIToggle(debug_ui *ui, char *label, bool32 *value)
+{
+    uint32 id = GetDebugUIWidgetID(ui);
+    rectangle2D lineRect = GetDebugUILineRect(ui);
+    if(!IsDebugUIRectVisible(ui, lineRect))
+    {
+        ui->Cursor.y -= ui->LineHeight;
+        return false;
+    }
+
+    bool32 hot = IsDebugUIMouseOver(ui, lineRect);
+    bool32 clicked = hot && ui->MousePressed;
+    if(clicked)
+        *value = !*value;
+
+    uint32 state = (*value ? 1 : 0) | (hot ? 2 : 0);
+    uint32 contentHash = DebugUIHash(DebugUIHashString(DEBUG_UI_HASH_SEED, label), &state, sizeof(state));
+    debug_ui_widget *widget = GetDebugUIWidget(ui, id);
+    if(!EmitCachedDebugUIWidget(ui, widget, contentHash))
+    {
+        uint32 firstItem = ui->Queue->RenderCount;
+        real32 boxSize = ui->LineHeight - 4.0f;
+        vector2D boxPosition = { lineRect.Min.x, lineRect.Min.y + 2.0f };
+        PushRectangle(ui->Queue, boxPosition, 0, { boxSize, boxSize }, hot ? DEBUG_UI_HOT_COLOR : DEBUG_UI_TRACK_COLOR);
+        if(*value)
+            PushRectangle(ui->Queue, boxPosition + vector2D{ 2.0f, 2.0f }, 0, { boxSize - 4.0f, boxSize - 4.0f }, DEBUG_UI_FILL_COLOR);
+        PushDebugUIText(ui, GetDebugUIBaseline(ui) + vector2D{ boxSize + DEBUG_UI_PADDING, 0.0f }, label, DEBUG_UI_TEXT_COLOR);
+        StoreDebugUIWidget(ui, widget, contentHash, firstItem, ui->LineHeight);
+    }
+    return clicked;
+}
+
+// NOTE(Joey): dragging anywhere on the track sets the value; returns true while it's being changed
+internal bool32 DebugUISlider(debug_ui *ui, char *label, real32 *value, real32 minValue, real32 maxValue)
+{
+    uint32 id = GetDebugUIWidgetID(ui);
+    rectangle2D lineRect = GetDebugUILineRect(ui);
+    if(!IsDebugUIRectVisible(ui, lineRect))
+    {
+        ui->Cursor.y -= ui->LineHeight;
+        return false;
+    }
+
+    real32 trackWidth = 0.5f*ui->ContentWidth;
+    rectangle2D trackRect = lineRect;
+    trackRect.Min.x = lineRect.Max.x - trackWidth;
+
+    bool32 hot = IsDebugUIMouseOver(ui, trackRect);
+    if(hot && ui->MousePressed)
+        ui->ActiveID = id;
+    bool32 active = ui->ActiveID == id;
+    if(active)
+    {
+        real32 t = Clamp01((ui->MousePosition.x - trackRect.Min.x) / trackWidth);
+        *value = Lerp(minValue, maxValue, t);
+    }
+
+    char text[DEBUG_UI_MAX_TEXT_LENGTH];
+    snprintf(text, sizeof(text), "%s %.3f", label, *value);
+    real32 t = maxValue > minValue ? Clamp01((*value - minValue) / (maxValue - minValue)) : 0.0f;
+    uint32 state[2] = { RoundReal32ToUInt32(t*trackWidth), (uint32)((hot ? 1 : 0) | (active ? 2 : 0)) };
+    uint32 contentHash = DebugUIHash(DebugUIHashString(DEBUG_UI_HASH_SEED, text), state, sizeof(state));
+    debug_ui_widget *widget = GetDebugUIWidget(ui, id);
+    if(!EmitCachedDebugUIWidget(ui, widget, contentHash))
+    {
+        uint32 firstItem = ui->Queue->RenderCount;
+        real32 trackHeight = ui->LineHeight - 4.0f;
+        vector2D trackPosition = { trackRect.Min.x, trackRect.Min.y + 2.0f };
+        PushRectangle(ui->Queue, trackPosition, 0, { trackWidth, trackHeight }, DEBUG_UI_TRACK_COLOR);
+        if(state[0])
+            PushRectangle(ui->Queue, trackPosition, 0, { (real32)state[0], trackHeight },
+                          hot || active ? DEBUG_UI_HOT_COLOR : DEBUG_UI_FILL_COLOR);
+        PushDebugUIText(ui, GetDebugUIBaseline(ui), text, DEBUG_UI_TEXT_COLOR);
+        StoreDebugUIWidget(ui, widget, contentHash, firstItem, ui->LineHeight);
+    }
+    return active;
+}
@@ -0,0 +1,71 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef DEBUG_UI_H
+#define DEBUG_UI_H
+
+const uint32 DEBUG_UI_MAX_WIDGETS      = 512; // NOTE(Joey): power of 2; size of the widget cache's hash table
+const uint32 DEBUG_UI_MAX_CACHED_ITEMS = 4096;
+const uint32 DEBUG_UI_MAX_CLIP_DEPTH   = 16;
+const uint32 DEBUG_UI_MAX_TEXT_LENGTH  = 256;
+
+/* NOTE(Joey):
+
+  A widget's cached geometry: the render items it pushed the last time it
+  was laid out, stored relative to the widget's top-left corner. As long as
+  a widget's ID (its panel and position in the panel) and content hash
+  (text, values and interaction state) match, the span is copied into the
+  render queue again instead of laying the widget out.
+
+*/
+struct debug_ui_widget
+{
+    uint32 ID;           // NOTE(Joey): 0 is a free slot
+    uint32 ContentHash;
+    uint32 FirstItem;
+    uint32 ItemCount;
+    uint32 LastUsedFrame;
+    real32 Height;
+};
+
+struct debug_ui
+{
+    game_font *Font;      // NOTE(Joey): SDF font; w/o one text is left out
+    real32     TextScale; // NOTE(Joey): screen pixels per baked font pixel
+    real32     LineHeight;
+
+    debug_ui_widget  Widgets[DEBUG_UI_MAX_WIDGETS];
+    RenderQueueItem *CachedItems;
+    RenderQueueItem *CompactItems; // NOTE(Joey): CachedItems' twin; live spans are moved here on compaction
+    uint32           CachedItemCount;
+    bool32           CacheFull;
+
+    // NOTE(Joey): per frame state
+    RenderQueue *Queue;
+    uint32       FrameIndex;
+    rectangle2Di ClipStack[DEBUG_UI_MAX_CLIP_DEPTH];
+    uint32       ClipDepth;
+
+    uint32   PanelID;
+    uint32   WidgetIndex;
+    vector2D Cursor;       // NOTE(Joey): top-left of the next widget
+    real32   ContentWidth;
+
+    vector2D MousePosition; // NOTE(Joey): in target pixels, y up
+    bool32   MouseDown;
+    bool32   MousePressed;
+    uint32   ActiveID;      // NOTE(Joey): widget the mouse was pressed on, until it's released
+
+    uint32 CacheHits;
+    uint32 CacheMisses;
+};
+
+#endif
@@ -13,6 +13,8 @@
 internal game_font* LoadTrueTypeFont(memory_arena *arena, char *filename)
 {
     debug_read_file_result readResult = PlatformAPI.DEBUGReadEntireFile(filename);
+    if(!readResult.Contents)
+        return 0;
     
     game_font *font = PushStruct(arena, game_font);
     stbtt_InitFont(&font->FontInfo, (u8*)readResult.Contents, stbtt_GetFontOffsetForIndex((u8*)readResult.Contents, 0));
@@ -26,41 +28,230 @@ internal game_font* LoadTrueTypeFont(memory_arena *arena, char *filename)
     return font;        
 }
 
+// NOTE(Joey): copy of the font info with stb's allocation context pointed at the given arena; a 
+// copy (instead of setting userdata on the shared font) keeps concurrent glyph bakes thread-safe.
+inline stbtt_fontinfo GetArenaFontInfo(game_font *font, memory_arena *arena)
+{
+    stbtt_fontinfo result = font->FontInfo;
+    result.userdata = arena;
+    return result;
+}
+
 internal Texture LoadCharacterGlyph(memory_arena *arena, game_font *font, u32 codePoint, r32 scale = 32.0f)
 {
     // TODO(Joey): get pointer to proper Texture of Font from CodePoint (probably do a codePoint - '!' to get array index)
     // then set Texture struct items and do a PushSize on memory of texture for glyph!
-    Texture texture = {};
+    stbtt_fontinfo fontInfo = GetArenaFontInfo(font, arena);
+    r32 pixelScale = stbtt_ScaleForPixelHeight(&fontInfo, scale);
     
-    int width, height, xoffset, yoffset;
-    u8 *monoBitmap = stbtt_GetCodepointBitmap(&font->FontInfo, 0, stbtt_ScaleForPixelHeight(&font->FontInfo, scale), 
-                                              codePoint, &width, &height, &xoffset, &yoffset);
+    int x0, y0, x1, y1;
+    stbtt_GetCodepointBitmapBox(&fontInfo, codePoint, pixelScale, pixelScale, &x0, &y0, &x1, &y1);
+    i32 width  = x1 - x0;
+    i32 height = y1 - y0;
                                  
-    texture = CreateEmptyTexture(arena, (u16)width, (u16)height);
+    Texture texture = CreateEmptyTexture(arena, (u16)width, (u16)height);
+    if(width > 0 && height > 0)
+    {
+        // NOTE(Joey): rasterize the 8-bit coverage directly into the front of the texture's own 
+        // memory; a negative stride flips the rows s.t. the glyph ends up bottom-up. stb's
+        // internal edge/scanline buffers are pushed above the texture and rolled back after.
+        u8 *coverage = (u8*)texture.Texels;
+        temp_memory rasterMemory = BeginTempMemory(arena);
+        stbtt_MakeCodepointBitmap(&fontInfo, coverage + (height - 1)*width, width, height, -width, 
+                                  pixelScale, pixelScale, codePoint);
+        EndTempMemory(rasterMemory);
+        
+        // NOTE(Joey): expand to 32-bit texels in place; going back-to-front each texel is only
+        // written after every coverage byte it overlaps has been read.
+        for(i32 i = width*height - 1; i >= 0; --i)
+        {
+            u32 alpha = coverage[i];
+            texture.Texels[i] = (alpha << 24) | 0x00FFFFFF;
+        }
+    }
     
-    u8 *source = monoBitmap;
+    return texture;
+}
+
+///////////////////////////////////////////////
+//      SIGNED DISTANCE FIELD GLYPHS
+///////////////////////////////////////////////
+inline i32 SDFDistanceSq(sdf_offset offset)
+{
+    return offset.dX*offset.dX + offset.dY*offset.dY;
+}
+
+inline void CompareSDFOffset(sdf_offset *grid, i32 width, i32 x, i32 y, i32 offsetX, i32 offsetY)
+{
+    sdf_offset *cell = grid + y*width + x;
+    sdf_offset other = grid[(y + offsetY)*width + (x + offsetX)];
+    other.dX += offsetX;
+    other.dY += offsetY;
+    if(SDFDistanceSq(other) < SDFDistanceSq(*cell))
+        *cell = other;
+}
+
+/* NOTE(Joey):
+
+  8-point sequential euclidean distance transform (8SSEDT). Each cell 
+  holds the offset to its nearest seed cell (seed cells hold a zero 
+  offset, all others a 'far' offset). Two sweeps propagate the offsets 
+  of already visited neighbours: top-down and then bottom-up, each 
+  followed by a reverse horizontal sweep. The result is linear in the
+  number of texels which keeps baking an entire glyph range cheap.
+
+*/
+internal void GenerateDistanceGrid(sdf_offset *grid, i32 width, i32 height)
+{
+    // NOTE(Joey): pass 0: top to bottom
+    for(i32 y = 0; y < height; ++y)
+    {
+        for(i32 x = 0; x < width; ++x)
+        {
+            if(x > 0)                    CompareSDFOffset(grid, width, x, y, -1,  0);
+            if(y > 0)                    CompareSDFOffset(grid, width, x, y,  0, -1);
+            if(x > 0 && y > 0)           CompareSDFOffset(grid, width, x, y, -1, -1);
+            if(x < width - 1 && y > 0)   CompareSDFOffset(grid, width, x, y,  1, -1);
+        }
+        for(i32 x = width - 2; x >= 0; --x)
+            CompareSDFOffset(grid, width, x, y, 1, 0);
+    }
+    // NOTE(Joey): pass 1: bottom to top
+    for(i32 y = height - 1; y >= 0; --y)
+    {
+        for(i32 x = width - 1; x >= 0; --x)
+        {
+            if(x < width - 1)                     CompareSDFOffset(grid, width, x, y,  1, 0);
+            if(y < height - 1)                    CompareSDFOffset(grid, width, x, y,  0, 1);
+            if(x > 0 && y < height - 1)           CompareSDFOffset(grid, width, x, y, -1, 1);
+            if(x < width - 1 && y < height - 1)   CompareSDFOffset(grid, width, x, y,  1, 1);
+        }
+        for(i32 x = 1; x < width; ++x)
+            CompareSDFOffset(grid, width, x, y, -1, 0);
+    }
+}
+
+/* NOTE(Joey):
+
+  Bakes a glyph as a signed distance field: the glyph is rasterized once
+  by stb_truetype at bakeHeight pixels and padded by spread texels on each
+  side. Each texel's alpha then stores the distance to the glyph's edge
+  remapped from [-spread, spread] to [0, 255] with the edge at 128. The 
+  renderer reconstructs a sharp edge from this at any scale (see 
+  RenderTextureSDF_) so a single bake serves all text sizes.
+
+*/
+internal Texture LoadCharacterGlyphSDF(memory_arena *arena, game_font *font, u32 codePoint, 
+                                       r32 bakeHeight = 64.0f, r32 spread = 8.0f)
+{
+    stbtt_fontinfo fontInfo = GetArenaFontInfo(font, arena);
+    r32 pixelScale = stbtt_ScaleForPixelHeight(&fontInfo, bakeHeight);
+    
+    int x0, y0, x1, y1;
+    stbtt_GetCodepointBitmapBox(&fontInfo, codePoint, pixelScale, pixelScale, &x0, &y0, &x1, &y1);
+    i32 width  = x1 - x0;
+    i32 height = y1 - y0;
+    
+    i32 padding = CeilReal32ToInt32(spread);
+    i32 sdfWidth  = width  + 2*padding;
+    i32 sdfHeight = height + 2*padding;
+    Texture texture = CreateEmptyTexture(arena, (u16)sdfWidth, (u16)sdfHeight);
+    
+    // NOTE(Joey): coverage bitmap, stb's rasterizer buffers and the distance grids only live 
+    // for the duration of the bake
+    temp_memory scratchMemory = BeginTempMemory(arena);
+    u8 *monoBitmap = PushArray(arena, width*height, u8);
+    if(width > 0 && height > 0)
+        stbtt_MakeCodepointBitmap(&fontInfo, monoBitmap, width, height, width, pixelScale, pixelScale, codePoint);
+    
+    sdf_offset *distToOutside = PushArray(arena, sdfWidth*sdfHeight, sdf_offset);
+    sdf_offset *distToInside  = PushArray(arena, sdfWidth*sdfHeight, sdf_offset);
+    
+    const sdf_offset seed      = { 0, 0 };
+    const sdf_offset farOffset = { 9999, 9999 };
+    for(i32 y = 0; y < sdfHeight; ++y)
+    {
+        for(i32 x = 0; x < sdfWidth; ++x)
+        {
+            i32 glyphX = x - padding;
+            i32 glyphY = y - padding;
+            u8 coverage = 0;
+            if(glyphX >= 0 && glyphX < width && glyphY >= 0 && glyphY < height)
+                coverage = monoBitmap[glyphY*width + glyphX];
+            
+            b32 isInside = coverage >= 128;
+            distToOutside[y*sdfWidth + x] = isInside ? farOffset : seed;
+            distToInside[y*sdfWidth + x]  = isInside ? seed : farOffset;
+        }
+    }
+    GenerateDistanceGrid(distToOutside, sdfWidth, sdfHeight);
+    GenerateDistanceGrid(distToInside,  sdfWidth, sdfHeight);
+    
+    r32 invSpread = 1.0f / spread;
     u8 *destRow = (u8*)texture.Texels + (texture.Height-1)*texture.Pitch; // go bottom-up
-    for(u32 y = 0; y < texture.Height; ++y)
+    for(i32 y = 0; y < sdfHeight; ++y)
     {
         u32 *dest = (u32*)destRow;
-        for(u32 x = 0; x < texture.Width; ++x)
+        for(i32 x = 0; x < sdfWidth; ++x)
         {
-            u8 alpha = *source++;
-            u8 color = 0xFF;
-            *dest++ = (alpha << 24) |
-                      (color << 16) |
-                      (color <<  8) |
-                      (color <<  0);            
+            // NOTE(Joey): seed texels sit half a texel from the actual edge
+            i32 outsideSq = SDFDistanceSq(distToOutside[y*sdfWidth + x]);
+            i32 insideSq  = SDFDistanceSq(distToInside[y*sdfWidth + x]);
+            r32 distance = outsideSq > 0 ?  (SquareRoot((r32)outsideSq) - 0.5f) :
+                                           -(SquareRoot((r32)insideSq)  - 0.5f);
+            
+            r32 normalized = Clamp(-1.0f, 1.0f, distance*invSpread);
+            u32 alpha = RoundReal32ToUInt32(255.0f*(0.5f + 0.5f*normalized));
+            *dest++ = (alpha << 24) | 0x00FFFFFF;
         }
-        
         destRow -= texture.Pitch;
     }
     
-    stbtt_FreeBitmap(monoBitmap, 0);
+    EndTempMemory(scratchMemory);
     
     return texture;
 }
 
+internal void LoadFontGlyphsSDF(memory_arena *arena, game_font *font, r32 bakeHeight = 64.0f, r32 spread = 8.0f)
+{
+    TIMING_BLOCK();
+    font->IsSDF      = true;
+    font->BakeHeight = bakeHeight;
+    font->SDFSpread  = spread;
+    for(u32 i = 0; i < font->CodePointCount; ++i)
+        font->CodePoints[i] = LoadCharacterGlyphSDF(arena, font, '!' + i, bakeHeight, spread);
+    
+    // NOTE(Joey): stb's bitmap boxes are y-down from the baseline; the SDF's padding extends the glyph on all sides
+    stbtt_fontinfo fontInfo = GetArenaFontInfo(font, arena);
+    r32 pixelScale = stbtt_ScaleForPixelHeight(&fontInfo, bakeHeight);
+    r32 padding = (r32)CeilReal32ToInt32(spread);
+    font->GlyphOffsets  = PushArray(arena, font->CodePointCount, vector2D);
+    font->GlyphAdvances = PushArray(arena, font->CodePointCount, r32);
+    for(u32 i = 0; i < font->CodePointCount; ++i)
+    {
+        int advance, leftSideBearing, x0, y0, x1, y1;
+        stbtt_GetCodepointHMetrics(&fontInfo, '!' + i, &advance, &leftSideBearing);
+        stbtt_GetCodepointBitmapBox(&fontInfo, '!' + i, pixelScale, pixelScale, &x0, &y0, &x1, &y1);
+        font->GlyphOffsets[i]  = { (r32)x0 - padding, (r32)-y1 - padding };
+        font->GlyphAdvances[i] = pixelScale*(r32)advance;
+    }
+    int spaceAdvance, spaceBearing, ascent, descent, lineGap;
+    stbtt_GetCodepointHMetrics(&fontInfo, ' ', &spaceAdvance, &spaceBearing);
+    stbtt_GetFontVMetrics(&fontInfo, &ascent, &descent, &lineGap);
+    font->SpaceAdvance = pixelScale*(r32)spaceAdvance;
+    font->Ascent       = pixelScale*(r32)ascent;
+    font->Descent      = pixelScale*(r32)descent;
+    font->LineAdvance  = pixelScale*(r32)(ascent - descent + lineGap);
+}
+
+inline Texture* GetGlyph(game_font *font, u32 codePoint)
+{
+    Texture *result = 0;
+    if(codePoint >= '!' && codePoint - '!' < font->CodePointCount)
+        result = font->CodePoints + (codePoint - '!');
+    return result;
+}
+
 /* TODO(Joey):
   
   Write text functions here: pass in array of characters, read out their 
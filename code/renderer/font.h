@@ -12,6 +12,18 @@
 #ifndef FONT_H
 #define FONT_H
 
+/* NOTE(Joey):
+
+  Route stb_truetype's allocations through a memory_arena that is passed
+  in as stb's user context (stbtt_fontinfo::userdata). Frees are no-ops:
+  callers wrap stb calls in temp_memory and roll the arena back once done.
+  This keeps glyph baking off the heap entirely and lets every worker 
+  thread bake into its own arena given its own copy of the font info.
+
+*/
+#define STBTT_malloc(size, userData) PushSize_((memory_arena*)(userData), (size), 8)
+#define STBTT_free(ptr, userData)    ((void)(ptr), (void)(userData))
+
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "stb_truetype.h"
 
@@ -24,6 +36,27 @@ struct game_font
     
     u32 CodePointCount;
     Texture *CodePoints;
+    
+    // NOTE(Joey): signed distance field glyphs are baked once at BakeHeight pixels; the
+    // distance is stored in the texel's alpha channel over a range of SDFSpread texels.
+    b32 IsSDF;
+    r32 BakeHeight;
+    r32 SDFSpread;
+    
+    // NOTE(Joey): layout metrics at BakeHeight (see LoadFontGlyphsSDF): each glyph's bottom-left 
+    // corner relative to the pen on the baseline and the pen's advance; y points up.
+    vector2D *GlyphOffsets;
+    r32      *GlyphAdvances;
+    r32       SpaceAdvance;
+    r32       Ascent;
+    r32       Descent; // NOTE(Joey): negative; below the baseline
+};
+
+// NOTE(Joey): per-texel offset to nearest seed texel used for the distance transform
+struct sdf_offset
+{
+    i32 dX;
+    i32 dY;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Dynamic 2D point lights (explosions, muzzle flashes etc.). Lights are
+  pushed each frame into a light_list and accumulated in a lighting pass
+  that modulates the color target:
+
+      color = color * (ambient + sum(light.Color * attenuation))
+
+  with attenuation = (1 - d^2/r^2)^2 s.t. every light has a finite radius.
+
+  Evaluating every light for every pixel costs lights x pixels; instead each
+  light is first binned into the fixed RENDER_TILE_COUNT_X by _Y tiles its
+  bounding square overlaps. A tile then only evaluates the lights in its bin
+  and per row only the lights whose vertical extent covers that row.
+
+*/
+
+internal light_list *CreateLightList(memory_arena *arena, uint32 maxLightCount, vector3D ambient = { 1.0f, 1.0f, 1.0f })
+{
+    light_list *lights = PushStruct(arena, light_list);
+    lights->LightCount = 0;
+    lights->MaxLightCount = maxLightCount;
+    lights->Lights = PushArray(arena, maxLightCount, point_light);
+    lights->Ambient = ambient;
+
+    return lights;
+}
+
+internal void PushPointLight(light_list *lights,
+                             vector2D position,
+                             real32 radius,
+                             vector3D color,
+                             real32 intensity = 1.0f)
+{
+    if(radius > 0.0f && lights->LightCount < lights->MaxLightCount)
+    {
+        point_light *light = lights->Lights + lights->LightCount++;
+        light->Position = position;
+        light->Radius   = radius;
+        light->Color    = intensity*color;
+    }
+}
+
+internal void LightTile_(Texture *target, light_list *lights, light_bin *bin, rectangle2Di clipRect)
+{
+    // NOTE(Joey): nothing to do if no light reaches this tile and ambient leaves colors untouched
+    vector3D ambient = lights->Ambient;
+    if(bin->LightCount == 0 && ambient.r == 1.0f && ambient.g == 1.0f && ambient.b == 1.0f)
+        return;
+
+    __m128i endClipMask = _mm_set1_epi8(-1);
+    __m128i endClipMasks[] =
+    {
+        _mm_srli_si128(endClipMask, 0*4),
+        _mm_srli_si128(endClipMask, 3*4),
+        _mm_srli_si128(endClipMask, 2*4),
+        _mm_srli_si128(endClipMask, 1*4),
+    };
+    if(clipRect.MaxX & 3)
+    {
+        endClipMask = endClipMasks[clipRect.MaxX & 3];
+        clipRect.MaxX = (clipRect.MaxX & ~3) + 4;
+    }
+    Assert((clipRect.MinX & 3) == 0); // NOTE(Joey): tiles are aligned to 4 pixels
+
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 maxColorValue = _mm_set1_ps(255.0f);
+    const __m128i maskFF = _mm_set1_epi32(0xFF);
+    const __m128i maskAlpha = _mm_set1_epi32(0xFF000000);
+    const __m128 ambientR = _mm_set1_ps(ambient.r);
+    const __m128 ambientG = _mm_set1_ps(ambient.g);
+    const __m128 ambientB = _mm_set1_ps(ambient.b);
+
+    // NOTE(Joey): lights past the first 256 that reach a row are skipped on that row
+    uint32 rowLights[256];
+
+    uint8 *destRow = (uint8*)target->Texels + clipRect.MinY*target->Pitch + clipRect.MinX*sizeof(uint32);
+    for(int32 y = clipRect.MinY; y < clipRect.MaxY; ++y)
+    {
+        // NOTE(Joey): only keep the binned lights that reach this row
+        real32 pixelY = (real32)y;
+        uint32 rowLightCount = 0;
+        for(uint32 i = 0; i < bin->LightCount; ++i)
+        {
+            point_light *light = lights->Lights + bin->LightIndices[i];
+            real32 dY = pixelY - light->Position.y;
+            if(dY*dY < light->Radius*light->Radius && rowLightCount < ArrayCount(rowLights))
+                rowLights[rowLightCount++] = bin->LightIndices[i];
+        }
+
+        uint32 *dest = (uint32*)destRow;
+        __m128i clipMask = _mm_set1_epi8(-1);
+        __m128 pixelPosX = _mm_set_ps((real32)(clipRect.MinX + 3),
+                                      (real32)(clipRect.MinX + 2),
+                                      (real32)(clipRect.MinX + 1),
+                                      (real32)(clipRect.MinX + 0));
+        for(int32 x = clipRect.MinX; x < clipRect.MaxX; x += 4)
+        {
+            if(x + 4 >= clipRect.MaxX)
+                clipMask = endClipMask;
+
+            __m128 lightR = ambientR;
+            __m128 lightG = ambientG;
+            __m128 lightB = ambientB;
+            for(uint32 i = 0; i < rowLightCount; ++i)
+            {
+                point_light *light = lights->Lights + rowLights[i];
+                real32 dY = pixelY - light->Position.y;
+                real32 invRadiusSq = 1.0f / (light->Radius*light->Radius);
+
+                __m128 dX = _mm_sub_ps(pixelPosX, _mm_set1_ps(light->Position.x));
+                __m128 distSq = _mm_add_ps(_mm_mul_ps(dX, dX), _mm_set1_ps(dY*dY));
+                __m128 falloff = _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(distSq, _mm_set1_ps(invRadiusSq))), zero);
+                __m128 attenuation = _mm_mul_ps(falloff, falloff);
+
+                lightR = _mm_add_ps(lightR, _mm_mul_ps(attenuation, _mm_set1_ps(light->Color.r)));
+                lightG = _mm_add_ps(lightG, _mm_mul_ps(attenuation, _mm_set1_ps(light->Color.g)));
+                lightB = _mm_add_ps(lightB, _mm_mul_ps(attenuation, _mm_set1_ps(light->Color.b)));
+            }
+
+            // NOTE(Joey): modulate destination colors; alpha is left untouched
+            __m128i originalDest = _mm_loadu_si128((__m128i *)dest);
+            __m128 destR = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 16), maskFF));
+            __m128 destG = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 8), maskFF));
+            __m128 destB = _mm_cvtepi32_ps(_mm_and_si128(originalDest, maskFF));
+
+            destR = _mm_min_ps(_mm_mul_ps(destR, lightR), maxColorValue);
+            destG = _mm_min_ps(_mm_mul_ps(destG, lightG), maxColorValue);
+            destB = _mm_min_ps(_mm_mul_ps(destB, lightB), maxColorValue);
+
+            __m128i out = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(destR), 16),
+                                                    _mm_slli_epi32(_mm_cvtps_epi32(destG), 8)),
+                                       _mm_or_si128(_mm_cvtps_epi32(destB),
+                                                    _mm_and_si128(originalDest, maskAlpha)));
+            // NOTE(Joey): the last group of an unaligned row overlaps the next row, which belongs to
+            // another tile (thread); only write the masked pixels there to avoid clobbering it.
+            if(x + 4 >= clipRect.MaxX)
+                _mm_maskmoveu_si128(out, clipMask, (char*)dest);
+            else
+                _mm_storeu_si128((__m128i *)dest, out);
+
+            pixelPosX = _mm_add_ps(pixelPosX, four);
+            dest += 4;
+        }
+        destRow += target->Pitch;
+    }
+}
+
+struct TiledLightingData
+{
+    light_list  *Lights;
+    light_bin   *Bin;
+    Texture     *Target;
+    rectangle2Di ClipRect;
+};
+
+void DoTiledLightingWork(platform_work_queue *queue, void *data)
+{
+    TiledLightingData *tiledData = (TiledLightingData*)data;
+    LightTile_(tiledData->Target, tiledData->Lights, tiledData->Bin, tiledData->ClipRect);
+}
+
+internal void LightingPass(platform_work_queue *workQueue, memory_arena *arena, light_list *lights, Texture *target)
+{
+    TIMING_BLOCK();
+    Assert(target->Format == TEXTURE_FORMAT_ARGB32);
+    temp_memory lightingMemory = BeginTempMemory(arena);
+
+    // NOTE(Joey): bin lights per tile; a light's screen bounds are tested against each tile's clip rect
+    const uint32 tileCount = RENDER_TILE_COUNT_X * RENDER_TILE_COUNT_Y;
+    light_bin bins[tileCount];
+    rectangle2Di clipRects[tileCount];
+    for(uint8 y = 0; y < RENDER_TILE_COUNT_Y; ++y)
+    {
+        for(uint8 x = 0; x < RENDER_TILE_COUNT_X; ++x)
+        {
+            uint32 tileIndex = y*RENDER_TILE_COUNT_X + x;
+            clipRects[tileIndex] = GetRenderTileClipRect(target, x, y);
+            bins[tileIndex].LightCount = 0;
+            bins[tileIndex].LightIndices = PushArray(arena, lights->LightCount, uint32);
+        }
+    }
+    for(uint32 i = 0; i < lights->LightCount; ++i)
+    {
+        point_light *light = lights->Lights + i;
+        rectangle2Di bounds;
+        bounds.MinX = FloorReal32ToInt32(light->Position.x - light->Radius);
+        bounds.MinY = FloorReal32ToInt32(light->Position.y - light->Radius);
+        bounds.MaxX = CeilReal32ToInt32(light->Position.x + light->Radius);
+        bounds.MaxY = CeilReal32ToInt32(light->Position.y + light->Radius);
+        for(uint32 tileIndex = 0; tileIndex < tileCount; ++tileIndex)
+        {
+            if(HasArea(Intersect(bounds, clipRects[tileIndex])))
+            {
+                light_bin *bin = bins + tileIndex;
+                bin->LightIndices[bin->LightCount++] = i;
+            }
+        }
+    }
+
+    TiledLightingData tiledData[tileCount];
+    for(uint32 tileIndex = 0; tileIndex < tileCount; ++tileIndex)
+    {
+        TiledLightingData *data = tiledData + tileIndex;
+        data->Lights   = lights;
+        data->Bin      = bins + tileIndex;
+        data->Target   = target;
+        data->ClipRect = clipRects[tileIndex];
+
+        if(workQueue)
+            PlatformAPI.AddWorkEntry(workQueue, DoTiledLightingWork, data);
+        else
+            DoTiledLightingWork(0, data);
+    }
+    if(workQueue)
+        PlatformAPI.CompleteAllWork(workQueue);
+
+    EndTempMemory(lightingMemory);
+}
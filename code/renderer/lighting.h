@@ -0,0 +1,39 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef LIGHTING_H
+#define LIGHTING_H
+
+// NOTE(Joey): screen-space point light; Color is pre-multiplied by the light's intensity
+struct point_light
+{
+    vector2D Position;
+    real32   Radius;
+    vector3D Color;
+};
+
+struct light_list
+{
+    uint32 LightCount;
+    uint32 MaxLightCount;
+    point_light *Lights;
+
+    vector3D Ambient; // NOTE(Joey): light every pixel receives; lights are added on top
+};
+
+// NOTE(Joey): the indices of the lights that reach a single render tile
+struct light_bin
+{
+    uint32  LightCount;
+    uint32 *LightIndices;
+};
+
+#endif
@@ -0,0 +1,334 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Particles are simulated in world space (meters) in SoA arrays s.t. they can
+  be integrated with SIMD, 8 particles per iteration. Dead particles are
+  removed by moving the last live particle in their place, keeping the live
+  range packed.
+
+  Pushing a RenderQueueItem per particle doesn't scale, so each frame a
+  particle system is converted into a single particle_render_batch: screen
+  positions and faded colors are calculated with SIMD and each particle is
+  binned into every render tile its sprite overlaps. A single queue item then
+  references the batch and each tile only draws its own bin with an additive
+  radial point-sprite kernel.
+
+*/
+
+internal void InitParticleSystem(particle_system *system, memory_arena *arena, uint32 maxParticleCount, real32 drag = 1.0f)
+{
+    maxParticleCount = ((maxParticleCount + PARTICLE_SIMD_WIDTH - 1) / PARTICLE_SIMD_WIDTH) * PARTICLE_SIMD_WIDTH;
+
+    system->ParticleCount    = 0;
+    system->MaxParticleCount = maxParticleCount;
+    system->Drag             = drag;
+
+    system->PositionX   = PushArray(arena, maxParticleCount, real32, 16);
+    system->PositionY   = PushArray(arena, maxParticleCount, real32, 16);
+    system->VelocityX   = PushArray(arena, maxParticleCount, real32, 16);
+    system->VelocityY   = PushArray(arena, maxParticleCount, real32, 16);
+    system->Life        = PushArray(arena, maxParticleCount, real32, 16);
+    system->InvLifetime = PushArray(arena, maxParticleCount, real32, 16);
+    system->ColorR      = PushArray(arena, maxParticleCount, real32, 16);
+    system->ColorG      = PushArray(arena, maxParticleCount, real32, 16);
+    system->ColorB      = PushArray(arena, maxParticleCount, real32, 16);
+}
+
+internal void SpawnParticleBurst(particle_system *system,
+                                 random_series *series,
+                                 vector2D position,
+                                 uint32 count,
+                                 real32 minSpeed, real32 maxSpeed,
+                                 real32 minLife,  real32 maxLife,
+                                 vector3D color)
+{
+    for(uint32 i = 0; i < count && system->ParticleCount < system->MaxParticleCount; ++i)
+    {
+        uint32 index = system->ParticleCount++;
+
+        real32 angle = RandomBetween(series, 0.0f, 2.0f*Pi32);
+        real32 speed = RandomBetween(series, minSpeed, maxSpeed);
+        real32 life  = RandomBetween(series, minLife, maxLife);
+        real32 tint  = RandomBetween(series, 0.6f, 1.0f);
+
+        system->PositionX[index]   = position.x;
+        system->PositionY[index]   = position.y;
+        system->VelocityX[index]   = speed*(real32)cos(angle);
+        system->VelocityY[index]   = speed*(real32)sin(angle);
+        system->Life[index]        = life;
+        system->InvLifetime[index] = 1.0f / life;
+        system->ColorR[index]      = tint*color.r;
+        system->ColorG[index]      = tint*color.g;
+        system->ColorB[index]      = tint*color.b;
+    }
+}
+
+inline void IntegrateParticles4x(particle_system *system, uint32 index, __m128 dt_4x, __m128 drag_4x)
+{
+    __m128 velocityX = _mm_mul_ps(_mm_load_ps(system->VelocityX + index), drag_4x);
+    __m128 velocityY = _mm_mul_ps(_mm_load_ps(system->VelocityY + index), drag_4x);
+    __m128 positionX = _mm_add_ps(_mm_load_ps(system->PositionX + index), _mm_mul_ps(velocityX, dt_4x));
+    __m128 positionY = _mm_add_ps(_mm_load_ps(system->PositionY + index), _mm_mul_ps(velocityY, dt_4x));
+    __m128 life      = _mm_sub_ps(_mm_load_ps(system->Life + index), dt_4x);
+
+    _mm_store_ps(system->VelocityX + index, velocityX);
+    _mm_store_ps(system->VelocityY + index, velocityY);
+    _mm_store_ps(system->PositionX + index, positionX);
+    _mm_store_ps(system->PositionY + index, positionY);
+    _mm_store_ps(system->Life + index, life);
+}
+
+internal void UpdateParticles(particle_system *system, real32 dt)
+{
+    TIMING_BLOCK();
+
+    // NOTE(Joey): integrate 8 particles per iteration; arrays are padded to a multiple of 8 so
+    // the tail may integrate (unused) particles beyond ParticleCount.
+    __m128 dt_4x   = _mm_set1_ps(dt);
+    __m128 drag_4x = _mm_set1_ps(Max(1.0f - system->Drag*dt, 0.0f));
+    for(uint32 i = 0; i < system->ParticleCount; i += PARTICLE_SIMD_WIDTH)
+    {
+        IntegrateParticles4x(system, i + 0, dt_4x, drag_4x);
+        IntegrateParticles4x(system, i + 4, dt_4x, drag_4x);
+    }
+
+    // NOTE(Joey): remove dead particles by moving the last live particle in their place
+    uint32 i = 0;
+    while(i < system->ParticleCount)
+    {
+        if(system->Life[i] > 0.0f)
+        {
+            ++i;
+            continue;
+        }
+        uint32 last = --system->ParticleCount;
+        system->PositionX[i]   = system->PositionX[last];
+        system->PositionY[i]   = system->PositionY[last];
+        system->VelocityX[i]   = system->VelocityX[last];
+        system->VelocityY[i]   = system->VelocityY[last];
+        system->Life[i]        = system->Life[last];
+        system->InvLifetime[i] = system->InvLifetime[last];
+        system->ColorR[i]      = system->ColorR[last];
+        system->ColorG[i]      = system->ColorG[last];
+        system->ColorB[i]      = system->ColorB[last];
+    }
+}
+
+// NOTE(Joey): screenOrigin is the pixel position of the world origin; radius is given in pixels
+internal particle_render_batch *PrepareParticleBatch(memory_arena *arena,
+                                                     particle_system *system,
+                                                     Texture *target,
+                                                     vector2D screenOrigin,
+                                                     real32 metersToPixels,
+                                                     real32 radius)
+{
+    TIMING_BLOCK();
+
+    uint32 count = system->ParticleCount;
+    uint32 paddedCount = ((count + PARTICLE_SIMD_WIDTH - 1) / PARTICLE_SIMD_WIDTH) * PARTICLE_SIMD_WIDTH;
+
+    particle_render_batch *batch = PushStruct(arena, particle_render_batch);
+    batch->ParticleCount = count;
+    batch->Radius        = radius;
+    batch->ScreenX       = PushArray(arena, paddedCount, real32, 16);
+    batch->ScreenY       = PushArray(arena, paddedCount, real32, 16);
+    batch->Colors        = PushArray(arena, paddedCount, uint32, 16);
+
+    // NOTE(Joey): transform to screen-space and fade colors by remaining life
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 maxColorValue = _mm_set1_ps(255.0f);
+    const __m128 originX = _mm_set1_ps(screenOrigin.x);
+    const __m128 originY = _mm_set1_ps(screenOrigin.y);
+    const __m128 scale = _mm_set1_ps(metersToPixels);
+    for(uint32 i = 0; i < paddedCount; i += 4)
+    {
+        _mm_store_ps(batch->ScreenX + i, _mm_add_ps(originX, _mm_mul_ps(scale, _mm_load_ps(system->PositionX + i))));
+        _mm_store_ps(batch->ScreenY + i, _mm_add_ps(originY, _mm_mul_ps(scale, _mm_load_ps(system->PositionY + i))));
+
+        __m128 fade = _mm_mul_ps(_mm_load_ps(system->Life + i), _mm_load_ps(system->InvLifetime + i));
+        fade = _mm_mul_ps(_mm_min_ps(_mm_max_ps(fade, zero), one), maxColorValue);
+        __m128 r = _mm_min_ps(_mm_mul_ps(fade, _mm_load_ps(system->ColorR + i)), maxColorValue);
+        __m128 g = _mm_min_ps(_mm_mul_ps(fade, _mm_load_ps(system->ColorG + i)), maxColorValue);
+        __m128 b = _mm_min_ps(_mm_mul_ps(fade, _mm_load_ps(system->ColorB + i)), maxColorValue);
+        __m128i color = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(r), 16),
+                                                  _mm_slli_epi32(_mm_cvtps_epi32(g), 8)),
+                                     _mm_cvtps_epi32(b));
+        _mm_store_si128((__m128i*)(batch->Colors + i), color);
+    }
+
+    // NOTE(Joey): bin particles per render tile; first count to size the bins, then fill
+    batch->BinCount = RENDER_TILE_COUNT_X * RENDER_TILE_COUNT_Y;
+    batch->Bins = PushArray(arena, batch->BinCount, particle_bin);
+    for(uint8 y = 0; y < RENDER_TILE_COUNT_Y; ++y)
+    {
+        for(uint8 x = 0; x < RENDER_TILE_COUNT_X; ++x)
+        {
+            particle_bin *bin = batch->Bins + y*RENDER_TILE_COUNT_X + x;
+            bin->Rect = GetRenderTileClipRect(target, x, y);
+            bin->ParticleCount = 0;
+        }
+    }
+    // NOTE(Joey): calculate the range of tiles each particle overlaps, packed as 4 bytes:
+    // minX | maxX << 8 | minY << 16 | maxY << 24; culled particles get an empty range.
+    real32 invTileWidth  = 1.0f / (real32)(batch->Bins[0].Rect.MaxX - batch->Bins[0].Rect.MinX);
+    real32 invTileHeight = 1.0f / (real32)(batch->Bins[0].Rect.MaxY - batch->Bins[0].Rect.MinY);
+    const __m128 radius_4x = _mm_set1_ps(radius);
+    const __m128 invTileWidth_4x = _mm_set1_ps(invTileWidth);
+    const __m128 invTileHeight_4x = _mm_set1_ps(invTileHeight);
+    const __m128 maxTileX = _mm_set1_ps((real32)(RENDER_TILE_COUNT_X - 1));
+    const __m128 maxTileY = _mm_set1_ps((real32)(RENDER_TILE_COUNT_Y - 1));
+    const __m128 screenMaxX = _mm_set1_ps((real32)target->Width);
+    const __m128 screenMaxY = _mm_set1_ps((real32)target->Height);
+    const __m128i emptyRange = _mm_set1_epi32(0x00FF00FF);
+    
+    uint32 *tileRanges = PushArray(arena, paddedCount, uint32, 16);
+    for(uint32 i = 0; i < paddedCount; i += 4)
+    {
+        __m128 x = _mm_load_ps(batch->ScreenX + i);
+        __m128 y = _mm_load_ps(batch->ScreenY + i);
+        __m128 minX = _mm_sub_ps(x, radius_4x);
+        __m128 maxX = _mm_add_ps(x, radius_4x);
+        __m128 minY = _mm_sub_ps(y, radius_4x);
+        __m128 maxY = _mm_add_ps(y, radius_4x);
+        __m128 visible = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(maxX, zero), _mm_cmplt_ps(minX, screenMaxX)),
+                                    _mm_and_ps(_mm_cmpgt_ps(maxY, zero), _mm_cmplt_ps(minY, screenMaxY)));
+        
+        // NOTE(Joey): bounds are positive after clamping so truncation equals floor; the last tile 
+        // row/column also holds the remainder of a target that isn't a multiple of the tile size
+        __m128i tileMinX = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(minX, invTileWidth_4x), zero), maxTileX));
+        __m128i tileMaxX = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(maxX, invTileWidth_4x), zero), maxTileX));
+        __m128i tileMinY = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(minY, invTileHeight_4x), zero), maxTileY));
+        __m128i tileMaxY = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(maxY, invTileHeight_4x), zero), maxTileY));
+        __m128i range = _mm_or_si128(_mm_or_si128(tileMinX, _mm_slli_epi32(tileMaxX, 8)),
+                                     _mm_or_si128(_mm_slli_epi32(tileMinY, 16), _mm_slli_epi32(tileMaxY, 24)));
+        range = _mm_or_si128(_mm_and_si128(_mm_castps_si128(visible), range), 
+                             _mm_andnot_si128(_mm_castps_si128(visible), emptyRange));
+        _mm_store_si128((__m128i*)(tileRanges + i), range);
+    }
+
+    // NOTE(Joey): bin particles; first count to size the bins, then fill
+    for(int pass = 0; pass < 2; ++pass)
+    {
+        if(pass == 1)
+        {
+            for(uint32 i = 0; i < batch->BinCount; ++i)
+            {
+                particle_bin *bin = batch->Bins + i;
+                bin->ParticleIndices = PushArray(arena, bin->ParticleCount, uint32);
+                bin->ParticleCount = 0;
+            }
+        }
+        for(uint32 i = 0; i < count; ++i)
+        {
+            uint32 range = tileRanges[i];
+            uint32 tileMaxY = (range >> 24) & 0xFF;
+            uint32 tileMaxX = (range >>  8) & 0xFF;
+            for(uint32 tileY = (range >> 16) & 0xFF; tileY <= tileMaxY; ++tileY)
+            {
+                for(uint32 tileX = range & 0xFF; tileX <= tileMaxX; ++tileX)
+                {
+                    particle_bin *bin = batch->Bins + tileY*RENDER_TILE_COUNT_X + tileX;
+                    if(pass == 1)
+                        bin->ParticleIndices[bin->ParticleCount] = i;
+                    bin->ParticleCount++;
+                }
+            }
+        }
+    }
+
+    return batch;
+}
+
+internal void RenderParticles_(Texture *target, particle_render_batch *batch, rectangle2Di clipRect)
+{
+    TIMING_BLOCK();
+
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128i laneIndices = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128 invRadiusSq = _mm_set1_ps(1.0f / (batch->Radius*batch->Radius));
+    const __m128i maskFF = _mm_set1_epi32(0xFF);
+
+    for(uint32 binIndex = 0; binIndex < batch->BinCount; ++binIndex)
+    {
+        // NOTE(Joey): a particle is stored in each bin it overlaps; only draw the part of it
+        // inside the bin s.t. it's never drawn twice if the clip rect spans multiple bins.
+        particle_bin *bin = batch->Bins + binIndex;
+        rectangle2Di binClipRect = Intersect(bin->Rect, clipRect);
+        if(!HasArea(binClipRect))
+            continue;
+
+        for(uint32 i = 0; i < bin->ParticleCount; ++i)
+        {
+            uint32 particleIndex = bin->ParticleIndices[i];
+            real32 centerX = batch->ScreenX[particleIndex];
+            real32 centerY = batch->ScreenY[particleIndex];
+
+            rectangle2Di fillRect;
+            fillRect.MinX = FloorReal32ToInt32(centerX - batch->Radius);
+            fillRect.MinY = FloorReal32ToInt32(centerY - batch->Radius);
+            fillRect.MaxX = CeilReal32ToInt32(centerX + batch->Radius);
+            fillRect.MaxY = CeilReal32ToInt32(centerY + batch->Radius);
+            fillRect = Intersect(fillRect, binClipRect);
+            if(!HasArea(fillRect))
+                continue;
+
+            __m128i color = _mm_set1_epi32(batch->Colors[particleIndex]);
+            __m128 colorR = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(color, 16), maskFF));
+            __m128 colorG = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(color, 8), maskFF));
+            __m128 colorB = _mm_cvtepi32_ps(_mm_and_si128(color, maskFF));
+            __m128 startX = _mm_sub_ps(_mm_add_ps(_mm_set1_ps((real32)fillRect.MinX), laneOffsets), _mm_set1_ps(centerX));
+            __m128i maxX_4x = _mm_set1_epi32(fillRect.MaxX);
+
+            uint8 *row = (uint8*)target->Texels + fillRect.MinY*target->Pitch + fillRect.MinX*sizeof(uint32);
+            for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y)
+            {
+                real32 dY = (real32)y + 0.5f - centerY;
+                __m128 dYSq = _mm_set1_ps(dY*dY);
+                __m128 dX = startX;
+
+                uint32 *dest = (uint32*)row;
+                for(int32 x = fillRect.MinX; x < fillRect.MaxX; x += 4)
+                {
+                    // NOTE(Joey): smooth radial falloff, added with saturation
+                    __m128 distSq = _mm_add_ps(_mm_mul_ps(dX, dX), dYSq);
+                    __m128 falloff = _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(distSq, invRadiusSq)), zero);
+                    falloff = _mm_mul_ps(falloff, falloff);
+                    __m128i contribution = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(falloff, colorR)), 16),
+                                                                     _mm_slli_epi32(_mm_cvtps_epi32(_mm_mul_ps(falloff, colorG)), 8)),
+                                                        _mm_cvtps_epi32(_mm_mul_ps(falloff, colorB)));
+                    __m128i out = _mm_adds_epu8(_mm_loadu_si128((__m128i*)dest), contribution);
+
+                    // NOTE(Joey): lanes beyond the fill rect lie outside the sprite radius and add 0, but
+                    // may belong to another tile (thread) if they cross the clip rect; don't touch those.
+                    if(x + 4 <= binClipRect.MaxX)
+                    {
+                        _mm_storeu_si128((__m128i*)dest, out);
+                    }
+                    else
+                    {
+                        __m128i writeMask = _mm_cmplt_epi32(_mm_add_epi32(_mm_set1_epi32(x), laneIndices), maxX_4x);
+                        _mm_maskmoveu_si128(out, writeMask, (char*)dest);
+                    }
+
+                    dX = _mm_add_ps(dX, _mm_set1_ps(4.0f));
+                    dest += 4;
+                }
+                row += target->Pitch;
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+// NOTE(Joey): particles are integrated 8 at a time; keep capacity a multiple of that
+const uint32 PARTICLE_SIMD_WIDTH = 8;
+
+// NOTE(Joey): structure of arrays; live particles are kept packed in [0, ParticleCount)
+struct particle_system
+{
+    uint32 ParticleCount;
+    uint32 MaxParticleCount;
+
+    real32 *PositionX;
+    real32 *PositionY;
+    real32 *VelocityX;
+    real32 *VelocityY;
+    real32 *Life;        // NOTE(Joey): remaining life in seconds
+    real32 *InvLifetime; // NOTE(Joey): 1 / initial life; used to fade particles out
+    real32 *ColorR;
+    real32 *ColorG;
+    real32 *ColorB;
+
+    real32 Drag;
+};
+
+// NOTE(Joey): indices of the particles whose sprite overlaps Rect
+struct particle_bin
+{
+    rectangle2Di Rect;
+    uint32       ParticleCount;
+    uint32      *ParticleIndices;
+};
+
+// NOTE(Joey): per-frame screen-space snapshot of a particle system, binned per render tile
+struct particle_render_batch
+{
+    uint32  ParticleCount;
+    real32 *ScreenX;
+    real32 *ScreenY;
+    uint32 *Colors; // NOTE(Joey): 0x00RRGGBB, faded by remaining life
+    real32  Radius; // NOTE(Joey): in pixels
+
+    uint32       BinCount;
+    particle_bin *Bins;
+};
+
+#endif
@@ -0,0 +1,450 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Full-screen post-processing; runs after RenderPass on the render target
+  as a whole. Every effect is split into strips of rows (columns for the
+  vertical blur) which are dispatched on the work queue; effects depend on
+  each other's output so we complete all work between effects. All
+  intermediate buffers are pushed onto the (transient) arena passed in.
+
+  Bloom:       bright-pass + downsample -> horizontal blur -> vertical blur
+               -> bilinear upsample and (saturated) add onto the target.
+  Vignette:    darkens towards the screen corners in 8.8 fixed point.
+  Color grade: per-channel tone curve lookup (see color_grade_lut).
+
+  Each effect is wrapped in its own TIMING_BLOCK on the dispatching thread
+  s.t. its full (multithreaded) cost shows up as a separate timing record.
+
+*/
+
+// NOTE(Joey): unpacks a single 0xAARRGGBB pixel to (b, g, r, a) floats
+inline __m128 UnpackPixel(u32 pixel)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i unpacked = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pixel), zero), zero);
+    return _mm_cvtepi32_ps(unpacked);
+}
+
+inline u32 PackPixel(__m128 color)
+{
+    __m128i packed = _mm_cvtps_epi32(color);
+    packed = _mm_packs_epi32(packed, packed);
+    packed = _mm_packus_epi16(packed, packed);
+    return (u32)_mm_cvtsi128_si32(packed);
+}
+
+// NOTE(Joey): 4 pixels w/ a register per channel; the blur processes 4 pixels per iteration this way
+struct pixel_4x
+{
+    __m128 B;
+    __m128 G;
+    __m128 R;
+    __m128 A;
+};
+
+inline pixel_4x UnpackPixels_4x(__m128i pixels)
+{
+    const __m128i maskFF = _mm_set1_epi32(0xFF);
+    pixel_4x result;
+    result.B = _mm_cvtepi32_ps(_mm_and_si128(pixels, maskFF));
+    result.G = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), maskFF));
+    result.R = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), maskFF));
+    result.A = _mm_cvtepi32_ps(_mm_srli_epi32(pixels, 24));
+    return result;
+}
+
+// NOTE(Joey): rounds and saturates the same as PackPixel
+inline __m128i PackPixels_4x(pixel_4x pixels)
+{
+    __m128i br = _mm_packs_epi32(_mm_cvtps_epi32(pixels.B), _mm_cvtps_epi32(pixels.R));
+    __m128i ga = _mm_packs_epi32(_mm_cvtps_epi32(pixels.G), _mm_cvtps_epi32(pixels.A));
+    __m128i bgLanes = _mm_unpacklo_epi16(br, ga); // b0 g0 b1 g1 ...
+    __m128i raLanes = _mm_unpackhi_epi16(br, ga); // r0 a0 r1 a1 ...
+    return _mm_packus_epi16(_mm_unpacklo_epi32(bgLanes, raLanes), _mm_unpackhi_epi32(bgLanes, raLanes));
+}
+
+inline void AccumulateBlurTap_4x(pixel_4x *sum, __m128 weight, __m128i pixels)
+{
+    pixel_4x texels = UnpackPixels_4x(pixels);
+    sum->B = _mm_add_ps(sum->B, _mm_mul_ps(weight, texels.B));
+    sum->G = _mm_add_ps(sum->G, _mm_mul_ps(weight, texels.G));
+    sum->R = _mm_add_ps(sum->R, _mm_mul_ps(weight, texels.R));
+    sum->A = _mm_add_ps(sum->A, _mm_mul_ps(weight, texels.A));
+}
+
+inline u32 ClampIndex(i32 index, u32 count)
+{
+    if(index < 0) index = 0;
+    if(index >= (i32)count) index = (i32)count - 1;
+    return (u32)index;
+}
+
+internal void GenerateBlurWeights(r32 *weights, i32 radius)
+{
+    r32 sigma = 0.5f*(r32)radius;
+    r32 total = 0.0f;
+    for(i32 i = -radius; i <= radius; ++i)
+    {
+        r32 weight = expf(-(r32)(i*i) / (2.0f*sigma*sigma));
+        weights[i + radius] = weight;
+        total += weight;
+    }
+    for(i32 i = 0; i < 2*radius + 1; ++i)
+        weights[i] /= total;
+}
+
+internal void GenerateColorGradeLUT(color_grade_lut *lut, r32 contrast, vector4D tint)
+{
+    for(u32 i = 0; i < 256; ++i)
+    {
+        r32 value = ((r32)i / 255.0f - 0.5f)*contrast + 0.5f;
+        lut->R[i] = (u8)RoundReal32ToUInt32(255.0f*Clamp01(value*tint.r));
+        lut->G[i] = (u8)RoundReal32ToUInt32(255.0f*Clamp01(value*tint.g));
+        lut->B[i] = (u8)RoundReal32ToUInt32(255.0f*Clamp01(value*tint.b));
+    }
+}
+
+///////////////////////////////////////////////
+//      STRIP KERNELS
+///////////////////////////////////////////////
+internal void BloomDownsample(Texture *source, Texture *dest, r32 threshold, u32 beginRow, u32 endRow)
+{
+    // NOTE(Joey): average the 2x2 texels at the center of each source block, then only keep
+    // what lies above the threshold; alpha is cleared s.t. the composite leaves it intact.
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 threshold_4x = _mm_set1_ps(255.0f*threshold);
+    const __m128 colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+    u32 sourcePitch = source->Pitch / sizeof(u32);
+    for(u32 y = beginRow; y < endRow; ++y)
+    {
+        u32 *row0 = source->Texels + ClampIndex(y*BLOOM_DOWNSAMPLE + 1, source->Height)*sourcePitch;
+        u32 *row1 = source->Texels + ClampIndex(y*BLOOM_DOWNSAMPLE + 2, source->Height)*sourcePitch;
+        u32 *out = (u32*)((u8*)dest->Texels + y*dest->Pitch);
+        for(u32 x = 0; x < dest->Width; ++x)
+        {
+            u32 x0 = ClampIndex(x*BLOOM_DOWNSAMPLE + 1, source->Width);
+            u32 x1 = ClampIndex(x*BLOOM_DOWNSAMPLE + 2, source->Width);
+            __m128 sum = _mm_add_ps(_mm_add_ps(UnpackPixel(row0[x0]), UnpackPixel(row0[x1])),
+                                    _mm_add_ps(UnpackPixel(row1[x0]), UnpackPixel(row1[x1])));
+            __m128 bright = _mm_max_ps(_mm_sub_ps(_mm_mul_ps(sum, quarter), threshold_4x), zero);
+            *out++ = PackPixel(_mm_and_ps(bright, colorMask));
+        }
+    }
+}
+
+// NOTE(Joey): single pixel of the horizontal blur; for the texels whose taps fall off the row's edges
+inline u32 BlurPixelHorizontal(u32 *in, i32 x, u32 width, r32 *weights)
+{
+    __m128 sum = _mm_set1_ps(0.0f);
+    for(i32 k = -BLOOM_BLUR_RADIUS; k <= BLOOM_BLUR_RADIUS; ++k)
+    {
+        __m128 texel = UnpackPixel(in[ClampIndex(x + k, width)]);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k + BLOOM_BLUR_RADIUS]), texel));
+    }
+    return PackPixel(sum);
+}
+
+internal void BloomBlurHorizontal(Texture *source, Texture *dest, u32 beginRow, u32 endRow)
+{
+    r32 weights[2*BLOOM_BLUR_RADIUS + 1];
+    GenerateBlurWeights(weights, BLOOM_BLUR_RADIUS);
+    __m128 weights_4x[2*BLOOM_BLUR_RADIUS + 1];
+    for(i32 k = 0; k < 2*BLOOM_BLUR_RADIUS + 1; ++k)
+        weights_4x[k] = _mm_set1_ps(weights[k]);
+
+    // NOTE(Joey): 4 pixels at a time where all their taps lie within the row; the edges clamp per pixel
+    i32 width = (i32)source->Width;
+    i32 beginX = Minimum(BLOOM_BLUR_RADIUS, width);
+    i32 endX = beginX;
+    if(width - BLOOM_BLUR_RADIUS - beginX >= 4)
+        endX = beginX + ((width - BLOOM_BLUR_RADIUS - beginX) & ~3);
+
+    for(u32 y = beginRow; y < endRow; ++y)
+    {
+        u32 *in  = (u32*)((u8*)source->Texels + y*source->Pitch);
+        u32 *out = (u32*)((u8*)dest->Texels + y*dest->Pitch);
+        for(i32 x = 0; x < beginX; ++x)
+            out[x] = BlurPixelHorizontal(in, x, source->Width, weights);
+        for(i32 x = beginX; x < endX; x += 4)
+        {
+            pixel_4x sum = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+            for(i32 k = -BLOOM_BLUR_RADIUS; k <= BLOOM_BLUR_RADIUS; ++k)
+                AccumulateBlurTap_4x(&sum, weights_4x[k + BLOOM_BLUR_RADIUS], _mm_loadu_si128((__m128i*)(in + x + k)));
+            _mm_storeu_si128((__m128i*)(out + x), PackPixels_4x(sum));
+        }
+        for(i32 x = endX; x < width; ++x)
+            out[x] = BlurPixelHorizontal(in, x, source->Width, weights);
+    }
+}
+
+internal void BloomBlurVertical(Texture *source, Texture *dest, u32 beginColumn, u32 endColumn)
+{
+    r32 weights[2*BLOOM_BLUR_RADIUS + 1];
+    GenerateBlurWeights(weights, BLOOM_BLUR_RADIUS);
+    __m128 weights_4x[2*BLOOM_BLUR_RADIUS + 1];
+    for(i32 k = 0; k < 2*BLOOM_BLUR_RADIUS + 1; ++k)
+        weights_4x[k] = _mm_set1_ps(weights[k]);
+
+    // NOTE(Joey): walk the column strip row by row to keep memory access linear; 4 columns at a time
+    u32 end4 = beginColumn + ((endColumn - beginColumn) & ~3);
+    for(i32 y = 0; y < (i32)source->Height; ++y)
+    {
+        u32 *in[2*BLOOM_BLUR_RADIUS + 1];
+        for(i32 k = -BLOOM_BLUR_RADIUS; k <= BLOOM_BLUR_RADIUS; ++k)
+            in[k + BLOOM_BLUR_RADIUS] = (u32*)((u8*)source->Texels + ClampIndex(y + k, source->Height)*source->Pitch);
+
+        u32 *out = (u32*)((u8*)dest->Texels + y*dest->Pitch);
+        for(u32 x = beginColumn; x < end4; x += 4)
+        {
+            pixel_4x sum = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+            for(i32 k = 0; k < 2*BLOOM_BLUR_RADIUS + 1; ++k)
+                AccumulateBlurTap_4x(&sum, weights_4x[k], _mm_loadu_si128((__m128i*)(in[k] + x)));
+            _mm_storeu_si128((__m128i*)(out + x), PackPixels_4x(sum));
+        }
+        for(u32 x = end4; x < endColumn; ++x)
+        {
+            __m128 sum = _mm_set1_ps(0.0f);
+            for(i32 k = 0; k < 2*BLOOM_BLUR_RADIUS + 1; ++k)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), UnpackPixel(in[k][x])));
+            out[x] = PackPixel(sum);
+        }
+    }
+}
+
+internal void BloomComposite(Texture *bloom, Texture *target, r32 intensity, u32 beginRow, u32 endRow)
+{
+    const r32 invScale = 1.0f / (r32)BLOOM_DOWNSAMPLE;
+    const __m128 intensity_4x = _mm_set1_ps(intensity);
+
+    for(u32 y = beginRow; y < endRow; ++y)
+    {
+        // NOTE(Joey): bilinear upsample; sample at the center of each target pixel
+        r32 bloomY = Max(((r32)y + 0.5f)*invScale - 0.5f, 0.0f);
+        u32 bloomY0 = ClampIndex((i32)bloomY, bloom->Height);
+        u32 bloomY1 = ClampIndex((i32)bloomY + 1, bloom->Height);
+        __m128 fY  = _mm_set1_ps(bloomY - (r32)(i32)bloomY);
+        __m128 ifY = _mm_set1_ps(1.0f - (bloomY - (r32)(i32)bloomY));
+        u32 *bloomRow0 = (u32*)((u8*)bloom->Texels + bloomY0*bloom->Pitch);
+        u32 *bloomRow1 = (u32*)((u8*)bloom->Texels + bloomY1*bloom->Pitch);
+
+        u32 *dest = (u32*)((u8*)target->Texels + y*target->Pitch);
+        for(u32 x = 0; x < target->Width; ++x)
+        {
+            r32 bloomX = Max(((r32)x + 0.5f)*invScale - 0.5f, 0.0f);
+            u32 bloomX0 = ClampIndex((i32)bloomX, bloom->Width);
+            u32 bloomX1 = ClampIndex((i32)bloomX + 1, bloom->Width);
+            __m128 fX  = _mm_set1_ps(bloomX - (r32)(i32)bloomX);
+            __m128 ifX = _mm_set1_ps(1.0f - (bloomX - (r32)(i32)bloomX));
+
+            __m128 top    = _mm_add_ps(_mm_mul_ps(ifX, UnpackPixel(bloomRow0[bloomX0])), _mm_mul_ps(fX, UnpackPixel(bloomRow0[bloomX1])));
+            __m128 bottom = _mm_add_ps(_mm_mul_ps(ifX, UnpackPixel(bloomRow1[bloomX0])), _mm_mul_ps(fX, UnpackPixel(bloomRow1[bloomX1])));
+            __m128 color  = _mm_mul_ps(intensity_4x, _mm_add_ps(_mm_mul_ps(ifY, top), _mm_mul_ps(fY, bottom)));
+
+            // NOTE(Joey): additive blend with per-channel saturation
+            __m128i sum = _mm_adds_epu8(_mm_cvtsi32_si128(dest[x]), _mm_cvtsi32_si128(PackPixel(color)));
+            dest[x] = (u32)_mm_cvtsi128_si32(sum);
+        }
+    }
+}
+
+internal void Vignette(Texture *target, r32 strength, u32 beginRow, u32 endRow)
+{
+    r32 centerX = 0.5f*(r32)target->Width;
+    r32 centerY = 0.5f*(r32)target->Height;
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 fixedOne = _mm_set1_ps(256.0f);
+    const __m128 strength_4x = _mm_set1_ps(strength);
+    const __m128 centerX_4x = _mm_set1_ps(centerX);
+    const __m128 invCenterX_4x = _mm_set1_ps(1.0f / centerX);
+    const __m128i maskFF00FF = _mm_set1_epi32(0x00FF00FF);
+    const __m128i maskAlpha = _mm_set1_epi32(0xFF000000);
+
+    u32 width4 = target->Width & ~3;
+    for(u32 y = beginRow; y < endRow; ++y)
+    {
+        r32 nY = ((r32)y + 0.5f - centerY) / centerY;
+        __m128 nYSq = _mm_set1_ps(nY*nY);
+        __m128 pixelX = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+        u32 *dest = (u32*)((u8*)target->Texels + y*target->Pitch);
+        for(u32 x = 0; x < width4; x += 4)
+        {
+            // NOTE(Joey): factor = 1 - strength*d^4 with d^2 in [0, 1] at the corners
+            __m128 nX = _mm_mul_ps(_mm_sub_ps(pixelX, centerX_4x), invCenterX_4x);
+            __m128 distSq = _mm_mul_ps(half, _mm_add_ps(_mm_mul_ps(nX, nX), nYSq));
+            __m128 factor = _mm_sub_ps(one, _mm_mul_ps(strength_4x, _mm_mul_ps(distSq, distSq)));
+            __m128i factor_4x = _mm_cvtps_epi32(_mm_mul_ps(factor, fixedOne));
+            factor_4x = _mm_or_si128(factor_4x, _mm_slli_epi32(factor_4x, 16));
+
+            // NOTE(Joey): 8.8 fixed point multiply on 0x00RR00BB and 0x000000GG lanes
+            __m128i pixels = _mm_loadu_si128((__m128i*)(dest + x));
+            __m128i rb = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(pixels, maskFF00FF), factor_4x), 8), maskFF00FF);
+            __m128i ag = _mm_and_si128(_mm_srli_epi32(pixels, 8), maskFF00FF);
+            __m128i g  = _mm_and_si128(_mm_srli_epi16(_mm_mullo_epi16(ag, factor_4x), 8), _mm_set1_epi32(0xFF));
+            __m128i out = _mm_or_si128(_mm_or_si128(rb, _mm_slli_epi32(g, 8)), _mm_and_si128(pixels, maskAlpha));
+            _mm_storeu_si128((__m128i*)(dest + x), out);
+
+            pixelX = _mm_add_ps(pixelX, four);
+        }
+        for(u32 x = width4; x < target->Width; ++x)
+        {
+            r32 nX = ((r32)x + 0.5f - centerX) / centerX;
+            r32 distSq = 0.5f*(nX*nX + nY*nY);
+            u32 factor = RoundReal32ToUInt32(256.0f*(1.0f - strength*distSq*distSq));
+            u32 c = dest[x];
+            dest[x] = (c & 0xFF000000) |
+                      ((((c >> 16) & 0xFF)*factor >> 8) << 16) |
+                      ((((c >>  8) & 0xFF)*factor >> 8) <<  8) |
+                      ((((c >>  0) & 0xFF)*factor >> 8) <<  0);
+        }
+    }
+}
+
+internal void ColorGrade(Texture *target, color_grade_lut *lut, u32 beginRow, u32 endRow)
+{
+    // NOTE(Joey): table lookups are a gather by nature; SSE2 has no gather so this stays scalar.
+    for(u32 y = beginRow; y < endRow; ++y)
+    {
+        u32 *dest = (u32*)((u8*)target->Texels + y*target->Pitch);
+        for(u32 x = 0; x < target->Width; ++x)
+        {
+            u32 c = dest[x];
+            dest[x] = (c & 0xFF000000) |
+                      (lut->R[(c >> 16) & 0xFF] << 16) |
+                      (lut->G[(c >>  8) & 0xFF] <<  8) |
+                      (lut->B[(c >>  0) & 0xFF] <<  0);
+        }
+    }
+}
+
+void DoPostProcessWork(platform_work_queue *queue, void *data)
+{
+    post_process_work *work = (post_process_work*)data;
+    switch(work->Effect)
+    {
+        case POST_PROCESS_BLOOM_DOWNSAMPLE:
+        {
+            BloomDownsample(work->Source, work->Dest, work->Settings->BloomThreshold, work->Begin, work->End);
+        } break;
+        case POST_PROCESS_BLOOM_BLUR_HORIZONTAL:
+        {
+            BloomBlurHorizontal(work->Source, work->Dest, work->Begin, work->End);
+        } break;
+        case POST_PROCESS_BLOOM_BLUR_VERTICAL:
+        {
+            BloomBlurVertical(work->Source, work->Dest, work->Begin, work->End);
+        } break;
+        case POST_PROCESS_BLOOM_COMPOSITE:
+        {
+            BloomComposite(work->Source, work->Dest, work->Settings->BloomIntensity, work->Begin, work->End);
+        } break;
+        case POST_PROCESS_VIGNETTE:
+        {
+            Vignette(work->Dest, work->Settings->VignetteStrength, work->Begin, work->End);
+        } break;
+        case POST_PROCESS_COLOR_GRADE:
+        {
+            ColorGrade(work->Dest, &work->Settings->ColorGrade, work->Begin, work->End);
+        } break;
+        default:
+        {
+            InvalidCodePath;
+        } break;
+    }
+}
+
+// NOTE(Joey): splits [0, count) rows|columns in strips, runs them and waits for completion
+internal void DispatchPostProcessEffect(platform_work_queue *workQueue,
+                                        post_process_effect effect,
+                                        post_process_settings *settings,
+                                        Texture *source,
+                                        Texture *dest,
+                                        u32 count)
+{
+    post_process_work work[POST_PROCESS_STRIP_COUNT];
+    u32 stripSize = (count + POST_PROCESS_STRIP_COUNT - 1) / POST_PROCESS_STRIP_COUNT;
+    if(effect == POST_PROCESS_BLOOM_BLUR_VERTICAL)
+        stripSize = Align4(stripSize); // NOTE(Joey): keeps the column strips on the blur's 4 pixel steps
+    for(u32 i = 0; i < POST_PROCESS_STRIP_COUNT; ++i)
+    {
+        u32 begin = i*stripSize;
+        u32 end = Minimum(begin + stripSize, count);
+        if(begin >= end)
+            break;
+
+        post_process_work *strip = work + i;
+        strip->Effect   = effect;
+        strip->Settings = settings;
+        strip->Source   = source;
+        strip->Dest     = dest;
+        strip->Begin    = begin;
+        strip->End      = end;
+
+        if(workQueue)
+            PlatformAPI.AddWorkEntry(workQueue, DoPostProcessWork, strip);
+        else
+            DoPostProcessWork(0, strip);
+    }
+    if(workQueue)
+        PlatformAPI.CompleteAllWork(workQueue);
+}
+
+///////////////////////////////////////////////
+//      EFFECTS
+///////////////////////////////////////////////
+internal void ApplyBloom(platform_work_queue *workQueue, memory_arena *arena, Texture *target, post_process_settings *settings)
+{
+    TIMING_BLOCK();
+    u16 bloomWidth  = (u16)Maximum(target->Width / BLOOM_DOWNSAMPLE, 1);
+    u16 bloomHeight = (u16)Maximum(target->Height / BLOOM_DOWNSAMPLE, 1);
+    Texture bloomA = CreateEmptyTexture(arena, bloomWidth, bloomHeight);
+    Texture bloomB = CreateEmptyTexture(arena, bloomWidth, bloomHeight);
+
+    DispatchPostProcessEffect(workQueue, POST_PROCESS_BLOOM_DOWNSAMPLE,      settings, target,  &bloomA, bloomHeight);
+    DispatchPostProcessEffect(workQueue, POST_PROCESS_BLOOM_BLUR_HORIZONTAL, settings, &bloomA, &bloomB, bloomHeight);
+    DispatchPostProcessEffect(workQueue, POST_PROCESS_BLOOM_BLUR_VERTICAL,   settings, &bloomB, &bloomA, bloomWidth);
+    DispatchPostProcessEffect(workQueue, POST_PROCESS_BLOOM_COMPOSITE,       settings, &bloomA, target,  target->Height);
+}
+
+internal void ApplyVignette(platform_work_queue *workQueue, Texture *target, post_process_settings *settings)
+{
+    TIMING_BLOCK();
+    DispatchPostProcessEffect(workQueue, POST_PROCESS_VIGNETTE, settings, target, target, target->Height);
+}
+
+internal void ApplyColorGrade(platform_work_queue *workQueue, Texture *target, post_process_settings *settings)
+{
+    TIMING_BLOCK();
+    DispatchPostProcessEffect(workQueue, POST_PROCESS_COLOR_GRADE, settings, target, target, target->Height);
+}
+
+internal void PostProcessPass(platform_work_queue *workQueue, memory_arena *arena, Texture *target, post_process_settings *settings)
+{
+    Assert(target->Format == TEXTURE_FORMAT_ARGB32);
+    temp_memory postProcessMemory = BeginTempMemory(arena);
+
+    if(settings->BloomEnabled)
+        ApplyBloom(workQueue, arena, target, settings);
+    if(settings->VignetteEnabled)
+        ApplyVignette(workQueue, target, settings);
+    if(settings->ColorGradeEnabled)
+        ApplyColorGrade(workQueue, target, settings);
+
+    EndTempMemory(postProcessMemory);
+}
@@ -0,0 +1,64 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+// NOTE(Joey): bloom buffers are at 1/BLOOM_DOWNSAMPLE resolution of the render target
+const u32 BLOOM_DOWNSAMPLE   = 4;
+const i32 BLOOM_BLUR_RADIUS  = 4;
+const u32 POST_PROCESS_STRIP_COUNT = 16;
+
+// NOTE(Joey): per-channel tone curves; index with the source channel value
+struct color_grade_lut
+{
+    u8 R[256];
+    u8 G[256];
+    u8 B[256];
+};
+
+struct post_process_settings
+{
+    b32 BloomEnabled;
+    r32 BloomThreshold; // [0, 1]: channel intensity above which pixels start to bloom
+    r32 BloomIntensity;
+
+    b32 VignetteEnabled;
+    r32 VignetteStrength; // [0, 1]: darkening at the screen corners
+
+    b32 ColorGradeEnabled;
+    color_grade_lut ColorGrade;
+};
+
+enum post_process_effect
+{
+    POST_PROCESS_BLOOM_DOWNSAMPLE,
+    POST_PROCESS_BLOOM_BLUR_HORIZONTAL,
+    POST_PROCESS_BLOOM_BLUR_VERTICAL,
+    POST_PROCESS_BLOOM_COMPOSITE,
+    POST_PROCESS_VIGNETTE,
+    POST_PROCESS_COLOR_GRADE,
+};
+
+// NOTE(Joey): a strip of rows (or columns for the vertical blur) that a single worker processes
+struct post_process_work
+{
+    post_process_effect    Effect;
+    post_process_settings *Settings;
+
+    Texture *Source;
+    Texture *Dest;
+
+    u32 Begin;
+    u32 End;
+};
+
+#endif
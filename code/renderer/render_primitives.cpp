@@ -10,17 +10,22 @@
 ** option) any later version.
 *******************************************************************/
 
+#if INTERNAL
+// NOTE(Joey): number of set bits of a 4-lane mask (_mm_movemask_ps)
+const uint8 RENDER_LANE_COUNTS[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+#endif
 
 internal void RenderRectangle_(Texture *target, 
                                vector2D position, 
                                vector2D size, 
+                               rectangle2Di clipRect,
                                vector4D color)
 {
-    // NOTE(Joey): correct out-of-bounds
-    real32 fMinX = Clamp(0.0f, target->Width,  position.x);
-    real32 fMinY = Clamp(0.0f, target->Height, position.y);
-    real32 fMaxX = Clamp(0.0f, target->Width,  position.x + size.x);
-    real32 fMaxY = Clamp(0.0f, target->Height, position.y + size.y);
+    // NOTE(Joey): correct out-of-bounds; clipRect is expected to lie within the target
+    real32 fMinX = Clamp((real32)clipRect.MinX, (real32)clipRect.MaxX, position.x);
+    real32 fMinY = Clamp((real32)clipRect.MinY, (real32)clipRect.MaxY, position.y);
+    real32 fMaxX = Clamp((real32)clipRect.MinX, (real32)clipRect.MaxX, position.x + size.x);
+    real32 fMaxY = Clamp((real32)clipRect.MinY, (real32)clipRect.MaxY, position.y + size.y);
     
     // NOTE(Joey): get integer position
     uint32 minX = RoundReal32ToUInt32(fMinX);
@@ -51,29 +56,11 @@ internal void RenderRectangle_(Texture *target,
 };
 
 
-internal void RenderTexture_(Texture *target, 
-                             Texture *texture, 
-                             vector2D position, 
-                             vector2D size, 
-                             vector2D basisX, 
-                             vector2D basisY, 
-                             rectangle2Di clipRect, 
-                             vector4D color)
+internal rectangle2Di GetOrientedQuadFillRect(vector2D origin, vector2D axisX, vector2D axisY, rectangle2Di clipRect)
 {
-    // TIMING(0): Entire draw call.
-    // BeginCPUTiming(0); 
-    TIMING_BLOCK();
-    
-     // NOTE(Joey): calculate scaled coordinate basis
-    vector2D axisX = size.x * basisX;
-    vector2D axisY = size.y * basisY;
-    // TODO(Joey): think about whether we want this enforced in RenderTexture_ function or whether
-    // this should be controlled purely from the incoming position vector in the game-code.
-    position = position - 0.5f*axisX - 0.5f*axisY;
-    
     // NOTE(Joey): test min max bounds in given coordinate system
     rectangle2Di fillRect = InvertedInfinityRectangle();
-    vector2D testPositions[4] = {position, position + axisX, position + axisX + axisY, position + axisY};
+    vector2D testPositions[4] = {origin, origin + axisX, origin + axisX + axisY, origin + axisY};
     for(int i= 0; i < ArrayCount(testPositions); ++i)
     {
         vector2D testPos = testPositions[i];
@@ -88,9 +75,253 @@ internal void RenderTexture_(Texture *target,
         if(fillRect.MaxY < ceilY) {fillRect.MaxY = ceilY;}
     }   
         
-    fillRect = Intersect(clipRect, fillRect);
+    return Intersect(clipRect, fillRect);
+}
+
+// NOTE(Joey): splits row y of an unrotated textured quad in pixel ranges whose fetches touch
+// non-transparent texels (see texture_spans); otherwise the whole row is a single segment.
+internal uint32 GetTextureRowSegments(row_segment *segments, 
+                                      texture_spans *spans, 
+                                      bool32 unrotated,
+                                      Texture *texture, 
+                                      vector2D origin, 
+                                      vector2D axisX, 
+                                      vector2D axisY, 
+                                      real32 y, 
+                                      int32 minX, 
+                                      int32 maxX)
+{
+    if(!spans || !unrotated)
+    {
+        segments[0].MinX = minX;
+        segments[0].MaxX = maxX;
+        return 1;
+    }
+    
+    // NOTE(Joey): same mapping as the kernel; V is constant over the row
+    real32 v = Clamp01(((y - origin.y)*axisY.y) / LengthSq(axisY));
+    uint32 fetchRow = (uint32)(v*(real32)(texture->Height - 2) + 0.5f);
+    uint32 firstSpan = spans->RowSpanStart[fetchRow];
+    uint32 spanCount = spans->RowSpanStart[fetchRow + 1] - firstSpan;
+    real32 invTexWidthM2 = 1.0f / (real32)(texture->Width - 2);
+    
+    uint32 segmentCount = 0;
+    for(uint32 i = 0; i < spanCount; ++i)
+    {
+        // NOTE(Joey): walk spans left to right on screen; mirrored quads have them reversed
+        uint32 spanIndex = firstSpan + (axisX.x >= 0.0f ? i : spanCount - 1 - i);
+        uint16 *span = spans->Spans + 2*spanIndex;
+        
+        // NOTE(Joey): fetch position f is sampled where f <= U*(Width - 2) + 0.5 < f + 1; pad a 
+        // pixel on both ends against rounding
+        real32 x0 = origin.x + axisX.x*((real32)span[0] - 0.5f)*invTexWidthM2;
+        real32 x1 = origin.x + axisX.x*((real32)span[1] - 0.5f)*invTexWidthM2;
+        int32 segmentMinX = Maximum(FloorReal32ToInt32(Min(x0, x1)) - 1, minX);
+        int32 segmentMaxX = Minimum(CeilReal32ToInt32(Max(x0, x1)) + 1, maxX);
+        if(segmentMinX >= segmentMaxX)
+            continue;
+        
+        // NOTE(Joey): segments are processed in groups of 4 pixels; merge segments that would
+        // share a group so no pixel is blended twice
+        row_segment *previous = segments + segmentCount - 1;
+        if(segmentCount > 0 && ((segmentMinX & ~3) < ((previous->MaxX + 3) & ~3) || segmentCount == ROW_SEGMENT_MAX_COUNT))
+        {
+            previous->MaxX = Maximum(previous->MaxX, segmentMaxX);
+        }
+        else
+        {
+            segments[segmentCount].MinX = segmentMinX;
+            segments[segmentCount].MaxX = segmentMaxX;
+            ++segmentCount;
+        }
+    }
+    return segmentCount;
+}
+
+// NOTE(Joey): SSE2 has no floor; truncate and correct lanes that were rounded up (negative values)
+inline __m128i FloorToInt32_4x(__m128 value)
+{
+    __m128i truncated = _mm_cvttps_epi32(value);
+    __m128i roundedUp = _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), value));
+    return _mm_add_epi32(truncated, roundedUp); // NOTE(Joey): roundedUp lanes are -1
+}
+
+// NOTE(Joey): the fetch helpers below branch on their template parameters, which MSVC reports as constant
+// conditions (C4127) under -W4; those branches are meant to be resolved at compile time.
+#pragma warning(push)
+#pragma warning(disable: 4127)
+
+// NOTE(Joey): maps texture coordinates into [0, 1] according to the address mode
+template<texture_address Address>
+inline __m128 AddressTexCoord_4x(__m128 coord)
+{
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    if(Address == TEXTURE_ADDRESS_WRAP)
+    {
+        coord = _mm_sub_ps(coord, _mm_cvtepi32_ps(FloorToInt32_4x(coord)));
+    }
+    else if(Address == TEXTURE_ADDRESS_MIRROR)
+    {   // NOTE(Joey): wrap over a period of 2 and fold [1, 2) back onto (0, 1]
+        __m128 period = _mm_cvtepi32_ps(FloorToInt32_4x(_mm_mul_ps(coord, _mm_set1_ps(0.5f))));
+        coord = _mm_sub_ps(coord, _mm_mul_ps(two, period));
+        coord = _mm_min_ps(coord, _mm_sub_ps(two, coord));
+    }
+    return _mm_min_ps(_mm_max_ps(coord, zero), one);
+}
+
+// NOTE(Joey): texel indices outside [0, size) of bilinear neighbours at the texture's edges
+template<texture_address Address>
+inline __m128i AddressTexelIndex_4x(__m128i index, __m128i size)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i sizeMinusOne = _mm_sub_epi32(size, _mm_set1_epi32(1));
+    __m128i below = _mm_cmplt_epi32(index, zero);
+    __m128i above = _mm_cmpgt_epi32(index, sizeMinusOne);
+    if(Address == TEXTURE_ADDRESS_WRAP)
+    {
+        index = _mm_or_si128(_mm_andnot_si128(below, index), _mm_and_si128(below, sizeMinusOne));
+        index = _mm_andnot_si128(above, index);
+    }
+    else
+    {
+        index = _mm_andnot_si128(below, index);
+        index = _mm_or_si128(_mm_andnot_si128(above, index), _mm_and_si128(above, sizeMinusOne));
+    }
+    return index;
+}
+
+/* NOTE(Joey):
+
+  Fetches 4 texels of a palettized or block compressed texture as ARGB32.
+  Palette lookups are per lane; blocks only read their endpoints and the
+  texel's index per lane, the block palettes (see GetBlockPalette) are 
+  decoded for all 4 lanes at once.
+
+*/
+template<texture_format Format>
+inline __m128i FetchTexels_4x(Texture *texture, __m128i x_4x, __m128i y_4x)
+{
+    uint32 x[4];
+    uint32 y[4];
+    _mm_storeu_si128((__m128i *)x, x_4x);
+    _mm_storeu_si128((__m128i *)y, y_4x);
+    
+    uint8 *texels = (uint8*)texture->Texels;
+    __m128i result;
+    if(Format == TEXTURE_FORMAT_PALETTE8)
+    {
+        uint32 *palette = texture->Palette;
+        result = _mm_setr_epi32(palette[texels[y[0]*texture->Pitch + x[0]]],
+                                palette[texels[y[1]*texture->Pitch + x[1]]],
+                                palette[texels[y[2]*texture->Pitch + x[2]]],
+                                palette[texels[y[3]*texture->Pitch + x[3]]]);
+    }
+    else
+    {
+        uint32 endpoints[4];
+        uint32 indices[4];
+        for(uint32 i = 0; i < 4; ++i)
+        {
+            uint8 *block = texels + (y[i] >> 2)*texture->Pitch + (x[i] >> 2)*TEXTURE_BLOCK_BYTES;
+            endpoints[i] = *(uint32 *)block;
+            indices[i] = (*(uint32 *)(block + 4) >> 2*(4*(y[i] & 3) + (x[i] & 3))) & 3;
+        }
+        __m128i endpoints_4x = _mm_loadu_si128((__m128i *)endpoints);
+        __m128i index_4x = _mm_loadu_si128((__m128i *)indices);
+        
+        const __m128i maskFFFF = _mm_set1_epi32(0xFFFF);
+        const __m128i maskFF00FF = _mm_set1_epi32(0x00FF00FF);
+        const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+        const __m128i div3 = _mm_set1_epi16((int16)0xAAAB); // NOTE(Joey): x/3 == (x*0xAAAB) >> 17 for x < 2^16
+        __m128i color0 = _mm_and_si128(endpoints_4x, maskFFFF);
+        __m128i color1 = _mm_srli_epi32(endpoints_4x, 16);
+        __m128i fourColors = _mm_cmpgt_epi32(color0, color1);
+        __m128i palette0 = ExpandColor565_4x(color0);
+        __m128i palette1 = ExpandColor565_4x(color1);
+        
+        // NOTE(Joey): interpolate red/blue and green separately with a channel per 16 bit lane
+        __m128i palette2 = _mm_setzero_si128();
+        __m128i palette3 = _mm_setzero_si128();
+        for(uint32 shift = 0; shift < 16; shift += 8)
+        {
+            __m128i a = _mm_and_si128(_mm_srli_epi32(palette0, shift), maskFF00FF);
+            __m128i b = _mm_and_si128(_mm_srli_epi32(palette1, shift), maskFF00FF);
+            __m128i twoThirdsA = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(a, a), b), div3), 1);
+            __m128i twoThirdsB = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_add_epi16(b, b), a), div3), 1);
+            __m128i half = _mm_srli_epi16(_mm_add_epi16(a, b), 1);
+            __m128i channels2 = _mm_or_si128(_mm_and_si128(fourColors, twoThirdsA), _mm_andnot_si128(fourColors, half));
+            __m128i channels3 = _mm_and_si128(fourColors, twoThirdsB);
+            palette2 = _mm_or_si128(palette2, _mm_slli_epi32(channels2, shift));
+            palette3 = _mm_or_si128(palette3, _mm_slli_epi32(channels3, shift));
+        }
+        palette0 = _mm_or_si128(palette0, alphaMask);
+        palette1 = _mm_or_si128(palette1, alphaMask);
+        palette2 = _mm_or_si128(palette2, alphaMask);
+        palette3 = _mm_or_si128(palette3, _mm_and_si128(fourColors, alphaMask));
+        
+        __m128i select0 = _mm_cmpeq_epi32(index_4x, _mm_set1_epi32(0));
+        __m128i select1 = _mm_cmpeq_epi32(index_4x, _mm_set1_epi32(1));
+        __m128i select2 = _mm_cmpeq_epi32(index_4x, _mm_set1_epi32(2));
+        __m128i select3 = _mm_cmpeq_epi32(index_4x, _mm_set1_epi32(3));
+        result = _mm_or_si128(_mm_or_si128(_mm_and_si128(select0, palette0), _mm_and_si128(select1, palette1)),
+                              _mm_or_si128(_mm_and_si128(select2, palette2), _mm_and_si128(select3, palette3)));
+    }
+    return result;
+}
+#pragma warning(pop)
+
+/* NOTE(Joey):
+
+  Textured quad rasterizer, specialized per sampler filter and address mode
+  so the pixel loop doesn't branch on sampler state; RenderTexture_ selects
+  the specialization. Nearest filtering fetches a single texel per pixel 
+  instead of 4. 
+  
+  The default clamped bilinear sampler keeps the original texel mapping 
+  (biased s.t. bilinear neighbours never leave the texture) and is the only
+  one that uses the texture's span tables. Wrap and mirror use the regular 
+  texel-center mapping with their neighbours addressed explicitly.
+  
+  Palettized and block compressed textures are decoded per fetch (see 
+  FetchTexels_4x); they're specialized as well.
+
+*/
+#pragma warning(push)
+#pragma warning(disable: 4127) // NOTE(Joey): branches on the template parameters; see AddressTexCoord_4x
+template<texture_format Format, texture_filter Filter, texture_address Address>
+internal void RenderTextureSampled_(Texture *target, 
+                                    Texture *texture, 
+                                    vector2D position, 
+                                    vector2D size, 
+                                    vector2D basisX, 
+                                    vector2D basisY, 
+                                    rectangle2Di clipRect, 
+                                    vector4D color,
+                                    texture_sampler sampler,
+                                    render_tile_stats *stats)
+{
+    // TIMING(0): Entire draw call.
+    // BeginCPUTiming(0); 
+    TIMING_BLOCK();
+    
+     // NOTE(Joey): calculate scaled coordinate basis
+    vector2D axisX = size.x * basisX;
+    vector2D axisY = size.y * basisY;
+    // TODO(Joey): think about whether we want this enforced in RenderTexture_ function or whether
+    // this should be controlled purely from the incoming position vector in the game-code.
+    position = position - 0.5f*axisX - 0.5f*axisY;
+    
+    rectangle2Di fillRect = GetOrientedQuadFillRect(position, axisX, axisY, clipRect);
     if(HasArea(fillRect))
-    {              
+    {
+#if INTERNAL
+        // NOTE(Joey): see render_tile_stats
+        uint32 pixelsConsidered = 0;
+        uint32 pixelsWritten = 0;
+#endif
+              
         // NOTE(Joey): align masks to 4-byte/16-pixel boundary
         __m128i startClipMask = _mm_set1_epi8(-1);
         __m128i endClipMask = _mm_set1_epi8(-1);
@@ -111,17 +342,14 @@ internal void RenderTexture_(Texture *target,
             _mm_srli_si128(endClipMask, 1*4),            
         };
         
-        if(fillRect.MinX & 3)
-        {
-            startClipMask = startClipMasks[fillRect.MinX & 3];
-            fillRect.MinX = fillRect.MinX & ~3;
-        }
-
-        if(fillRect.MaxX & 3)
-        {
-            endClipMask = endClipMasks[fillRect.MaxX & 3];
-            fillRect.MaxX = (fillRect.MaxX & ~3) + 4;
-        }        
+        // NOTE(Joey): rows are split in segments of pixels that can be covered by non-transparent
+        // texels; without span data (or when rotated) a row is a single segment.
+        bool32 identityUV = sampler.UVScale.x == 1.0f && sampler.UVScale.y == 1.0f && 
+                            sampler.UVOffset.x == 0.0f && sampler.UVOffset.y == 0.0f;
+        texture_spans *spans = 0;
+        if(Filter == TEXTURE_FILTER_BILINEAR && Address == TEXTURE_ADDRESS_CLAMP && identityUV)
+            spans = texture->Spans;
+        bool32 unrotated = axisX.y == 0.0f && axisY.x == 0.0f;
         
         // SIMD        
         #define mmSquare(a) _mm_mul_ps(a, a)
@@ -156,8 +384,512 @@ internal void RenderTexture_(Texture *target,
         const __m128 invSquareDotAxisY =  _mm_div_ps(one, _mm_add_ps(mmSquare(mAxisYx), mmSquare(mAxisYy))); 
         const __m128 texWidthM2 = _mm_set1_ps((real32)texture->Width - 2);
         const __m128 texHeightM2 = _mm_set1_ps((real32)texture->Height - 2);
+        const __m128 texWidth = _mm_set1_ps((real32)texture->Width);
+        const __m128 texHeight = _mm_set1_ps((real32)texture->Height);
+        const __m128 texWidthM1 = _mm_set1_ps((real32)texture->Width - 1);
+        const __m128 texHeightM1 = _mm_set1_ps((real32)texture->Height - 1);
+        const __m128i texWidth_4x = _mm_set1_epi32(texture->Width);
+        const __m128i texHeight_4x = _mm_set1_epi32(texture->Height);
         const __m128i texturePitch_4x = _mm_set1_epi32(texture->Pitch);
+        const __m128i one_4x = _mm_set1_epi32(1);
+        
+        const __m128 uvScaleX = _mm_set1_ps(sampler.UVScale.x);
+        const __m128 uvScaleY = _mm_set1_ps(sampler.UVScale.y);
+        const __m128 uvOffsetX = _mm_set1_ps(sampler.UVOffset.x);
+        const __m128 uvOffsetY = _mm_set1_ps(sampler.UVOffset.y);
+        const __m128i coverageWidth_4x = _mm_set1_epi32(spans ? spans->CoverageWidth : 0);
+        const __m128i fullMask = _mm_set1_epi8(-1);
+
+        
+        int minX = fillRect.MinX;
+        int minY = fillRect.MinY;
+        int maxX = fillRect.MaxX;
+        int maxY = fillRect.MaxY;
+                
+        uint32 destPitch = target->Width*sizeof(uint32);
+        uint8 *destRow = (uint8*)target->Texels + minY*destPitch;
+        
+        for (int32 y = minY; y < maxY; ++y, destRow += destPitch)
+        {
+            __m128 pixelPosY = _mm_set1_ps((real32)y);
+            __m128 dY = _mm_sub_ps(pixelPosY, positionY);
+            __m128 dYAxisXy = _mm_mul_ps(dY, mAxisXy);
+            __m128 dYAxisYy = _mm_mul_ps(dY, mAxisYy);
+            
+            row_segment segments[ROW_SEGMENT_MAX_COUNT];
+            uint32 segmentCount = GetTextureRowSegments(segments, spans, unrotated, texture, position, 
+                                                        axisX, axisY, (real32)y, minX, maxX);
+            for(uint32 segmentIndex = 0; segmentIndex < segmentCount; ++segmentIndex)
+            {
+                int32 segmentMinX = segments[segmentIndex].MinX & ~3;
+                int32 segmentMaxX = (segments[segmentIndex].MaxX + 3) & ~3;
+                __m128i segmentStartMask = startClipMasks[segments[segmentIndex].MinX & 3];
+                __m128i segmentEndMask = (segments[segmentIndex].MaxX & 3) ? endClipMasks[segments[segmentIndex].MaxX & 3] : fullMask;
+            
+                uint32 *dest = (uint32*)destRow + segmentMinX;
+                __m128 pixelPosX = _mm_set_ps((real32)(segmentMinX + 3),
+                                              (real32)(segmentMinX + 2), 
+                                              (real32)(segmentMinX + 1), 
+                                              (real32)(segmentMinX + 0));
+                __m128 dX = _mm_sub_ps(pixelPosX, positionX);
+                               
+                for (int32 x = segmentMinX; x < segmentMaxX; x += 4, dest += 4, dX = _mm_add_ps(dX, four))
+                {
+                    __m128i clipMask = fullMask;
+                    if(x == segmentMinX)
+                        clipMask = segmentStartMask;
+                    if(x + 4 == segmentMaxX)
+                        clipMask = _mm_and_si128(clipMask, segmentEndMask);
+                
+                    // TIMING(1): Per pixel CPU timing
+                    // BeginCPUTiming(1);
+
+                    // NOTE(Joey): pre-fetch destination memory at start
+                    __m128i originalDest = _mm_loadu_si128((__m128i *)dest);
+
+                    __m128 uNominator = _mm_add_ps(_mm_mul_ps(dX, mAxisXx), dYAxisXy);
+                    __m128 U = _mm_mul_ps(invSquareDotAxisX, uNominator);
+                    __m128 vNominator = _mm_add_ps(_mm_mul_ps(dX, mAxisYx), dYAxisYy);
+                    __m128 V = _mm_mul_ps(invSquareDotAxisY, vNominator);                  
+
+                    // NOTE(Joey): determine from UV whether we write pixels (none if out of range [0, 1])
+                    __m128i writeMask = _mm_castps_si128(_mm_and_ps(_mm_and_ps(_mm_cmpge_ps(U, zero),
+                                                         _mm_cmple_ps(U, one)),
+                                                         _mm_and_ps(_mm_cmpge_ps(V, zero),
+                                                         _mm_cmple_ps(V, one))));
+                    writeMask = _mm_and_si128(writeMask, clipMask);
+#if INTERNAL
+                    pixelsConsidered += RENDER_LANE_COUNTS[_mm_movemask_ps(_mm_castsi128_ps(clipMask))];
+#endif
+                    if(!_mm_movemask_epi8(writeMask))
+                        continue;
+
+                    // NOTE(Joey): after determining write mask, transform and address UV, then fetch texels
+                    U = AddressTexCoord_4x<Address>(_mm_add_ps(_mm_mul_ps(U, uvScaleX), uvOffsetX));
+                    V = AddressTexCoord_4x<Address>(_mm_add_ps(_mm_mul_ps(V, uvScaleY), uvOffsetY));
+                    
+                    // NOTE(Joey): Load destination
+                    __m128 destb = _mm_cvtepi32_ps(_mm_and_si128(originalDest, maskFF));
+                    __m128 destg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 8), maskFF));
+                    __m128 destr = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 16), maskFF));
+                    __m128 desta = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 24), maskFF));
+
+                    __m128 texelr, texelg, texelb, texela;
+                    if(Filter == TEXTURE_FILTER_NEAREST)
+                    {
+                        __m128i fetchX_4x = _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(U, texWidth), texWidthM1));
+                        __m128i fetchY_4x = _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(V, texHeight), texHeightM1));
+                        __m128i sample;
+                        if(Format == TEXTURE_FORMAT_ARGB32)
+                        {
+                            fetchX_4x = _mm_slli_epi32(fetchX_4x, 2);
+                            fetchY_4x = _mm_or_si128(_mm_mullo_epi16(fetchY_4x, texturePitch_4x),
+                                _mm_slli_epi32(_mm_mulhi_epi16(fetchY_4x, texturePitch_4x), 16));
+                            __m128i fetch_4x = _mm_add_epi32(fetchX_4x, fetchY_4x);
+                            
+                            uint8 *texels = (uint8*)texture->Texels;
+                            sample = _mm_setr_epi32(*(uint32 *)(texels + Mi(fetch_4x, 0)),
+                                                    *(uint32 *)(texels + Mi(fetch_4x, 1)),
+                                                    *(uint32 *)(texels + Mi(fetch_4x, 2)),
+                                                    *(uint32 *)(texels + Mi(fetch_4x, 3)));
+                        }
+                        else
+                        {
+                            sample = FetchTexels_4x<Format>(texture, fetchX_4x, fetchY_4x);
+                        }
+                        texelb = _mm_cvtepi32_ps(_mm_and_si128(sample, maskFF));
+                        texelg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(sample, 8), maskFF));
+                        texelr = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(sample, 16), maskFF));
+                        texela = _mm_cvtepi32_ps(_mm_srli_epi32(sample, 24));
+                    }
+                    else
+                    {
+                        __m128i fetchX_4x, fetchY_4x, nextX_4x, nextY_4x;
+                        __m128 fX, fY;
+                        if(Address == TEXTURE_ADDRESS_CLAMP)
+                        {
+                            // NOTE(Joey): Bias texture coordinates to start on the boundary between 
+                            // 0,0 and 1,1 pixels.
+                            __m128 tX = _mm_add_ps(_mm_mul_ps(U, texWidthM2), half);
+                            __m128 tY = _mm_add_ps(_mm_mul_ps(V, texHeightM2), half);
+                
+                            fetchX_4x = _mm_cvttps_epi32(tX);
+                            fetchY_4x = _mm_cvttps_epi32(tY);
+                            fX = _mm_sub_ps(tX, _mm_cvtepi32_ps(fetchX_4x));
+                            fY = _mm_sub_ps(tY, _mm_cvtepi32_ps(fetchY_4x));
+                            nextX_4x = _mm_add_epi32(fetchX_4x, one_4x);
+                            nextY_4x = _mm_add_epi32(fetchY_4x, one_4x);
+
+                            // NOTE(Joey): rotated draws skip blocks whose fetches only touch transparent texels
+                            if(spans && !unrotated)
+                            {
+                                __m128i cellY = _mm_srli_epi32(fetchY_4x, TEXTURE_COVERAGE_CELL_SHIFT);
+                                __m128i cell = _mm_add_epi32(_mm_srli_epi32(fetchX_4x, TEXTURE_COVERAGE_CELL_SHIFT),
+                                                             _mm_or_si128(_mm_mullo_epi16(cellY, coverageWidth_4x),
+                                                             _mm_slli_epi32(_mm_mulhi_epi16(cellY, coverageWidth_4x), 16)));
+                                __m128i covered = _mm_setr_epi32(-(int32)spans->Coverage[Mi(cell, 0)],
+                                                                 -(int32)spans->Coverage[Mi(cell, 1)],
+                                                                 -(int32)spans->Coverage[Mi(cell, 2)],
+                                                                 -(int32)spans->Coverage[Mi(cell, 3)]);
+                                if(!_mm_movemask_epi8(_mm_and_si128(covered, writeMask)))
+                                    continue;
+                            }
+                        }
+                        else
+                        {   // NOTE(Joey): texel centers at +0.5; neighbours that fall off the texture are addressed
+                            __m128 tX = _mm_sub_ps(_mm_mul_ps(U, texWidth), half);
+                            __m128 tY = _mm_sub_ps(_mm_mul_ps(V, texHeight), half);
+                            fetchX_4x = FloorToInt32_4x(tX);
+                            fetchY_4x = FloorToInt32_4x(tY);
+                            fX = _mm_sub_ps(tX, _mm_cvtepi32_ps(fetchX_4x));
+                            fY = _mm_sub_ps(tY, _mm_cvtepi32_ps(fetchY_4x));
+                            nextX_4x = AddressTexelIndex_4x<Address>(_mm_add_epi32(fetchX_4x, one_4x), texWidth_4x);
+                            nextY_4x = AddressTexelIndex_4x<Address>(_mm_add_epi32(fetchY_4x, one_4x), texHeight_4x);
+                            fetchX_4x = AddressTexelIndex_4x<Address>(fetchX_4x, texWidth_4x);
+                            fetchY_4x = AddressTexelIndex_4x<Address>(fetchY_4x, texHeight_4x);
+                        }
+
+                        __m128i sampleA, sampleB, sampleC, sampleD;
+                        if(Format == TEXTURE_FORMAT_ARGB32)
+                        {
+                            // NOTE(Joey): byte offsets of the 2 columns and rows of the bilinear footprint
+                            __m128i column0 = _mm_slli_epi32(fetchX_4x, 2);
+                            __m128i column1 = _mm_slli_epi32(nextX_4x, 2);
+                            __m128i row0 = _mm_or_si128(_mm_mullo_epi16(fetchY_4x, texturePitch_4x),
+                                _mm_slli_epi32(_mm_mulhi_epi16(fetchY_4x, texturePitch_4x), 16));
+                            __m128i row1 = _mm_or_si128(_mm_mullo_epi16(nextY_4x, texturePitch_4x),
+                                _mm_slli_epi32(_mm_mulhi_epi16(nextY_4x, texturePitch_4x), 16));
+                            __m128i fetchA = _mm_add_epi32(row0, column0);
+                            __m128i fetchB = _mm_add_epi32(row0, column1);
+                            __m128i fetchC = _mm_add_epi32(row1, column0);
+                            __m128i fetchD = _mm_add_epi32(row1, column1);
+
+                            // NOTE(Joey): fetch 4 samples for bilinear blend
+                            uint8 *texels = (uint8*)texture->Texels;
+                            sampleA = _mm_setr_epi32(*(uint32 *)(texels + Mi(fetchA, 0)),
+                                                     *(uint32 *)(texels + Mi(fetchA, 1)),
+                                                     *(uint32 *)(texels + Mi(fetchA, 2)),
+                                                     *(uint32 *)(texels + Mi(fetchA, 3)));
+
+                            sampleB = _mm_setr_epi32(*(uint32 *)(texels + Mi(fetchB, 0)),
+                                                     *(uint32 *)(texels + Mi(fetchB, 1)),
+                                                     *(uint32 *)(texels + Mi(fetchB, 2)),
+                                                     *(uint32 *)(texels + Mi(fetchB, 3)));
+
+                            sampleC = _mm_setr_epi32(*(uint32 *)(texels + Mi(fetchC, 0)),
+                                                     *(uint32 *)(texels + Mi(fetchC, 1)),
+                                                     *(uint32 *)(texels + Mi(fetchC, 2)),
+                                                     *(uint32 *)(texels + Mi(fetchC, 3)));
+
+                            sampleD = _mm_setr_epi32(*(uint32 *)(texels + Mi(fetchD, 0)),
+                                                     *(uint32 *)(texels + Mi(fetchD, 1)),
+                                                     *(uint32 *)(texels + Mi(fetchD, 2)),
+                                                     *(uint32 *)(texels + Mi(fetchD, 3)));
+                        }
+                        else
+                        {
+                            sampleA = FetchTexels_4x<Format>(texture, fetchX_4x, fetchY_4x);
+                            sampleB = FetchTexels_4x<Format>(texture, nextX_4x, fetchY_4x);
+                            sampleC = FetchTexels_4x<Format>(texture, fetchX_4x, nextY_4x);
+                            sampleD = FetchTexels_4x<Format>(texture, nextX_4x, nextY_4x);
+                        }
+
+                        // NOTE(Joey): unpack bilinear samples
+                        __m128i texelArb = _mm_and_si128(sampleA, maskFF00FF);
+                        __m128i texelAag = _mm_and_si128(_mm_srli_epi32(sampleA, 8), maskFF00FF);
+                        __m128 texelAa = _mm_cvtepi32_ps(_mm_srli_epi32(texelAag, 16));
+
+                        __m128i texelBrb = _mm_and_si128(sampleB, maskFF00FF);
+                        __m128i texelBag = _mm_and_si128(_mm_srli_epi32(sampleB, 8), maskFF00FF);
+                        __m128 texelBa = _mm_cvtepi32_ps(_mm_srli_epi32(texelBag, 16));
+
+                        __m128i texelCrb = _mm_and_si128(sampleC, maskFF00FF);
+                        __m128i texelCag = _mm_and_si128(_mm_srli_epi32(sampleC, 8), maskFF00FF);
+                        __m128 texelCa = _mm_cvtepi32_ps(_mm_srli_epi32(texelCag, 16));
+
+                        __m128i texelDrb = _mm_and_si128(sampleD, maskFF00FF);
+                        __m128i texelDag = _mm_and_si128(_mm_srli_epi32(sampleD, 8), maskFF00FF);
+                        __m128 texelDa = _mm_cvtepi32_ps(_mm_srli_epi32(texelDag, 16));
+
+                        // NOTE(Joey): extract individual texel components and cvt. to real.
+                        __m128 texelAr = _mm_cvtepi32_ps(_mm_srli_epi32(texelArb, 16));
+                        __m128 texelAg = _mm_cvtepi32_ps(_mm_and_si128(texelAag, maskFFFF));
+                        __m128 texelAb = _mm_cvtepi32_ps(_mm_and_si128(texelArb, maskFFFF));
+
+                        __m128 texelBr = _mm_cvtepi32_ps(_mm_srli_epi32(texelBrb, 16));
+                        __m128 texelBg = _mm_cvtepi32_ps(_mm_and_si128(texelBag, maskFFFF));
+                        __m128 texelBb = _mm_cvtepi32_ps(_mm_and_si128(texelBrb, maskFFFF));
+
+                        __m128 texelCr = _mm_cvtepi32_ps(_mm_srli_epi32(texelCrb, 16));
+                        __m128 texelCg = _mm_cvtepi32_ps(_mm_and_si128(texelCag, maskFFFF));
+                        __m128 texelCb = _mm_cvtepi32_ps(_mm_and_si128(texelCrb, maskFFFF));
+
+                        __m128 texelDr = _mm_cvtepi32_ps(_mm_srli_epi32(texelDrb, 16));
+                        __m128 texelDg = _mm_cvtepi32_ps(_mm_and_si128(texelDag, maskFFFF));
+                        __m128 texelDb = _mm_cvtepi32_ps(_mm_and_si128(texelDrb, maskFFFF));
+                
+                        // NOTE(Joey): bilinear texture filtering
+                        __m128 ifX = _mm_sub_ps(one, fX);
+                        __m128 ifY = _mm_sub_ps(one, fY);
+            
+                        __m128 l0 = _mm_mul_ps(ifY, ifX);
+                        __m128 l1 = _mm_mul_ps(ifY, fX);
+                        __m128 l2 = _mm_mul_ps(fY, ifX);
+                        __m128 l3 = _mm_mul_ps(fY, fX);
+
+                        texelr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAr), _mm_mul_ps(l1, texelBr)),
+                                            _mm_add_ps(_mm_mul_ps(l2, texelCr), _mm_mul_ps(l3, texelDr)));
+                        texelg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAg), _mm_mul_ps(l1, texelBg)),
+                                            _mm_add_ps(_mm_mul_ps(l2, texelCg), _mm_mul_ps(l3, texelDg)));
+                        texelb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAb), _mm_mul_ps(l1, texelBb)),
+                                            _mm_add_ps(_mm_mul_ps(l2, texelCb), _mm_mul_ps(l3, texelDb)));
+                        texela = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAa), _mm_mul_ps(l1, texelBa)),
+                                            _mm_add_ps(_mm_mul_ps(l2, texelCa), _mm_mul_ps(l3, texelDa)));
+                    }
+
+                    // NOTE(Joey): Modulate by color
+                    texelr = _mm_mul_ps(texelr, colorr_4x);
+                    texelg = _mm_mul_ps(texelg, colorg_4x);
+                    texelb = _mm_mul_ps(texelb, colorb_4x);
+                    texela = _mm_mul_ps(texela, colora_4x);
+                
+                    texelr = _mm_min_ps(_mm_max_ps(texelr, zero), maxColorValue);
+                    texelg = _mm_min_ps(_mm_max_ps(texelg, zero), maxColorValue);
+                    texelb = _mm_min_ps(_mm_max_ps(texelb, zero), maxColorValue);
+
+                    // NOTE(Joey): destination/framebuffer blend
+                    __m128 mulAlpha  = _mm_mul_ps(inv255_4x, texela);
+                    __m128 invTexelA = _mm_sub_ps(one, mulAlpha);
+                    __m128 blendedr = _mm_add_ps(_mm_mul_ps(invTexelA, destr), _mm_mul_ps(mulAlpha, texelr));
+                    __m128 blendedg = _mm_add_ps(_mm_mul_ps(invTexelA, destg), _mm_mul_ps(mulAlpha, texelg));
+                    __m128 blendedb = _mm_add_ps(_mm_mul_ps(invTexelA, destb), _mm_mul_ps(mulAlpha, texelb));
+                    __m128 blendeda = _mm_add_ps(_mm_mul_ps(invTexelA, desta), _mm_mul_ps(mulAlpha, texela));
+                
+                    
+                    // NOTE(Joey): write back to framebuffer memory
+                    __m128i intr = _mm_cvtps_epi32(blendedr);
+                    __m128i intg = _mm_cvtps_epi32(blendedg);
+                    __m128i intb = _mm_cvtps_epi32(blendedb);
+                    __m128i inta = _mm_cvtps_epi32(blendeda);
+                    // NOTE(Joey): pack to windows destination RGBA format
+                    __m128i sr = _mm_slli_epi32(intr, 16);
+                    __m128i sg = _mm_slli_epi32(intg, 8);
+                    __m128i sb = intb;
+                    __m128i sa = _mm_slli_epi32(inta, 24);
+                    __m128i out = _mm_or_si128(_mm_or_si128(sr, sg), _mm_or_si128(sb, sa));
+                
+                    // NOTE(Joey): only write to memory where mask bits are set
+                    __m128i maskedOut = _mm_or_si128(_mm_and_si128(writeMask, out),
+                                                     _mm_andnot_si128(writeMask, originalDest));
+                    _mm_storeu_si128((__m128i *)dest, maskedOut);
+#if INTERNAL
+                    pixelsWritten += RENDER_LANE_COUNTS[_mm_movemask_ps(_mm_castsi128_ps(writeMask))];
+#endif
+
+                    // EndCPUTiming(1, 4);
+                }
+            }
+        }
+#if INTERNAL
+        if(stats)
+        {
+            stats->PixelsWritten += pixelsWritten;
+            stats->PixelsRejected += pixelsConsidered - pixelsWritten;
+        }
+#endif
+    }
+    // EndCPUTiming(0);
+}
+#pragma warning(pop)
+
+// NOTE(Joey): selects the RenderTextureSampled_ specialization of the sampler once per draw
+template<texture_format Format>
+internal void RenderTextureFormat_(Texture *target, 
+                                   Texture *texture, 
+                                   vector2D position, 
+                                   vector2D size, 
+                                   vector2D basisX, 
+                                   vector2D basisY, 
+                                   rectangle2Di clipRect, 
+                                   vector4D color,
+                                   texture_sampler sampler,
+                                   render_tile_stats *stats)
+{
+    if(sampler.Filter == TEXTURE_FILTER_NEAREST)
+    {
+        switch(sampler.Address)
+        {
+            case TEXTURE_ADDRESS_CLAMP:
+            {
+                RenderTextureSampled_<Format, TEXTURE_FILTER_NEAREST, TEXTURE_ADDRESS_CLAMP>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+            } break;
+            case TEXTURE_ADDRESS_WRAP:
+            {
+                RenderTextureSampled_<Format, TEXTURE_FILTER_NEAREST, TEXTURE_ADDRESS_WRAP>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+            } break;
+            case TEXTURE_ADDRESS_MIRROR:
+            {
+                RenderTextureSampled_<Format, TEXTURE_FILTER_NEAREST, TEXTURE_ADDRESS_MIRROR>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+            } break;
+            default:
+            {
+                InvalidCodePath;
+            }
+        }
+    }
+    else
+    {
+        switch(sampler.Address)
+        {
+            case TEXTURE_ADDRESS_CLAMP:
+            {
+                RenderTextureSampled_<Format, TEXTURE_FILTER_BILINEAR, TEXTURE_ADDRESS_CLAMP>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+            } break;
+            case TEXTURE_ADDRESS_WRAP:
+            {
+                RenderTextureSampled_<Format, TEXTURE_FILTER_BILINEAR, TEXTURE_ADDRESS_WRAP>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+            } break;
+            case TEXTURE_ADDRESS_MIRROR:
+            {
+                RenderTextureSampled_<Format, TEXTURE_FILTER_BILINEAR, TEXTURE_ADDRESS_MIRROR>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+            } break;
+            default:
+            {
+                InvalidCodePath;
+            }
+        }
+    }
+}
+
+internal void RenderTexture_(Texture *target, 
+                             Texture *texture, 
+                             vector2D position, 
+                             vector2D size, 
+                             vector2D basisX, 
+                             vector2D basisY, 
+                             rectangle2Di clipRect, 
+                             vector4D color,
+                             texture_sampler sampler = TextureSampler(),
+                             render_tile_stats *stats = 0)
+{
+    switch(texture->Format)
+    {
+        case TEXTURE_FORMAT_ARGB32:
+        {
+            RenderTextureFormat_<TEXTURE_FORMAT_ARGB32>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+        } break;
+        case TEXTURE_FORMAT_PALETTE8:
+        {
+            RenderTextureFormat_<TEXTURE_FORMAT_PALETTE8>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+        } break;
+        case TEXTURE_FORMAT_BLOCK4X4:
+        {
+            RenderTextureFormat_<TEXTURE_FORMAT_BLOCK4X4>(target, texture, position, size, basisX, basisY, clipRect, color, sampler, stats);
+        } break;
+        default:
+        {
+            InvalidCodePath;
+        }
+    }
+}
+
+/* NOTE(Joey):
+
+  Renders a signed distance field texture (see LoadCharacterGlyphSDF). Only
+  the alpha channel (the encoded distance) is bilinearly sampled; the edge 
+  is then reconstructed with a smoothstep whose width covers roughly one 
+  screen pixel. The width follows from how many texels map onto a single
+  pixel so edges stay equally crisp when the glyph is magnified or 
+  minified, without re-baking per size.
+
+*/
+internal void RenderTextureSDF_(Texture *target, 
+                                Texture *texture, 
+                                vector2D position, 
+                                vector2D size, 
+                                vector2D basisX, 
+                                vector2D basisY, 
+                                rectangle2Di clipRect, 
+                                vector4D color,
+                                real32 spread)
+{
+    TIMING_BLOCK();
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+    
+    vector2D axisX = size.x * basisX;
+    vector2D axisY = size.y * basisY;
+    position = position - 0.5f*axisX - 0.5f*axisY;
+    
+    rectangle2Di fillRect = GetOrientedQuadFillRect(position, axisX, axisY, clipRect);
+    if(HasArea(fillRect))
+    {              
+        __m128i startClipMask = _mm_set1_epi8(-1);
+        __m128i endClipMask = _mm_set1_epi8(-1);
+
+        __m128i startClipMasks[] =
+        {
+            _mm_slli_si128(startClipMask, 0*4),
+            _mm_slli_si128(startClipMask, 1*4),
+            _mm_slli_si128(startClipMask, 2*4),
+            _mm_slli_si128(startClipMask, 3*4),            
+        };
 
+        __m128i endClipMasks[] =
+        {
+            _mm_srli_si128(endClipMask, 0*4),
+            _mm_srli_si128(endClipMask, 3*4),
+            _mm_srli_si128(endClipMask, 2*4),
+            _mm_srli_si128(endClipMask, 1*4),            
+        };
+        
+        if(fillRect.MinX & 3)
+        {
+            startClipMask = startClipMasks[fillRect.MinX & 3];
+            fillRect.MinX = fillRect.MinX & ~3;
+        }
+
+        if(fillRect.MaxX & 3)
+        {
+            endClipMask = endClipMasks[fillRect.MaxX & 3];
+            fillRect.MaxX = (fillRect.MaxX & ~3) + 4;
+        }        
+        
+        // NOTE(Joey): distance in [0, 1] changes by 0.5/spread per texel; smooth the edge over
+        // the distance range that a single screen pixel covers.
+        real32 texelsPerPixel = Max((real32)texture->Width / Max(Length(axisX), 1.0f), 
+                                    (real32)texture->Height / Max(Length(axisY), 1.0f));
+        real32 edgeHalfWidth = Clamp(1.0f / 255.0f, 0.5f, 0.25f*texelsPerPixel / spread);
+        
+        const __m128 zero = _mm_set1_ps(0.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 four = _mm_set1_ps(4.0f);
+        const __m128i maskFF = _mm_set1_epi32(0xFF);
+        
+        const __m128 inv255_4x = _mm_set1_ps(1.0f / 255.0f);
+        const __m128 max255_4x = _mm_set1_ps(255.0f);
+        const __m128 edgeMin_4x = _mm_set1_ps(0.5f - edgeHalfWidth);
+        const __m128 invEdgeRange_4x = _mm_set1_ps(1.0f / (2.0f*edgeHalfWidth));
+        
+        const __m128 colorr_4x = _mm_set1_ps(255.0f*color.r);
+        const __m128 colorg_4x = _mm_set1_ps(255.0f*color.g);
+        const __m128 colorb_4x = _mm_set1_ps(255.0f*color.b);
+        const __m128 colora_4x = _mm_set1_ps(color.a);
+            
+        const __m128 mAxisXx   = _mm_set1_ps(axisX.x);
+        const __m128 mAxisXy   = _mm_set1_ps(axisX.y);
+        const __m128 mAxisYx   = _mm_set1_ps(axisY.x);
+        const __m128 mAxisYy   = _mm_set1_ps(axisY.y);
+        const __m128 positionX = _mm_set1_ps(position.x);
+        const __m128 positionY = _mm_set1_ps(position.y);    
+
+        const __m128 invSquareDotAxisX =  _mm_div_ps(one, _mm_add_ps(mmSquare(mAxisXx), mmSquare(mAxisXy))); 
+        const __m128 invSquareDotAxisY =  _mm_div_ps(one, _mm_add_ps(mmSquare(mAxisYx), mmSquare(mAxisYy))); 
+        const __m128 texWidthM2 = _mm_set1_ps((real32)texture->Width - 2);
+        const __m128 texHeightM2 = _mm_set1_ps((real32)texture->Height - 2);
+        const __m128i texturePitch_4x = _mm_set1_epi32(texture->Pitch);
         
         int minX = fillRect.MinX;
         int minY = fillRect.MinY;
@@ -172,8 +904,7 @@ internal void RenderTexture_(Texture *target,
             uint32 *dest = (uint32*)destRow;
             __m128i clipMask = startClipMask;
 
-            __m128 pixelPosY = _mm_set1_ps((real32)y);
-            __m128 dY = _mm_sub_ps(pixelPosY, positionY);
+            __m128 dY = _mm_sub_ps(_mm_set1_ps((real32)y), positionY);
             __m128 dYAxisXy = _mm_mul_ps(dY, mAxisXy);
             __m128 dYAxisYy = _mm_mul_ps(dY, mAxisYy);
   
@@ -185,30 +916,20 @@ internal void RenderTexture_(Texture *target,
                                
             for (int32 x = minX; x < maxX; x += 4)
             {
-                // TIMING(1): Per pixel CPU timing
-                // BeginCPUTiming(1);
-
-                // NOTE(Joey): pre-fetch destination memory at start
                 __m128i originalDest = _mm_loadu_si128((__m128i *)dest);
 
-                __m128 uNominator = _mm_add_ps(_mm_mul_ps(dX, mAxisXx), dYAxisXy);
-                __m128 U = _mm_mul_ps(invSquareDotAxisX, uNominator);
-                __m128 vNominator = _mm_add_ps(_mm_mul_ps(dX, mAxisYx), dYAxisYy);
-                __m128 V = _mm_mul_ps(invSquareDotAxisY, vNominator);                  
+                __m128 U = _mm_mul_ps(invSquareDotAxisX, _mm_add_ps(_mm_mul_ps(dX, mAxisXx), dYAxisXy));
+                __m128 V = _mm_mul_ps(invSquareDotAxisY, _mm_add_ps(_mm_mul_ps(dX, mAxisYx), dYAxisYy));
 
-                // NOTE(Joey): determine from UV whether we write pixels (none if out of range [0, 1])
                 __m128i writeMask = _mm_castps_si128(_mm_and_ps(_mm_and_ps(_mm_cmpge_ps(U, zero),
                                                      _mm_cmple_ps(U, one)),
                                                      _mm_and_ps(_mm_cmpge_ps(V, zero),
                                                      _mm_cmple_ps(V, one))));
                 writeMask = _mm_and_si128(writeMask, clipMask);
 
-                // NOTE(Joey): after determining write mask, clamp UV and fetch texels
                 U = _mm_min_ps(_mm_max_ps(U, zero), one);
                 V = _mm_min_ps(_mm_max_ps(V, zero), one);
                 
-                // NOTE(Joey): Bias texture coordinates to start on the boundary between 
-                // 0,0 and 1,1 pixels.
                 __m128 tX = _mm_add_ps(_mm_mul_ps(U, texWidthM2), half);
                 __m128 tY = _mm_add_ps(_mm_mul_ps(V, texHeightM2), half);
                 
@@ -222,106 +943,275 @@ internal void RenderTexture_(Texture *target,
                     _mm_slli_epi32(_mm_mulhi_epi16(fetchY_4x, texturePitch_4x), 16));
                 __m128i fetch_4x = _mm_add_epi32(fetchX_4x, fetchY_4x);
 
-                // NOTE(Joey): fetch 4 samples for bilinear blend
-                int32 fetch0 = Mi(fetch_4x, 0);
-                int32 fetch1 = Mi(fetch_4x, 1);
-                int32 fetch2 = Mi(fetch_4x, 2);
-                int32 fetch3 = Mi(fetch_4x, 3);
-
-                uint8 *texelPtr0 = ((uint8 *)texture->Texels) + fetch0;
-                uint8 *texelPtr1 = ((uint8 *)texture->Texels) + fetch1;
-                uint8 *texelPtr2 = ((uint8 *)texture->Texels) + fetch2;
-                uint8 *texelPtr3 = ((uint8 *)texture->Texels) + fetch3;
-
-                __m128i sampleA = _mm_setr_epi32(*(uint32 *)(texelPtr0),
-                                                 *(uint32 *)(texelPtr1),
-                                                 *(uint32 *)(texelPtr2),
-                                                 *(uint32 *)(texelPtr3));
-
-                __m128i sampleB = _mm_setr_epi32(*(uint32 *)(texelPtr0 + sizeof(uint32)),
-                                                 *(uint32 *)(texelPtr1 + sizeof(uint32)),
-                                                 *(uint32 *)(texelPtr2 + sizeof(uint32)),
-                                                 *(uint32 *)(texelPtr3 + sizeof(uint32)));
-
-                __m128i sampleC = _mm_setr_epi32(*(uint32 *)(texelPtr0 + texture->Pitch),
-                                                 *(uint32 *)(texelPtr1 + texture->Pitch),
-                                                 *(uint32 *)(texelPtr2 + texture->Pitch),
-                                                 *(uint32 *)(texelPtr3 + texture->Pitch));
-
-                __m128i sampleD = _mm_setr_epi32(*(uint32 *)(texelPtr0 + texture->Pitch + sizeof(uint32)),
-                                                 *(uint32 *)(texelPtr1 + texture->Pitch + sizeof(uint32)),
-                                                 *(uint32 *)(texelPtr2 + texture->Pitch + sizeof(uint32)),
-                                                 *(uint32 *)(texelPtr3 + texture->Pitch + sizeof(uint32)));
-
-                // NOTE(Joey): unpack bilinear samples
-                __m128i texelArb = _mm_and_si128(sampleA, maskFF00FF);
-                __m128i texelAag = _mm_and_si128(_mm_srli_epi32(sampleA, 8), maskFF00FF);
-                __m128 texelAa = _mm_cvtepi32_ps(_mm_srli_epi32(texelAag, 16));
-
-                __m128i texelBrb = _mm_and_si128(sampleB, maskFF00FF);
-                __m128i texelBag = _mm_and_si128(_mm_srli_epi32(sampleB, 8), maskFF00FF);
-                __m128 texelBa = _mm_cvtepi32_ps(_mm_srli_epi32(texelBag, 16));
-
-                __m128i texelCrb = _mm_and_si128(sampleC, maskFF00FF);
-                __m128i texelCag = _mm_and_si128(_mm_srli_epi32(sampleC, 8), maskFF00FF);
-                __m128 texelCa = _mm_cvtepi32_ps(_mm_srli_epi32(texelCag, 16));
-
-                __m128i texelDrb = _mm_and_si128(sampleD, maskFF00FF);
-                __m128i texelDag = _mm_and_si128(_mm_srli_epi32(sampleD, 8), maskFF00FF);
-                __m128 texelDa = _mm_cvtepi32_ps(_mm_srli_epi32(texelDag, 16));
-
-                // NOTE(Joey): Load destination
+                uint8 *texelPtr0 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 0);
+                uint8 *texelPtr1 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 1);
+                uint8 *texelPtr2 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 2);
+                uint8 *texelPtr3 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 3);
+
+                // NOTE(Joey): only the alpha channel holds distance data
+                __m128 distA = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_setr_epi32(*(uint32 *)(texelPtr0),
+                                                                             *(uint32 *)(texelPtr1),
+                                                                             *(uint32 *)(texelPtr2),
+                                                                             *(uint32 *)(texelPtr3)), 24));
+                __m128 distB = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_setr_epi32(*(uint32 *)(texelPtr0 + sizeof(uint32)),
+                                                                             *(uint32 *)(texelPtr1 + sizeof(uint32)),
+                                                                             *(uint32 *)(texelPtr2 + sizeof(uint32)),
+                                                                             *(uint32 *)(texelPtr3 + sizeof(uint32))), 24));
+                __m128 distC = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_setr_epi32(*(uint32 *)(texelPtr0 + texture->Pitch),
+                                                                             *(uint32 *)(texelPtr1 + texture->Pitch),
+                                                                             *(uint32 *)(texelPtr2 + texture->Pitch),
+                                                                             *(uint32 *)(texelPtr3 + texture->Pitch)), 24));
+                __m128 distD = _mm_cvtepi32_ps(_mm_srli_epi32(_mm_setr_epi32(*(uint32 *)(texelPtr0 + texture->Pitch + sizeof(uint32)),
+                                                                             *(uint32 *)(texelPtr1 + texture->Pitch + sizeof(uint32)),
+                                                                             *(uint32 *)(texelPtr2 + texture->Pitch + sizeof(uint32)),
+                                                                             *(uint32 *)(texelPtr3 + texture->Pitch + sizeof(uint32))), 24));
+                
+                __m128 ifX = _mm_sub_ps(one, fX);
+                __m128 ifY = _mm_sub_ps(one, fY);
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(ifY, ifX), distA), _mm_mul_ps(_mm_mul_ps(ifY, fX), distB)),
+                                             _mm_add_ps(_mm_mul_ps(_mm_mul_ps(fY, ifX), distC), _mm_mul_ps(_mm_mul_ps(fY, fX), distD)));
+                distance = _mm_mul_ps(distance, inv255_4x);
+                
+                // NOTE(Joey): smoothstep over the edge range
+                __m128 t = _mm_mul_ps(_mm_sub_ps(distance, edgeMin_4x), invEdgeRange_4x);
+                t = _mm_min_ps(_mm_max_ps(t, zero), one);
+                __m128 coverage = _mm_mul_ps(mmSquare(t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+                __m128 alpha = _mm_mul_ps(coverage, colora_4x);
+                __m128 invAlpha = _mm_sub_ps(one, alpha);
+                
                 __m128 destb = _mm_cvtepi32_ps(_mm_and_si128(originalDest, maskFF));
                 __m128 destg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 8), maskFF));
                 __m128 destr = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 16), maskFF));
                 __m128 desta = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 24), maskFF));
+                
+                __m128 blendedr = _mm_add_ps(_mm_mul_ps(invAlpha, destr), _mm_mul_ps(alpha, colorr_4x));
+                __m128 blendedg = _mm_add_ps(_mm_mul_ps(invAlpha, destg), _mm_mul_ps(alpha, colorg_4x));
+                __m128 blendedb = _mm_add_ps(_mm_mul_ps(invAlpha, destb), _mm_mul_ps(alpha, colorb_4x));
+                __m128 blendeda = _mm_add_ps(_mm_mul_ps(invAlpha, desta), _mm_mul_ps(alpha, max255_4x));
+                
+                __m128i out = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(blendedr), 16), 
+                                                        _mm_slli_epi32(_mm_cvtps_epi32(blendedg), 8)),
+                                           _mm_or_si128(_mm_cvtps_epi32(blendedb), 
+                                                        _mm_slli_epi32(_mm_cvtps_epi32(blendeda), 24)));
+                
+                __m128i maskedOut = _mm_or_si128(_mm_and_si128(writeMask, out),
+                                                 _mm_andnot_si128(writeMask, originalDest));
+                _mm_storeu_si128((__m128i *)dest, maskedOut);
+ 
+                dest += 4; 
+                dX = _mm_add_ps(dX, four);
+                
+                if((x + 8) < maxX)
+                    clipMask = _mm_set1_epi8(-1);
+                else
+                    clipMask = endClipMask;
+            }
+            destRow += destPitch;
+        }
+    }
+}
 
-                // NOTE(Joey): extract individual texel components and cvt. to real.
-                __m128 texelAr = _mm_cvtepi32_ps(_mm_srli_epi32(texelArb, 16));
-                __m128 texelAg = _mm_cvtepi32_ps(_mm_and_si128(texelAag, maskFFFF));
-                __m128 texelAb = _mm_cvtepi32_ps(_mm_and_si128(texelArb, maskFFFF));
-
-                __m128 texelBr = _mm_cvtepi32_ps(_mm_srli_epi32(texelBrb, 16));
-                __m128 texelBg = _mm_cvtepi32_ps(_mm_and_si128(texelBag, maskFFFF));
-                __m128 texelBb = _mm_cvtepi32_ps(_mm_and_si128(texelBrb, maskFFFF));
+/* NOTE(Joey):
 
-                __m128 texelCr = _mm_cvtepi32_ps(_mm_srli_epi32(texelCrb, 16));
-                __m128 texelCg = _mm_cvtepi32_ps(_mm_and_si128(texelCag, maskFFFF));
-                __m128 texelCb = _mm_cvtepi32_ps(_mm_and_si128(texelCrb, maskFFFF));
+  Half-space triangle rasterizer. Each edge defines an edge function 
+  E(p) = A*p.x + B*p.y + C that is positive on the inside of the (counter
+  clockwise) triangle; a pixel is covered if all three are. Edge functions
+  are evaluated at pixel centers for a block of 4 pixels at once and 
+  stepped incrementally along a row. The edge functions double as 
+  barycentric weights (E_i / area) for interpolating texture coordinates.
 
-                __m128 texelDr = _mm_cvtepi32_ps(_mm_srli_epi32(texelDrb, 16));
-                __m128 texelDg = _mm_cvtepi32_ps(_mm_and_si128(texelDag, maskFFFF));
-                __m128 texelDb = _mm_cvtepi32_ps(_mm_and_si128(texelDrb, maskFFFF));
-                
-                // NOTE(Joey): bilinear texture filtering
-                __m128 ifX = _mm_sub_ps(one, fX);
-                __m128 ifY = _mm_sub_ps(one, fY);
+  A top-left fill rule guarantees that pixels on an edge shared by two 
+  triangles (e.g. in a polygon fan) are only drawn once.
+  
+*/
+internal void RenderTriangle_(Texture *target,
+                              Texture *texture,
+                              vector2D *vertices,
+                              vector2D *uvs,
+                              rectangle2Di clipRect,
+                              vector4D color)
+{
+    TIMING_BLOCK();
+    Assert(!texture || texture->Format == TEXTURE_FORMAT_ARGB32);
+    
+    vector2D v[3]  = { vertices[0], vertices[1], vertices[2] };
+    vector2D uv[3] = { uvs[0], uvs[1], uvs[2] };
+    
+    // NOTE(Joey): make sure triangle winding is counter-clockwise
+    real32 area = (v[1].x - v[0].x)*(v[2].y - v[0].y) - (v[1].y - v[0].y)*(v[2].x - v[0].x);
+    if(area == 0.0f)
+        return;
+    if(area < 0.0f)
+    {
+        vector2D tmp = v[1];  v[1]  = v[2];  v[2]  = tmp;
+        tmp          = uv[1]; uv[1] = uv[2]; uv[2] = tmp;
+        area = -area;
+    }
+    real32 invArea = 1.0f / area;
+    
+    // NOTE(Joey): edge i lies opposite of vertex i
+    real32 edgeA[3], edgeB[3], edgeC[3];
+    bool32 edgeTopLeft[3];
+    for(int i = 0; i < 3; ++i)
+    {
+        vector2D a = v[(i + 1) % 3];
+        vector2D b = v[(i + 2) % 3];
+        edgeA[i] = a.y - b.y;
+        edgeB[i] = b.x - a.x;
+        edgeC[i] = -(edgeA[i]*a.x + edgeB[i]*a.y);
+        edgeTopLeft[i] = edgeA[i] > 0.0f || (edgeA[i] == 0.0f && edgeB[i] < 0.0f);
+    }
+    
+    rectangle2Di fillRect = InvertedInfinityRectangle();
+    for(int i = 0; i < 3; ++i)
+    {
+        fillRect.MinX = Minimum(fillRect.MinX, FloorReal32ToInt32(v[i].x));
+        fillRect.MinY = Minimum(fillRect.MinY, FloorReal32ToInt32(v[i].y));
+        fillRect.MaxX = Maximum(fillRect.MaxX, CeilReal32ToInt32(v[i].x));
+        fillRect.MaxY = Maximum(fillRect.MaxY, CeilReal32ToInt32(v[i].y));
+    }
+    fillRect = Intersect(clipRect, fillRect);
+    if(!HasArea(fillRect))
+        return;
+    
+    // NOTE(Joey): align to 4-pixel blocks; lanes outside the clip rect are masked out
+    int32 clipMaxX = fillRect.MaxX;
+    fillRect.MinX = fillRect.MinX & ~3;
+    fillRect.MaxX = (fillRect.MaxX + 3) & ~3;
+    Assert(fillRect.MinX >= clipRect.MinX);
+    
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128i maskFF = _mm_set1_epi32(0xFF);
+    const __m128i maskFFFF = _mm_set1_epi32(0xFFFF);
+    const __m128i maskFF00FF = _mm_set1_epi32(0x00FF00FF);
+    const __m128 inv255_4x = _mm_set1_ps(1.0f / 255.0f);
+    const __m128 maxColorValue = _mm_set1_ps(255.0f);
+    const __m128 colorr_4x = _mm_set1_ps(color.r);
+    const __m128 colorg_4x = _mm_set1_ps(color.g);
+    const __m128 colorb_4x = _mm_set1_ps(color.b);
+    const __m128 colora_4x = _mm_set1_ps(color.a);
+    const __m128i clipMaxX_4x = _mm_set1_epi32(clipMaxX);
+    const __m128 invArea_4x = _mm_set1_ps(invArea);
+    
+    __m128 edgeA_4x[3], edgeStep_4x[3];
+    for(int i = 0; i < 3; ++i)
+    {
+        edgeA_4x[i]    = _mm_set1_ps(edgeA[i]);
+        edgeStep_4x[i] = _mm_set1_ps(4.0f*edgeA[i]);
+    }
+    
+    __m128 texWidthM2 = zero;
+    __m128 texHeightM2 = zero;
+    __m128i texturePitch_4x = _mm_setzero_si128();
+    if(texture)
+    {
+        texWidthM2 = _mm_set1_ps((real32)texture->Width - 2);
+        texHeightM2 = _mm_set1_ps((real32)texture->Height - 2);
+        texturePitch_4x = _mm_set1_epi32(texture->Pitch);
+    }
+    
+    uint8 *destRow = (uint8*)target->Texels + fillRect.MinY*target->Pitch + fillRect.MinX*sizeof(uint32);
+    for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y)
+    {
+        uint32 *dest = (uint32*)destRow;
+        
+        // NOTE(Joey): evaluate edge functions at the pixel centers of the first block in this row
+        real32 pixelY = (real32)y + 0.5f;
+        __m128 pixelX = _mm_add_ps(_mm_setr_ps((real32)(fillRect.MinX + 0),
+                                               (real32)(fillRect.MinX + 1),
+                                               (real32)(fillRect.MinX + 2),
+                                               (real32)(fillRect.MinX + 3)), half);
+        __m128 edge[3];
+        for(int i = 0; i < 3; ++i)
+            edge[i] = _mm_add_ps(_mm_mul_ps(edgeA_4x[i], pixelX), _mm_set1_ps(edgeB[i]*pixelY + edgeC[i]));
+        __m128i pixelXi = _mm_setr_epi32(fillRect.MinX + 0, fillRect.MinX + 1, fillRect.MinX + 2, fillRect.MinX + 3);
+        
+        for(int32 x = fillRect.MinX; x < fillRect.MaxX; x += 4)
+        {
+            __m128 inside = _mm_castsi128_ps(_mm_cmplt_epi32(pixelXi, clipMaxX_4x));
+            for(int i = 0; i < 3; ++i)
+                inside = _mm_and_ps(inside, edgeTopLeft[i] ? _mm_cmpge_ps(edge[i], zero) : _mm_cmpgt_ps(edge[i], zero));
+            __m128i writeMask = _mm_castps_si128(inside);
             
-                __m128 l0 = _mm_mul_ps(ifY, ifX);
-                __m128 l1 = _mm_mul_ps(ifY, fX);
-                __m128 l2 = _mm_mul_ps(fY, ifX);
-                __m128 l3 = _mm_mul_ps(fY, fX);
-
-                __m128 texelr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAr), _mm_mul_ps(l1, texelBr)),
-                                           _mm_add_ps(_mm_mul_ps(l2, texelCr), _mm_mul_ps(l3, texelDr)));
-                __m128 texelg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAg), _mm_mul_ps(l1, texelBg)),
-                                           _mm_add_ps(_mm_mul_ps(l2, texelCg), _mm_mul_ps(l3, texelDg)));
-                __m128 texelb = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAb), _mm_mul_ps(l1, texelBb)),
-                                           _mm_add_ps(_mm_mul_ps(l2, texelCb), _mm_mul_ps(l3, texelDb)));
-                __m128 texela = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, texelAa), _mm_mul_ps(l1, texelBa)),
-                                           _mm_add_ps(_mm_mul_ps(l2, texelCa), _mm_mul_ps(l3, texelDa)));
-
-                // NOTE(Joey): Modulate by color
-                texelr = _mm_mul_ps(texelr, colorr_4x);
-                texelg = _mm_mul_ps(texelg, colorg_4x);
-                texelb = _mm_mul_ps(texelb, colorb_4x);
-                texela = _mm_mul_ps(texela, colora_4x);
+            if(_mm_movemask_ps(inside))
+            {
+                __m128i originalDest = _mm_loadu_si128((__m128i *)dest);
+                
+                __m128 texelr = _mm_mul_ps(colorr_4x, maxColorValue);
+                __m128 texelg = _mm_mul_ps(colorg_4x, maxColorValue);
+                __m128 texelb = _mm_mul_ps(colorb_4x, maxColorValue);
+                __m128 texela = _mm_mul_ps(colora_4x, maxColorValue);
+                if(texture)
+                {
+                    // NOTE(Joey): interpolate texture coordinates with barycentric weights
+                    __m128 w0 = _mm_mul_ps(edge[0], invArea_4x);
+                    __m128 w1 = _mm_mul_ps(edge[1], invArea_4x);
+                    __m128 w2 = _mm_mul_ps(edge[2], invArea_4x);
+                    __m128 U = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, _mm_set1_ps(uv[0].x)), 
+                                                     _mm_mul_ps(w1, _mm_set1_ps(uv[1].x))),
+                                                     _mm_mul_ps(w2, _mm_set1_ps(uv[2].x)));
+                    __m128 V = _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, _mm_set1_ps(uv[0].y)), 
+                                                     _mm_mul_ps(w1, _mm_set1_ps(uv[1].y))),
+                                                     _mm_mul_ps(w2, _mm_set1_ps(uv[2].y)));
+                    U = _mm_min_ps(_mm_max_ps(U, zero), one);
+                    V = _mm_min_ps(_mm_max_ps(V, zero), one);
+                    
+                    __m128 tX = _mm_add_ps(_mm_mul_ps(U, texWidthM2), half);
+                    __m128 tY = _mm_add_ps(_mm_mul_ps(V, texHeightM2), half);
+                    __m128i fetchX_4x = _mm_cvttps_epi32(tX);
+                    __m128i fetchY_4x = _mm_cvttps_epi32(tY);
+                    __m128 fX = _mm_sub_ps(tX, _mm_cvtepi32_ps(fetchX_4x));
+                    __m128 fY = _mm_sub_ps(tY, _mm_cvtepi32_ps(fetchY_4x));
+                    
+                    fetchX_4x = _mm_slli_epi32(fetchX_4x, 2);
+                    fetchY_4x = _mm_or_si128(_mm_mullo_epi16(fetchY_4x, texturePitch_4x),
+                        _mm_slli_epi32(_mm_mulhi_epi16(fetchY_4x, texturePitch_4x), 16));
+                    __m128i fetch_4x = _mm_add_epi32(fetchX_4x, fetchY_4x);
+                    
+                    uint8 *texelPtr0 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 0);
+                    uint8 *texelPtr1 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 1);
+                    uint8 *texelPtr2 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 2);
+                    uint8 *texelPtr3 = ((uint8 *)texture->Texels) + Mi(fetch_4x, 3);
+                    
+                    __m128i samples[4];
+                    uint32 offsets[4] = { 0, (uint32)sizeof(uint32), texture->Pitch, texture->Pitch + (uint32)sizeof(uint32) };
+                    for(int i = 0; i < 4; ++i)
+                        samples[i] = _mm_setr_epi32(*(uint32 *)(texelPtr0 + offsets[i]),
+                                                    *(uint32 *)(texelPtr1 + offsets[i]),
+                                                    *(uint32 *)(texelPtr2 + offsets[i]),
+                                                    *(uint32 *)(texelPtr3 + offsets[i]));
+                    
+                    // NOTE(Joey): bilinear texture filtering
+                    __m128 ifX = _mm_sub_ps(one, fX);
+                    __m128 ifY = _mm_sub_ps(one, fY);
+                    __m128 weights[4] = { _mm_mul_ps(ifY, ifX), _mm_mul_ps(ifY, fX),
+                                          _mm_mul_ps(fY, ifX),  _mm_mul_ps(fY, fX) };
+                    __m128 sampler = zero, sampleg = zero, sampleb = zero, samplea = zero;
+                    for(int i = 0; i < 4; ++i)
+                    {
+                        __m128i rb = _mm_and_si128(samples[i], maskFF00FF);
+                        __m128i ag = _mm_and_si128(_mm_srli_epi32(samples[i], 8), maskFF00FF);
+                        sampler = _mm_add_ps(sampler, _mm_mul_ps(weights[i], _mm_cvtepi32_ps(_mm_srli_epi32(rb, 16))));
+                        sampleg = _mm_add_ps(sampleg, _mm_mul_ps(weights[i], _mm_cvtepi32_ps(_mm_and_si128(ag, maskFFFF))));
+                        sampleb = _mm_add_ps(sampleb, _mm_mul_ps(weights[i], _mm_cvtepi32_ps(_mm_and_si128(rb, maskFFFF))));
+                        samplea = _mm_add_ps(samplea, _mm_mul_ps(weights[i], _mm_cvtepi32_ps(_mm_srli_epi32(ag, 16))));
+                    }
+                    
+                    // NOTE(Joey): modulate by color
+                    texelr = _mm_min_ps(_mm_mul_ps(sampler, colorr_4x), maxColorValue);
+                    texelg = _mm_min_ps(_mm_mul_ps(sampleg, colorg_4x), maxColorValue);
+                    texelb = _mm_min_ps(_mm_mul_ps(sampleb, colorb_4x), maxColorValue);
+                    texela = _mm_mul_ps(samplea, colora_4x);
+                }
                 
-                texelr = _mm_min_ps(_mm_max_ps(texelr, zero), maxColorValue);
-                texelg = _mm_min_ps(_mm_max_ps(texelg, zero), maxColorValue);
-                texelb = _mm_min_ps(_mm_max_ps(texelb, zero), maxColorValue);
-
                 // NOTE(Joey): destination/framebuffer blend
+                __m128 destb = _mm_cvtepi32_ps(_mm_and_si128(originalDest, maskFF));
+                __m128 destg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 8), maskFF));
+                __m128 destr = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 16), maskFF));
+                __m128 desta = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 24), maskFF));
+                
                 __m128 mulAlpha  = _mm_mul_ps(inv255_4x, texela);
                 __m128 invTexelA = _mm_sub_ps(one, mulAlpha);
                 __m128 blendedr = _mm_add_ps(_mm_mul_ps(invTexelA, destr), _mm_mul_ps(mulAlpha, texelr));
@@ -329,39 +1219,173 @@ internal void RenderTexture_(Texture *target,
                 __m128 blendedb = _mm_add_ps(_mm_mul_ps(invTexelA, destb), _mm_mul_ps(mulAlpha, texelb));
                 __m128 blendeda = _mm_add_ps(_mm_mul_ps(invTexelA, desta), _mm_mul_ps(mulAlpha, texela));
                 
-                    
-                // NOTE(Joey): write back to framebuffer memory
-                __m128i intr = _mm_cvtps_epi32(blendedr);
-                __m128i intg = _mm_cvtps_epi32(blendedg);
-                __m128i intb = _mm_cvtps_epi32(blendedb);
-                __m128i inta = _mm_cvtps_epi32(blendeda);
-                // NOTE(Joey): pack to windows destination RGBA format
-                __m128i sr = _mm_slli_epi32(intr, 16);
-                __m128i sg = _mm_slli_epi32(intg, 8);
-                __m128i sb = intb;
-                __m128i sa = _mm_slli_epi32(inta, 24);
-                __m128i out = _mm_or_si128(_mm_or_si128(sr, sg), _mm_or_si128(sb, sa));
+                __m128i out = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_cvtps_epi32(blendedr), 16),
+                                                        _mm_slli_epi32(_mm_cvtps_epi32(blendedg), 8)),
+                                           _mm_or_si128(_mm_cvtps_epi32(blendedb),
+                                                        _mm_slli_epi32(_mm_cvtps_epi32(blendeda), 24)));
                 
-                // NOTE(Joey): only write to memory where mask bits are set
-                __m128i maskedOut = _mm_or_si128(_mm_and_si128(writeMask, out),
-                                                 _mm_andnot_si128(writeMask, originalDest));
-                _mm_storeu_si128((__m128i *)dest, maskedOut);
- 
-                dest += 4; 
-                dX = _mm_add_ps(dX, four);
-                clipMask = _mm_set1_epi8(-1);
-                
-                if((x + 8) < maxX)
-                    clipMask = _mm_set1_epi8(-1);
+                // NOTE(Joey): only write to memory where mask bits are set; a block crossing the 
+                // clip rect may overlap pixels owned by another tile so those are never touched.
+                if(x + 4 > clipMaxX)
+                {
+                    _mm_maskmoveu_si128(out, writeMask, (char*)dest);
+                }
                 else
-                    clipMask = endClipMask;
+                {
+                    __m128i maskedOut = _mm_or_si128(_mm_and_si128(writeMask, out),
+                                                     _mm_andnot_si128(writeMask, originalDest));
+                    _mm_storeu_si128((__m128i *)dest, maskedOut);
+                }
+            }
+            
+            // NOTE(Joey): step edge functions to the next block
+            for(int i = 0; i < 3; ++i)
+                edge[i] = _mm_add_ps(edge[i], edgeStep_4x[i]);
+            pixelXi = _mm_add_epi32(pixelXi, _mm_set1_epi32(4));
+            dest += 4;
+        }
+        destRow += target->Pitch;
+    }
+}
+
+// NOTE(Joey): unscaled axis-aligned copy for pre-rendered content (e.g. cached tilemap chunks).
+// Alpha-keyed: texels with alpha >= 128 replace the destination, the rest are skipped.
+internal void RenderBlit_(Texture *target,
+                          Texture *texture,
+                          vector2D position,
+                          rectangle2Di clipRect)
+{
+    TIMING_BLOCK();
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+    
+    int32 originX = RoundReal32ToInt32(position.x);
+    int32 originY = RoundReal32ToInt32(position.y);
+    rectangle2Di fillRect = { originX, originY, originX + texture->Width, originY + texture->Height };
+    fillRect = Intersect(clipRect, fillRect);
+    if(!HasArea(fillRect))
+        return;
+    
+    const __m128i alphaThreshold = _mm_set1_epi32(127);
+    int32 width = fillRect.MaxX - fillRect.MinX;
+    int32 width4 = width & ~3;
+    
+    uint8 *sourceRow = (uint8*)texture->Texels + (fillRect.MinY - originY)*texture->Pitch + (fillRect.MinX - originX)*sizeof(uint32);
+    uint8 *destRow = (uint8*)target->Texels + fillRect.MinY*target->Pitch + fillRect.MinX*sizeof(uint32);
+    for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y)
+    {
+        uint32 *source = (uint32*)sourceRow;
+        uint32 *dest = (uint32*)destRow;
+        for(int32 x = 0; x < width4; x += 4)
+        {
+            __m128i texels = _mm_loadu_si128((__m128i*)(source + x));
+            __m128i originalDest = _mm_loadu_si128((__m128i*)(dest + x));
+            __m128i writeMask = _mm_cmpgt_epi32(_mm_srli_epi32(texels, 24), alphaThreshold);
+            __m128i out = _mm_or_si128(_mm_and_si128(writeMask, texels), _mm_andnot_si128(writeMask, originalDest));
+            _mm_storeu_si128((__m128i*)(dest + x), out);
+        }
+        for(int32 x = width4; x < width; ++x)
+        {
+            if((source[x] >> 24) > 127)
+                dest[x] = source[x];
+        }
+        sourceRow += texture->Pitch;
+        destRow += target->Pitch;
+    }
+}
+
+/* NOTE(Joey):
+
+  Unscaled, axis-aligned blit that alpha blends the texture (straight alpha)
+  with the same blend equation as RenderTexture_. Blending is done in 16-bit
+  integer lanes, 2 pixels per register, where out = (s*a + d*(255 - a))/255
+  with the divide done as a multiply by 257 and a 16-bit shift.
+
+  Groups of 4 texels that are fully transparent or fully opaque skip the
+  blend, which covers most texels of a typical sprite.
+
+*/
+internal void RenderBlitBlended_(Texture *target,
+                                 Texture *texture,
+                                 vector2D position,
+                                 rectangle2Di clipRect)
+{
+    TIMING_BLOCK();
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+
+    int32 originX = RoundReal32ToInt32(position.x);
+    int32 originY = RoundReal32ToInt32(position.y);
+    rectangle2Di fillRect = { originX, originY, originX + texture->Width, originY + texture->Height };
+    fillRect = Intersect(clipRect, fillRect);
+    if(!HasArea(fillRect))
+        return;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    const __m128i maskFF_16x = _mm_set1_epi16(0xFF);
+    const __m128i round_16x = _mm_set1_epi16(128);
+    const __m128i div255_16x = _mm_set1_epi16(257);
+    int32 width = fillRect.MaxX - fillRect.MinX;
+    int32 width4 = width & ~3;
+
+    uint8 *sourceRow = (uint8*)texture->Texels + (fillRect.MinY - originY)*texture->Pitch + (fillRect.MinX - originX)*sizeof(uint32);
+    uint8 *destRow = (uint8*)target->Texels + fillRect.MinY*target->Pitch + fillRect.MinX*sizeof(uint32);
+    for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y)
+    {
+        uint32 *source = (uint32*)sourceRow;
+        uint32 *dest = (uint32*)destRow;
+        for(int32 x = 0; x < width4; x += 4)
+        {
+            __m128i texels = _mm_loadu_si128((__m128i*)(source + x));
+            __m128i alpha = _mm_and_si128(texels, alphaMask);
+            if(_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) == 0xFFFF)
+                continue;
+            if(_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphaMask)) == 0xFFFF)
+            {
+                _mm_storeu_si128((__m128i*)(dest + x), texels);
+                continue;
+            }
+
+            __m128i originalDest = _mm_loadu_si128((__m128i*)(dest + x));
+            __m128i sourceLo = _mm_unpacklo_epi8(texels, zero);
+            __m128i sourceHi = _mm_unpackhi_epi8(texels, zero);
+            __m128i destLo = _mm_unpacklo_epi8(originalDest, zero);
+            __m128i destHi = _mm_unpackhi_epi8(originalDest, zero);
+
+            // NOTE(Joey): broadcast each pixel's alpha (16-bit lane 3) over its 4 channel lanes
+            __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sourceLo, 0xFF), 0xFF);
+            __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sourceHi, 0xFF), 0xFF);
+            __m128i invAlphaLo = _mm_sub_epi16(maskFF_16x, alphaLo);
+            __m128i invAlphaHi = _mm_sub_epi16(maskFF_16x, alphaHi);
 
-                // EndCPUTiming(1, 4);
+            __m128i blendedLo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(sourceLo, alphaLo), _mm_mullo_epi16(destLo, invAlphaLo)), round_16x);
+            __m128i blendedHi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(sourceHi, alphaHi), _mm_mullo_epi16(destHi, invAlphaHi)), round_16x);
+            blendedLo = _mm_mulhi_epu16(blendedLo, div255_16x);
+            blendedHi = _mm_mulhi_epu16(blendedHi, div255_16x);
+
+            _mm_storeu_si128((__m128i*)(dest + x), _mm_packus_epi16(blendedLo, blendedHi));
+        }
+        for(int32 x = width4; x < width; ++x)
+        {
+            uint32 texel = source[x];
+            uint32 alpha = texel >> 24;
+            if(alpha == 0xFF)
+                dest[x] = texel;
+            else if(alpha)
+            {
+                uint32 out = 0;
+                for(uint32 shift = 0; shift < 32; shift += 8)
+                {
+                    uint32 s = (texel >> shift) & 0xFF;
+                    uint32 d = (dest[x] >> shift) & 0xFF;
+                    uint32 blended = s*alpha + d*(255 - alpha) + 128;
+                    out |= ((blended*257) >> 16) << shift;
+                }
+                dest[x] = out;
             }
-            destRow += destPitch;
         }
+        sourceRow += texture->Pitch;
+        destRow += target->Pitch;
     }
-    // EndCPUTiming(0);
 }
 
 ///////////////////////////////
@@ -12,6 +12,14 @@
 #ifndef RENDER_PRIMITIVES_H
 #define RENDER_PRIMITIVES_H
 
+const uint32 ROW_SEGMENT_MAX_COUNT = 32;
+
+// NOTE(Joey): [MinX, MaxX) pixel range of a single row that's rasterized
+struct row_segment
+{
+    int32 MinX;
+    int32 MaxX;
+};
 
 
 #endif
\ No newline at end of file
@@ -17,6 +17,7 @@ internal RenderQueue *CreateRenderQueue(memory_arena *arena, uint32 maxRenderCou
     queue->RenderCount = 0;
     queue->MaxRenderCount = maxRenderCount;
     queue->RenderItems = PushArray(arena, maxRenderCount, RenderQueueItem);    
+    queue->ItemBounds = PushArray(arena, maxRenderCount, rectangle2Di);
     
     return queue;
 }
@@ -33,6 +34,7 @@ internal void PushRectangle(RenderQueue *queue,
     Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
     RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
     
+    renderItem->Type     = RENDER_TYPE_RECTANGLE;
     renderItem->Position = position;
     renderItem->Depth    = depth;
     renderItem->Basis[0] = vector2D { 1.0f, 0.0f };
@@ -54,13 +56,15 @@ internal void PushTexture(RenderQueue *queue,
                           vector2D size, 
                           vector2D basisX, 
                           vector2D basisY, 
-                          vector4D color)
+                          vector4D color,
+                          texture_sampler sampler = TextureSampler())
 {
     if(texture && texture->Texels)
     {
         Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
         RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
         
+        renderItem->Type     = RENDER_TYPE_TEXTURE;
         renderItem->Position = position;
         renderItem->Depth    = depth;
         renderItem->Basis[0] = basisX;
@@ -68,6 +72,7 @@ internal void PushTexture(RenderQueue *queue,
         renderItem->Size     = size;
         renderItem->Texture  = texture;
         renderItem->Color    = color;
+        renderItem->Sampler  = sampler;
         
         queue->RenderCount += 1;
     }
@@ -85,3 +90,265 @@ internal void PushTexture(RenderQueue *queue,
     PushTexture(queue, texture, position, depth, size, basisX, basisY, color); 
 }
 
+internal void PushTexture(RenderQueue *queue, 
+                          Texture *texture, 
+                          vector2D position, 
+                          uint32 depth,
+                          vector2D size, 
+                          texture_sampler sampler,
+                          vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    vector2D basisX = { 1.0f, 0.0f };
+    vector2D basisY = { 0.0f, 1.0f };
+    PushTexture(queue, texture, position, depth, size, basisX, basisY, color, sampler); 
+}
+
+///////////////////////////////////////////////
+//      SIGNED DISTANCE FIELD RENDER OVERLOADS
+///////////////////////////////////////////////
+internal void PushTextureSDF(RenderQueue *queue, 
+                             Texture *texture, 
+                             vector2D position, 
+                             uint32 depth,
+                             vector2D size, 
+                             vector2D basisX, 
+                             vector2D basisY, 
+                             vector4D color,
+                             real32 spread)
+{
+    if(texture && texture->Texels)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type      = RENDER_TYPE_TEXTURE_SDF;
+        renderItem->Position  = position;
+        renderItem->Depth     = depth;
+        renderItem->Basis[0]  = basisX;
+        renderItem->Basis[1]  = basisY;
+        renderItem->Size      = size;
+        renderItem->Texture   = texture;
+        renderItem->Color     = color;
+        renderItem->SDFSpread = spread;
+        
+        queue->RenderCount += 1;
+    }
+}
+
+internal void PushTextureSDF(RenderQueue *queue, 
+                             Texture *texture, 
+                             vector2D position, 
+                             uint32 depth,
+                             vector2D size, 
+                             real32 spread,
+                             vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    vector2D basisX = { 1.0f, 0.0f };
+    vector2D basisY = { 0.0f, 1.0f };
+    PushTextureSDF(queue, texture, position, depth, size, basisX, basisY, color, spread); 
+}
+
+///////////////////////////////////////////////
+//      TRIANGLE|POLYGON RENDER OVERLOADS
+///////////////////////////////////////////////
+internal void PushTriangle(RenderQueue *queue,
+                           Texture *texture,
+                           vector2D v0, vector2D v1, vector2D v2,
+                           vector2D uv0, vector2D uv1, vector2D uv2,
+                           uint32 depth,
+                           vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    // NOTE(Joey): textured triangles are skipped while their texture is still being loaded
+    if(!texture || texture->Texels)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type        = RENDER_TYPE_TRIANGLE;
+        renderItem->Position    = (1.0f / 3.0f)*(v0 + v1 + v2);
+        renderItem->Depth       = depth;
+        renderItem->Texture     = texture;
+        renderItem->Color       = color;
+        renderItem->Vertices[0] = v0;
+        renderItem->Vertices[1] = v1;
+        renderItem->Vertices[2] = v2;
+        renderItem->UVs[0]      = uv0;
+        renderItem->UVs[1]      = uv1;
+        renderItem->UVs[2]      = uv2;
+        
+        queue->RenderCount += 1;
+    }
+}
+
+internal void PushTriangle(RenderQueue *queue,
+                           vector2D v0, vector2D v1, vector2D v2,
+                           uint32 depth,
+                           vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    vector2D uv = { 0.0f, 0.0f };
+    PushTriangle(queue, 0, v0, v1, v2, uv, uv, uv, depth, color);
+}
+
+// NOTE(Joey): polygons have to be convex; they're split in a triangle fan around the first vertex
+internal void PushPolygon(RenderQueue *queue,
+                          Texture *texture,
+                          vector2D *vertices,
+                          vector2D *uvs,
+                          uint32 vertexCount,
+                          uint32 depth,
+                          vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    Assert(vertexCount >= 3);
+    for(uint32 i = 1; i < vertexCount - 1; ++i)
+    {
+        PushTriangle(queue, texture,
+                     vertices[0], vertices[i], vertices[i + 1],
+                     uvs[0], uvs[i], uvs[i + 1],
+                     depth, color);
+    }
+}
+
+internal void PushPolygon(RenderQueue *queue,
+                          vector2D *vertices,
+                          uint32 vertexCount,
+                          uint32 depth,
+                          vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    Assert(vertexCount >= 3);
+    for(uint32 i = 1; i < vertexCount - 1; ++i)
+        PushTriangle(queue, vertices[0], vertices[i], vertices[i + 1], depth, color);
+}
+
+///////////////////////////////////////////////
+//      PARTICLE RENDER OVERLOADS
+///////////////////////////////////////////////
+// NOTE(Joey): an entire particle batch is a single render item; see PrepareParticleBatch
+internal void PushParticles(RenderQueue *queue, particle_render_batch *batch, uint32 depth)
+{
+    if(batch && batch->ParticleCount > 0)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type      = RENDER_TYPE_PARTICLES;
+        renderItem->Position  = { 0.0f, 0.0f };
+        renderItem->Depth     = depth;
+        renderItem->Texture   = 0;
+        renderItem->Particles = batch;
+        
+        queue->RenderCount += 1;
+    }
+}
+
+///////////////////////////////////////////////
+//      BLIT RENDER OVERLOADS
+///////////////////////////////////////////////
+// NOTE(Joey): unscaled, axis-aligned copy with position as bottom-left pixel; see RenderBlit_
+internal void PushBlit(RenderQueue *queue, Texture *texture, vector2D position, uint32 depth)
+{
+    if(texture && texture->Texels)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type     = RENDER_TYPE_BLIT;
+        renderItem->Position = position;
+        renderItem->Depth    = depth;
+        renderItem->Size     = { (real32)texture->Width, (real32)texture->Height };
+        renderItem->Texture  = texture;
+        
+        queue->RenderCount += 1;
+    }
+}
+
+// NOTE(Joey): same as PushBlit, but texels are alpha blended (straight alpha); see RenderBlitBlended_
+internal void PushBlitBlended(RenderQueue *queue, Texture *texture, vector2D position, uint32 depth)
+{
+    if(texture && texture->Texels)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type     = RENDER_TYPE_BLIT_BLENDED;
+        renderItem->Position = position;
+        renderItem->Depth    = depth;
+        renderItem->Size     = { (real32)texture->Width, (real32)texture->Height };
+        renderItem->Texture  = texture;
+        
+        queue->RenderCount += 1;
+    }
+}
+
+///////////////////////////////////////////////
+//      VIRTUAL TEXTURE RENDER OVERLOADS
+///////////////////////////////////////////////
+// NOTE(Joey): axis-aligned only; see RenderVirtualTexture_
+internal void PushVirtualTexture(RenderQueue *queue, 
+                                 virtual_texture *texture, 
+                                 vector2D position, 
+                                 uint32 depth,
+                                 vector2D size, 
+                                 vector4D color = { 1.0f, 1.0f, 1.0f, 1.0f })
+{
+    if(texture)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type           = RENDER_TYPE_VIRTUAL_TEXTURE;
+        renderItem->Position       = position;
+        renderItem->Depth          = depth;
+        renderItem->Size           = size;
+        renderItem->Texture        = 0;
+        renderItem->VirtualTexture = texture;
+        renderItem->Color          = color;
+        
+        queue->RenderCount += 1;
+    }
+}
+
+#if INTERNAL
+///////////////////////////////////////////////
+//      DEBUG DRAW OVERLOADS
+///////////////////////////////////////////////
+// NOTE(Joey): all debug shapes of a frame are a single render item; see PrepareDebugDrawBatch
+internal void PushDebugDraw(RenderQueue *queue, debug_draw_batch *batch, uint32 depth)
+{
+    if(batch && batch->ShapeCount > 0)
+    {
+        Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+        RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+        
+        renderItem->Type      = RENDER_TYPE_DEBUG_DRAW;
+        renderItem->Position  = { 0.0f, 0.0f };
+        renderItem->Depth     = depth;
+        renderItem->Texture   = 0;
+        renderItem->DebugDraw = batch;
+        
+        queue->RenderCount += 1;
+    }
+}
+#endif
+
+///////////////////////////////////////////////
+//      CLIP RECTANGLES
+///////////////////////////////////////////////
+// NOTE(Joey): items pushed after this are only drawn within clipRect (in target pixels); 
+// a clip rect w/o area hides them all.
+internal void PushClipRect(RenderQueue *queue, rectangle2Di clipRect)
+{
+    Assert(queue->RenderCount + 1 < queue->MaxRenderCount);
+    RenderQueueItem *renderItem = queue->RenderItems + queue->RenderCount;
+    
+    renderItem->Type     = RENDER_TYPE_CLIP;
+    renderItem->ClipRect = clipRect;
+    
+    queue->RenderCount += 1;
+}
+
+// NOTE(Joey): removes the clip rect of previously pushed PushClipRect calls
+internal void ResetClipRect(RenderQueue *queue)
+{
+    rectangle2Di unclipped = { -(1 << 30), -(1 << 30), 1 << 30, 1 << 30 };
+    PushClipRect(queue, unclipped);
+}
@@ -12,8 +12,26 @@
 #ifndef RENDER_QUEUE_H
 #define RENDER_QUEUE_H
 
+enum render_type
+{
+    RENDER_TYPE_RECTANGLE,
+    RENDER_TYPE_TEXTURE,
+    RENDER_TYPE_TEXTURE_SDF,
+    RENDER_TYPE_TRIANGLE,
+    RENDER_TYPE_PARTICLES,
+    RENDER_TYPE_BLIT,
+    RENDER_TYPE_BLIT_BLENDED,
+    RENDER_TYPE_VIRTUAL_TEXTURE,
+    RENDER_TYPE_CLIP,            // NOTE(Joey): not drawn; restricts all items after it to ClipRect
+#if INTERNAL
+    RENDER_TYPE_DEBUG_DRAW,
+#endif
+};
+
 struct RenderQueueItem
 {
+    render_type Type;
+    
     vector2D Position;  // NOTE(Joey): depth in position, or individual uint32 component?
     uint32   Depth;
     vector2D Basis[2];
@@ -21,6 +39,20 @@ struct RenderQueueItem
     
     Texture *Texture;
     vector4D Color;
+    texture_sampler Sampler; // NOTE(Joey): RENDER_TYPE_TEXTURE
+    
+    real32   SDFSpread; // NOTE(Joey): texel range the distance field is encoded over (RENDER_TYPE_TEXTURE_SDF)
+    
+    // NOTE(Joey): screen-space vertices and texture coordinates (RENDER_TYPE_TRIANGLE); solid if Texture is 0
+    vector2D Vertices[3];
+    vector2D UVs[3];
+    
+    particle_render_batch *Particles; // NOTE(Joey): RENDER_TYPE_PARTICLES
+    virtual_texture *VirtualTexture;  // NOTE(Joey): RENDER_TYPE_VIRTUAL_TEXTURE
+    rectangle2Di     ClipRect;        // NOTE(Joey): RENDER_TYPE_CLIP
+#if INTERNAL
+    debug_draw_batch *DebugDraw;      // NOTE(Joey): RENDER_TYPE_DEBUG_DRAW
+#endif
 };
 
 struct RenderQueue
@@ -28,6 +60,7 @@ struct RenderQueue
     uint32 RenderCount;
     uint32 MaxRenderCount;
     RenderQueueItem *RenderItems; 
+    rectangle2Di    *ItemBounds; // NOTE(Joey): per item; filled by RenderPass s.t. tiles skip items w/o touching them
 };
 
 #endif
\ No newline at end of file
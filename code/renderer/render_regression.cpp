@@ -0,0 +1,434 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+// TODO(Joey): write custom string formatting (remove dependency on c-standard library: stdio.h)
+#include <stdio.h>
+
+const char *RenderRegressionSceneNames[RENDER_REGRESSION_SCENE_COUNT] =
+{
+    "rotated_sprites",
+    "alpha_overlap",
+    "edge_clipped_tiles",
+    "tiny_sprites",
+};
+
+const char *RenderRegressionStatusNames[] =
+{
+    "PASS",
+    "TOLERATED",
+    "FAIL",
+    "RECORDED",
+};
+
+// NOTE(Joey): round sprite with a soft edge and a fully transparent border (s.t. spans are used)
+internal Texture CreateRegressionSprite(memory_arena *arena)
+{
+    Texture texture = CreateEmptyTexture(arena, 64, 64);
+    for(uint32 y = 0; y < texture.Height; ++y)
+    {
+        uint32 *texel = (uint32*)((uint8*)texture.Texels + y*texture.Pitch);
+        for(uint32 x = 0; x < texture.Width; ++x)
+        {
+            real32 dX = (real32)x - 31.5f;
+            real32 dY = (real32)y - 31.5f;
+            real32 distance = SquareRoot(dX*dX + dY*dY);
+            uint32 a = RoundReal32ToUInt32(255.0f*Clamp01((30.0f - distance) / 6.0f));
+            uint32 r = x*4;
+            uint32 g = y*4;
+            uint32 b = 255 - ((x + y)*2);
+            *texel++ = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    BuildTextureSpans(&texture, arena);
+    return texture;
+}
+
+// NOTE(Joey): opaque checkerboard tile with transparent corners
+internal Texture CreateRegressionTile(memory_arena *arena)
+{
+    Texture texture = CreateEmptyTexture(arena, 48, 48);
+    for(uint32 y = 0; y < texture.Height; ++y)
+    {
+        uint32 *texel = (uint32*)((uint8*)texture.Texels + y*texture.Pitch);
+        for(uint32 x = 0; x < texture.Width; ++x)
+        {
+            bool32 corner = (x < 6 || x >= 42) && (y < 6 || y >= 42);
+            bool32 checker = ((x / 8) + (y / 8)) & 1;
+            uint32 a = corner ? 0 : 255;
+            uint32 color = checker ? 0x00C04020 : 0x002060C0;
+            *texel++ = (a << 24) | color | (x*5 << 8);
+        }
+    }
+    return texture;
+}
+
+// NOTE(Joey): scale renders the same scene at a larger target (sprites grow w/ it; tiles are repeated)
+internal void BuildRegressionScene(RenderQueue *queue, render_regression_scene scene, Texture *sprite, Texture *tile, 
+                                   real32 scale = 1.0f)
+{
+    random_series series = Seed(1337 + scene, 65536);
+    vector2D targetSize = { scale*(real32)RENDER_REGRESSION_WIDTH, scale*(real32)RENDER_REGRESSION_HEIGHT };
+    switch(scene)
+    {
+        case RENDER_REGRESSION_ROTATED_SPRITES:
+        {   // NOTE(Joey): some of the sprites use the non-default samplers
+            for(uint32 i = 0; i < 300; ++i)
+            {
+                vector2D position = { RandomBetween(&series, -40.0f*scale, targetSize.x + 40.0f*scale),
+                                      RandomBetween(&series, -40.0f*scale, targetSize.y + 40.0f*scale) };
+                real32 size = scale*RandomBetween(&series, 16.0f, 96.0f);
+                real32 angle = RandomBetween(&series, 0.0f, 2.0f*Pi32);
+                vector2D basisX = { Cos(angle), Sin(angle) };
+                vector4D color = { RandomBetween(&series, 0.5f, 1.0f), 1.0f, RandomBetween(&series, 0.5f, 1.0f), 1.0f };
+                texture_sampler sampler = TextureSampler();
+                if(i % 5 == 0)
+                    sampler = TextureSampler(TEXTURE_FILTER_NEAREST);
+                else if(i % 7 == 0)
+                    sampler = TextureSampler(TEXTURE_FILTER_BILINEAR, TEXTURE_ADDRESS_WRAP, { 2.0f, 2.0f }, { 0.25f, 0.0f });
+                PushTexture(queue, sprite, position, 0, { size, size }, basisX, Perpendicular(basisX), color, sampler);
+            }
+        } break;
+        case RENDER_REGRESSION_ALPHA_OVERLAP:
+        {
+            PushTexture(queue, tile, 0.5f*targetSize, 0, targetSize);
+            for(uint32 i = 0; i < 80; ++i)
+            {
+                vector2D position = { RandomBetween(&series, 0.2f, 0.8f)*targetSize.x,
+                                      RandomBetween(&series, 0.2f, 0.8f)*targetSize.y };
+                real32 size = scale*RandomBetween(&series, 100.0f, 300.0f);
+                real32 angle = RandomBetween(&series, 0.0f, 2.0f*Pi32);
+                vector2D basisX = { Cos(angle), Sin(angle) };
+                vector4D color = { RandomBetween(&series, 0.2f, 1.0f),
+                                   RandomBetween(&series, 0.2f, 1.0f),
+                                   RandomBetween(&series, 0.2f, 1.0f),
+                                   RandomBetween(&series, 0.2f, 0.6f) };
+                PushTexture(queue, sprite, position, 0, { size, size }, basisX, Perpendicular(basisX), color);
+            }
+        } break;
+        case RENDER_REGRESSION_EDGE_CLIPPED_TILES:
+        {   // NOTE(Joey): a grid offset s.t. tiles straddle the render tiles' and the target's edges
+            uint32 index = 0;
+            for(int32 y = -31; y < (int32)targetSize.y + 48; y += 48)
+            {
+                for(int32 x = -29; x < (int32)targetSize.x + 48; x += 48, ++index)
+                {
+                    vector2D position = { (real32)x, (real32)y };
+                    switch(index % 3)
+                    {
+                        case 0:
+                        {
+                            PushBlit(queue, tile, position, 0);
+                        } break;
+                        case 1:
+                        {
+                            PushBlitBlended(queue, tile, position, 0);
+                        } break;
+                        case 2:
+                        {
+                            vector2D size = { (real32)tile->Width, (real32)tile->Height };
+                            PushTexture(queue, tile, position + 0.5f*size, 0, size);
+                        } break;
+                    }
+                }
+            }
+        } break;
+        case RENDER_REGRESSION_TINY_SPRITES:
+        {
+            for(uint32 i = 0; i < 3000; ++i)
+            {
+                vector2D position = { RandomBetween(&series, 0.0f, targetSize.x),
+                                      RandomBetween(&series, 0.0f, targetSize.y) };
+                real32 size = scale*RandomBetween(&series, 1.0f, 4.0f);
+                real32 angle = RandomBetween(&series, 0.0f, 2.0f*Pi32);
+                vector2D basisX = { Cos(angle), Sin(angle) };
+                PushTexture(queue, sprite, position, 0, { size, size }, basisX, Perpendicular(basisX), { 1.0f, 1.0f, 1.0f, 1.0f });
+            }
+        } break;
+        default:
+        {
+            InvalidCodePath;
+        }
+    }
+}
+
+// NOTE(Joey): FNV-1a over all texels
+internal uint32 GetTextureChecksum(Texture *texture)
+{
+    uint32 hash = 2166136261;
+    for(uint32 y = 0; y < texture->Height; ++y)
+    {
+        uint8 *row = (uint8*)texture->Texels + y*texture->Pitch;
+        for(uint32 i = 0; i < texture->Width*sizeof(uint32); ++i)
+        {
+            hash ^= row[i];
+            hash *= 16777619;
+        }
+    }
+    return hash;
+}
+
+// NOTE(Joey): stored as a 32 bit .BMP with channel masks s.t. DecodeBitmap's conventions apply
+internal bool32 WriteRegressionBitmap(char *fileName, Texture *texture, memory_arena *arena)
+{
+    temp_memory writeMemory = BeginTempMemory(arena);
+    uint32 texelSize = texture->Width*texture->Height*sizeof(uint32);
+    uint32 fileSize = sizeof(bitmap_header) + texelSize;
+    uint8 *contents = (uint8*)PushSize_(arena, fileSize);
+
+    bitmap_header *header = (bitmap_header*)contents;
+    ZeroSize(header, sizeof(bitmap_header));
+    header->FileType     = 0x4D42; // NOTE(Joey): 'BM'
+    header->FileSize     = fileSize;
+    header->BitmapOffset = sizeof(bitmap_header);
+    header->Size         = 40;     // NOTE(Joey): BITMAPINFOHEADER; the channel masks follow it
+    header->Width        = texture->Width;
+    header->Height       = texture->Height;
+    header->Planes       = 1;
+    header->BitsPerPixel = 32;
+    header->Compression  = 3;      // NOTE(Joey): BI_BITFIELDS
+    header->SizeOfBitmap = texelSize;
+    header->RedMask      = 0x00FF0000;
+    header->GreenMask    = 0x0000FF00;
+    header->BlueMask     = 0x000000FF;
+
+    uint32 *dest = (uint32*)(contents + sizeof(bitmap_header));
+    for(uint32 y = 0; y < texture->Height; ++y)
+    {
+        uint32 *source = (uint32*)((uint8*)texture->Texels + y*texture->Pitch);
+        for(uint32 x = 0; x < texture->Width; ++x)
+            *dest++ = *source++;
+    }
+
+    bool32 result = PlatformAPI.DEBUGWriteEntireFile(fileName, fileSize, contents);
+    EndTempMemory(writeMemory);
+    return result;
+}
+
+// NOTE(Joey): returns false if there's no (matching) golden image; texels are converted to ARGB32
+internal bool32 LoadRegressionGolden(char *fileName, Texture *golden)
+{
+    bool32 result = false;
+    debug_read_file_result readResult = PlatformAPI.DEBUGReadEntireFile(fileName);
+    if(readResult.ContentSize >= sizeof(bitmap_header))
+    {
+        bitmap_header *header = (bitmap_header*)readResult.Contents;
+        if(header->Width == golden->Width && header->Height == golden->Height && header->BitsPerPixel == 32 &&
+           header->BitmapOffset + golden->Width*golden->Height*sizeof(uint32) <= readResult.ContentSize)
+        {
+            bitmap_format format = GetBitmapFormat(header);
+            uint32 *source = (uint32*)((uint8*)readResult.Contents + header->BitmapOffset);
+            for(uint32 y = 0; y < golden->Height; ++y)
+            {
+                uint32 *dest = (uint32*)((uint8*)golden->Texels + y*golden->Pitch);
+                for(uint32 x = 0; x < golden->Width; ++x)
+                    *dest++ = ConvertBitmapTexel(&format, *source++);
+            }
+            result = true;
+        }
+    }
+    if(readResult.Contents)
+        PlatformAPI.DEBUGFreeFileMemory(readResult.Contents);
+    return result;
+}
+
+internal render_regression_status CompareRegressionOutput(Texture *output,
+                                                          Texture *golden,
+                                                          uint32 goldenChecksum,
+                                                          uint32 *maxDifference,
+                                                          uint32 *failedPixels)
+{
+    *maxDifference = 0;
+    *failedPixels = 0;
+    if(GetTextureChecksum(output) == goldenChecksum)
+        return RENDER_REGRESSION_PASS;
+
+    for(uint32 y = 0; y < output->Height; ++y)
+    {
+        uint32 *a = (uint32*)((uint8*)output->Texels + y*output->Pitch);
+        uint32 *b = (uint32*)((uint8*)golden->Texels + y*golden->Pitch);
+        for(uint32 x = 0; x < output->Width; ++x, ++a, ++b)
+        {
+            uint32 pixelDifference = 0;
+            for(uint32 shift = 0; shift < 32; shift += 8)
+            {
+                int32 difference = (int32)((*a >> shift) & 0xFF) - (int32)((*b >> shift) & 0xFF);
+                uint32 absDifference = (uint32)(difference < 0 ? -difference : difference);
+                pixelDifference = Maximum(pixelDifference, absDifference);
+            }
+            *maxDifference = Maximum(*maxDifference, pixelDifference);
+            if(pixelDifference > RENDER_REGRESSION_TOLERANCE)
+                *failedPixels += 1;
+        }
+    }
+    return *failedPixels ? RENDER_REGRESSION_FAIL : RENDER_REGRESSION_TOLERATED;
+}
+
+/* NOTE(Joey):
+
+  Times each scene, scaled up by RenderRegressionGridScales, w/ the tile
+  grid RenderPass picks itself against the fixed RENDER_TILE_COUNT_X by
+  _Y grid it used to render in. The adaptive grid is given
+  RENDER_REGRESSION_RUN_COUNT frames to settle on a refinement before
+  it's timed. Outputs aren't compared (the scaled scenes have no golden
+  images); returns the new length of results.
+
+*/
+internal uint32 RunRenderGridBenchmark(platform_work_queue *workQueue, memory_arena *arena, RenderQueue *queue,
+                                       Texture *sprite, Texture *tile, char *results, uint32 resultsLength)
+{
+    char *line = results + resultsLength;
+    int32 lineLength = snprintf(line, RENDER_REGRESSION_RESULTS_SIZE - resultsLength,
+                                "\n%-20s %9s %7s %12s %13s %8s %5s\n",
+                                "scene", "size", "threads", "fixed c/px", "adaptive c/px", "speedup", "grid");
+    PlatformAPI.WriteDebugOutput("%s", line);
+    resultsLength = Minimum(resultsLength + lineLength, RENDER_REGRESSION_RESULTS_SIZE - 1);
+
+    render_tile_grid fixedGrid = { RENDER_TILE_COUNT_X, RENDER_TILE_COUNT_Y };
+    for(uint32 scaleIndex = 0; scaleIndex < RENDER_REGRESSION_GRID_SCALE_COUNT; ++scaleIndex)
+    {
+        temp_memory scaleMemory = BeginTempMemory(arena);
+        real32 scale = RenderRegressionGridScales[scaleIndex];
+        Texture target = CreateEmptyTexture(arena, (uint16)(scale*RENDER_REGRESSION_WIDTH), (uint16)(scale*RENDER_REGRESSION_HEIGHT));
+        render_stats *stats = PushStruct(arena, render_stats);
+        real64 pixelCount = (real64)target.Width*(real64)target.Height;
+        
+        for(uint32 sceneIndex = 0; sceneIndex < RENDER_REGRESSION_SCENE_COUNT; ++sceneIndex)
+        {
+            queue->RenderCount = 0;
+            BuildRegressionScene(queue, (render_regression_scene)sceneIndex, sprite, tile, scale);
+            for(uint32 threadCount = 1; threadCount <= RENDER_REGRESSION_MAX_THREADS; threadCount *= 2)
+            {
+                uint64 fixedCycles = (uint64)-1;
+                uint64 adaptiveCycles = (uint64)-1;
+                *stats = {};
+                for(uint32 run = 0; run < 2*RENDER_REGRESSION_RUN_COUNT; ++run)
+                {
+                    uint64 startCycles = __rdtsc();
+                    RenderPass(workQueue, queue, &target, threadCount, stats);
+                    if(run >= RENDER_REGRESSION_RUN_COUNT)
+                        adaptiveCycles = Minimum(adaptiveCycles, __rdtsc() - startCycles);
+                }
+                for(uint32 run = 0; run < RENDER_REGRESSION_RUN_COUNT; ++run)
+                {
+                    uint64 startCycles = __rdtsc();
+                    RenderPass(workQueue, queue, &target, threadCount, 0, &fixedGrid);
+                    fixedCycles = Minimum(fixedCycles, __rdtsc() - startCycles);
+                }
+
+                char size[16];
+                snprintf(size, sizeof(size), "%ux%u", target.Width, target.Height);
+                line = results + resultsLength;
+                lineLength = snprintf(line, RENDER_REGRESSION_RESULTS_SIZE - resultsLength,
+                                      "%-20s %9s %7u %12.2f %13.2f %7.2fx %2ux%-2u\n",
+                                      RenderRegressionSceneNames[sceneIndex], size, threadCount,
+                                      (real64)fixedCycles / pixelCount, (real64)adaptiveCycles / pixelCount,
+                                      (real64)fixedCycles / (real64)adaptiveCycles, 
+                                      stats->Grid.CountX, stats->Grid.CountY);
+                PlatformAPI.WriteDebugOutput("%s", line);
+                resultsLength = Minimum(resultsLength + lineLength, RENDER_REGRESSION_RESULTS_SIZE - 1);
+            }
+        }
+        EndTempMemory(scaleMemory);
+    }
+    return resultsLength;
+}
+
+/* NOTE(Joey):
+
+  Renders a fixed set of scenes through RenderPass at 1 to
+  RENDER_REGRESSION_MAX_THREADS threads and compares each output with the
+  scene's golden image in directory (<scene>.bmp); a missing golden image
+  is recorded from the single-threaded output, so delete one to re-record.
+  Per run the status and the cycles per pixel of the fastest of
+  RENDER_REGRESSION_RUN_COUNT passes are written to <directory>/results.txt
+  and the debug output, followed by RunRenderGridBenchmark's timings.
+  Returns whether all runs stayed within tolerance.
+
+*/
+internal bool32 RunRenderRegression(platform_work_queue *workQueue, memory_arena *arena, char *directory)
+{
+    temp_memory regressionMemory = BeginTempMemory(arena);
+
+    Texture target = CreateEmptyTexture(arena, RENDER_REGRESSION_WIDTH, RENDER_REGRESSION_HEIGHT);
+    Texture golden = CreateEmptyTexture(arena, RENDER_REGRESSION_WIDTH, RENDER_REGRESSION_HEIGHT);
+    Texture sprite = CreateRegressionSprite(arena);
+    Texture tile = CreateRegressionTile(arena);
+    RenderQueue *queue = CreateRenderQueue(arena, RENDER_REGRESSION_MAX_QUEUE);
+    real64 pixelCount = (real64)RENDER_REGRESSION_WIDTH*(real64)RENDER_REGRESSION_HEIGHT;
+
+    char *results = (char*)PushSize_(arena, RENDER_REGRESSION_RESULTS_SIZE);
+    uint32 resultsLength = 0;
+    resultsLength += snprintf(results, RENDER_REGRESSION_RESULTS_SIZE,
+                              "%-20s %7s %12s %10s %-9s %7s %7s\n",
+                              "scene", "threads", "cycles/px", "checksum", "status", "maxdiff", "failed");
+
+    bool32 passed = true;
+    for(uint32 sceneIndex = 0; sceneIndex < RENDER_REGRESSION_SCENE_COUNT; ++sceneIndex)
+    {
+        queue->RenderCount = 0;
+        BuildRegressionScene(queue, (render_regression_scene)sceneIndex, &sprite, &tile);
+
+        char goldenFileName[256];
+        snprintf(goldenFileName, sizeof(goldenFileName), "%s/%s.bmp", directory, RenderRegressionSceneNames[sceneIndex]);
+        bool32 hasGolden = LoadRegressionGolden(goldenFileName, &golden);
+        uint32 goldenChecksum = hasGolden ? GetTextureChecksum(&golden) : 0;
+
+        for(uint32 threadCount = 1; threadCount <= RENDER_REGRESSION_MAX_THREADS; threadCount *= 2)
+        {
+            uint64 bestCycles = (uint64)-1;
+            for(uint32 run = 0; run < RENDER_REGRESSION_RUN_COUNT; ++run)
+            {
+                ZeroSize(target.Texels, target.Height*target.Pitch);
+                uint64 startCycles = __rdtsc();
+                RenderPass(workQueue, queue, &target, threadCount);
+                uint64 cycles = __rdtsc() - startCycles;
+                bestCycles = Minimum(bestCycles, cycles);
+            }
+
+            render_regression_status status = RENDER_REGRESSION_RECORDED;
+            uint32 maxDifference = 0;
+            uint32 failedPixels = 0;
+            if(hasGolden)
+            {
+                status = CompareRegressionOutput(&target, &golden, goldenChecksum, &maxDifference, &failedPixels);
+            }
+            else
+            {   // NOTE(Joey): the other thread counts are compared against the recorded output
+                WriteRegressionBitmap(goldenFileName, &target, arena);
+                for(uint32 i = 0; i < target.Width*target.Height; ++i)
+                    golden.Texels[i] = target.Texels[i];
+                goldenChecksum = GetTextureChecksum(&golden);
+                hasGolden = true;
+            }
+            if(status == RENDER_REGRESSION_FAIL)
+                passed = false;
+
+            char *line = results + resultsLength;
+            int32 lineLength = snprintf(line, RENDER_REGRESSION_RESULTS_SIZE - resultsLength,
+                                        "%-20s %7u %12.2f   %08x %-9s %7u %7u\n",
+                                        RenderRegressionSceneNames[sceneIndex], threadCount,
+                                        (real64)bestCycles / pixelCount, GetTextureChecksum(&target),
+                                        RenderRegressionStatusNames[status], maxDifference, failedPixels);
+            PlatformAPI.WriteDebugOutput("%s", line);
+            resultsLength = Minimum(resultsLength + lineLength, RENDER_REGRESSION_RESULTS_SIZE - 1);
+        }
+    }
+
+    resultsLength = RunRenderGridBenchmark(workQueue, arena, queue, &sprite, &tile, results, resultsLength);
+
+    char resultsFileName[256];
+    snprintf(resultsFileName, sizeof(resultsFileName), "%s/results.txt", directory);
+    PlatformAPI.DEBUGWriteEntireFile(resultsFileName, resultsLength, results);
+
+    EndTempMemory(regressionMemory);
+    return passed;
+}
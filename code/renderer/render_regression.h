@@ -0,0 +1,47 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef RENDER_REGRESSION_H
+#define RENDER_REGRESSION_H
+
+// NOTE(Joey): scenes are rendered at a fixed size s.t. golden images don't depend on the window
+const uint16 RENDER_REGRESSION_WIDTH  = 640;
+const uint16 RENDER_REGRESSION_HEIGHT = 360;
+
+const uint32 RENDER_REGRESSION_MAX_THREADS = 8;
+const uint32 RENDER_REGRESSION_RUN_COUNT   = 4;    // NOTE(Joey): fastest run of each thread count is reported
+const uint32 RENDER_REGRESSION_TOLERANCE   = 2;    // NOTE(Joey): max difference per channel w/ the golden image
+const uint32 RENDER_REGRESSION_MAX_QUEUE   = 4096;
+const uint32 RENDER_REGRESSION_RESULTS_SIZE = 16384;
+
+// NOTE(Joey): the adaptive tile grid is benchmarked against the fixed one on the scenes scaled to 1080p and 4K
+const uint32 RENDER_REGRESSION_GRID_SCALE_COUNT = 2;
+const real32 RenderRegressionGridScales[RENDER_REGRESSION_GRID_SCALE_COUNT] = { 3.0f, 6.0f };
+
+enum render_regression_scene
+{
+    RENDER_REGRESSION_ROTATED_SPRITES,
+    RENDER_REGRESSION_ALPHA_OVERLAP,
+    RENDER_REGRESSION_EDGE_CLIPPED_TILES,
+    RENDER_REGRESSION_TINY_SPRITES,
+
+    RENDER_REGRESSION_SCENE_COUNT,
+};
+
+enum render_regression_status
+{
+    RENDER_REGRESSION_PASS,      // NOTE(Joey): identical checksum
+    RENDER_REGRESSION_TOLERATED, // NOTE(Joey): pixels differ, but all within RENDER_REGRESSION_TOLERANCE
+    RENDER_REGRESSION_FAIL,
+    RENDER_REGRESSION_RECORDED,  // NOTE(Joey): there was no golden image yet; the output is stored as such
+};
+
+#endif
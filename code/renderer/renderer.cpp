@@ -12,36 +12,199 @@
 #include "texture.cpp"
 #include "render_primitives.cpp"
 #include "render_queue.cpp"
+#include "lighting.cpp"
+#include "particles.cpp"
+#if INTERNAL
+#include "debug_draw.cpp"
+#endif
+#include "tilemap.cpp"
+#include "sprite_cache.cpp"
+#include "virtual_texture.cpp"
+#include "post_process.cpp"
 
+// NOTE(Joey): the item's screen-space bounds within targetRect; the same bounds the primitives fill
+internal rectangle2Di GetRenderItemBounds(RenderQueueItem *item, rectangle2Di targetRect)
+{
+    rectangle2Di bounds = InvertedInfinityRectangle();
+    switch(item->Type)
+    {
+        case RENDER_TYPE_TEXTURE:
+        case RENDER_TYPE_TEXTURE_SDF:
+        {
+            vector2D axisX = item->Size.x*item->Basis[0];
+            vector2D axisY = item->Size.y*item->Basis[1];
+            bounds = GetOrientedQuadFillRect(item->Position - 0.5f*axisX - 0.5f*axisY, axisX, axisY, targetRect);
+        } break;
+        case RENDER_TYPE_TRIANGLE:
+        {
+            for(int i = 0; i < 3; ++i)
+            {
+                bounds.MinX = Minimum(bounds.MinX, FloorReal32ToInt32(item->Vertices[i].x));
+                bounds.MinY = Minimum(bounds.MinY, FloorReal32ToInt32(item->Vertices[i].y));
+                bounds.MaxX = Maximum(bounds.MaxX, CeilReal32ToInt32(item->Vertices[i].x));
+                bounds.MaxY = Maximum(bounds.MaxY, CeilReal32ToInt32(item->Vertices[i].y));
+            }
+        } break;
+        case RENDER_TYPE_PARTICLES:
+        {   // NOTE(Joey): bins are per render tile and hold the particles overlapping them
+            particle_render_batch *batch = item->Particles;
+            for(uint32 i = 0; i < batch->BinCount; ++i)
+            {
+                if(batch->Bins[i].ParticleCount > 0)
+                    bounds = Union(bounds, batch->Bins[i].Rect);
+            }
+        } break;
+        case RENDER_TYPE_BLIT:
+        case RENDER_TYPE_BLIT_BLENDED:
+        {
+            bounds.MinX = RoundReal32ToInt32(item->Position.x);
+            bounds.MinY = RoundReal32ToInt32(item->Position.y);
+            bounds.MaxX = bounds.MinX + item->Texture->Width;
+            bounds.MaxY = bounds.MinY + item->Texture->Height;
+        } break;
+        case RENDER_TYPE_VIRTUAL_TEXTURE:
+        {
+            vector2D origin = item->Position - 0.5f*item->Size;
+            bounds.MinX = CeilReal32ToInt32(origin.x);
+            bounds.MinY = CeilReal32ToInt32(origin.y);
+            bounds.MaxX = FloorReal32ToInt32(origin.x + item->Size.x) + 1;
+            bounds.MaxY = FloorReal32ToInt32(origin.y + item->Size.y) + 1;
+        } break;
+        case RENDER_TYPE_RECTANGLE:
+        {
+            bounds.MinX = RoundReal32ToInt32(item->Position.x);
+            bounds.MinY = RoundReal32ToInt32(item->Position.y);
+            bounds.MaxX = RoundReal32ToInt32(item->Position.x + item->Size.x);
+            bounds.MaxY = RoundReal32ToInt32(item->Position.y + item->Size.y);
+        } break;
+#if INTERNAL
+        case RENDER_TYPE_DEBUG_DRAW:
+        {
+            debug_draw_batch *batch = item->DebugDraw;
+            for(uint32 i = 0; i < batch->ShapeCount; ++i)
+            {
+                rectangle2Di shapeBounds = { batch->MinX[i], batch->MinY[i], batch->MaxX[i], batch->MaxY[i] };
+                bounds = Union(bounds, shapeBounds);
+            }
+        } break;
+#endif
+        default:
+        {   // NOTE(Joey): clip items aren't culled (RenderQueueItems handles them before)
+            bounds = targetRect;
+        } break;
+    }
+    return Intersect(bounds, targetRect);
+}
 
-void RenderQueueItems(RenderQueue *queue, Texture *target, rectangle2Di clipRect)
+void RenderQueueItems(RenderQueue *queue, Texture *target, rectangle2Di tileClipRect, render_tile_stats *stats = 0)
 {
+    uint64 startCycles = __rdtsc();
+    rectangle2Di clipRect = tileClipRect;
     for(uint32 i = 0; i < queue->RenderCount; ++i)
     {
         RenderQueueItem *item = queue->RenderItems + i;
         
+        if(item->Type == RENDER_TYPE_CLIP)
+        {
+            clipRect = Intersect(tileClipRect, item->ClipRect);
+            continue;
+        }
+        // NOTE(Joey): the bounds are a few compares; most items of a tile's pass don't touch it
+        if(!HasArea(Intersect(queue->ItemBounds[i], clipRect)))
+            continue;
+        
+#if INTERNAL
+        if(stats)
+            stats->ItemCount += 1;
+#endif
+        
         // NOTE(Joey): define types of render items to allow for custom-tailored rendering
         // code below, including FX (that operate on render target as a whole for instance).
-        if(item->Texture)
-        {   // NOTE(Joey): render as texture
-            RenderTexture_(target, 
-                           item->Texture,
-                           item->Position,
-                           item->Size,
-                           item->Basis[0],
-                           item->Basis[1],
-                           clipRect,
-                           item->Color);            
-        }
-        else
-        {   // NOTE(Joey): render as rectangle
-            // NOTE(Joey): doesn't support clipping yet; build it or somply disband rectangle rendering?
-            RenderRectangle_(target,
-                             item->Position,
-                             item->Size,
-                             item->Color);
+        switch(item->Type)
+        {
+            case RENDER_TYPE_TEXTURE:
+            {
+                RenderTexture_(target, 
+                               item->Texture,
+                               item->Position,
+                               item->Size,
+                               item->Basis[0],
+                               item->Basis[1],
+                               clipRect,
+                               item->Color,
+                               item->Sampler,
+                               stats);            
+            } break;
+            case RENDER_TYPE_TEXTURE_SDF:
+            {
+                RenderTextureSDF_(target, 
+                                  item->Texture,
+                                  item->Position,
+                                  item->Size,
+                                  item->Basis[0],
+                                  item->Basis[1],
+                                  clipRect,
+                                  item->Color,
+                                  item->SDFSpread);
+            } break;
+            case RENDER_TYPE_TRIANGLE:
+            {
+                RenderTriangle_(target,
+                                item->Texture,
+                                item->Vertices,
+                                item->UVs,
+                                clipRect,
+                                item->Color);
+            } break;
+            case RENDER_TYPE_PARTICLES:
+            {
+                RenderParticles_(target, item->Particles, clipRect);
+            } break;
+            case RENDER_TYPE_BLIT:
+            {
+                RenderBlit_(target,
+                            item->Texture,
+                            item->Position,
+                            clipRect);
+            } break;
+            case RENDER_TYPE_BLIT_BLENDED:
+            {
+                RenderBlitBlended_(target,
+                                   item->Texture,
+                                   item->Position,
+                                   clipRect);
+            } break;
+            case RENDER_TYPE_VIRTUAL_TEXTURE:
+            {
+                RenderVirtualTexture_(target,
+                                      item->VirtualTexture,
+                                      item->Position,
+                                      item->Size,
+                                      clipRect,
+                                      item->Color);
+            } break;
+            case RENDER_TYPE_RECTANGLE:
+            {
+                RenderRectangle_(target,
+                                 item->Position,
+                                 item->Size,
+                                 clipRect,
+                                 item->Color);
+            } break;
+#if INTERNAL
+            case RENDER_TYPE_DEBUG_DRAW:
+            {
+                RenderDebugDraw_(target, item->DebugDraw, clipRect);
+            } break;
+#endif
+            default:
+            {
+                InvalidCodePath;
+            } break;
         }
     }    
+    if(stats)
+        stats->Cycles += __rdtsc() - startCycles;
 }
 
 struct TiledRenderData 
@@ -49,64 +212,182 @@ struct TiledRenderData
     RenderQueue *Queue;
     Texture     *Target;
     rectangle2Di ClipRect;    
+    render_tile_stats *Stats;
 };
 
-void DoTiledRenderWork(platform_work_queue *queue, void* data)
+// NOTE(Joey): a single work entry that keeps taking tiles until all are rendered
+struct tiled_render_lane
 {
-    TiledRenderData *tiledData = (TiledRenderData*)data;
-    RenderQueueItems(tiledData->Queue, tiledData->Target, tiledData->ClipRect);
+    TiledRenderData *Tiles;
+    uint16          *Order; // NOTE(Joey): tile indices in the order they're taken
+    uint32           TileCount;
+    volatile uint32  NextTile;
+};
+
+void DoTiledRenderLaneWork(platform_work_queue *queue, void *data)
+{
+    tiled_render_lane *lane = (tiled_render_lane*)data;
+    for(;;)
+    {
+        uint32 orderIndex = _InterlockedIncrement((volatile long*)&lane->NextTile) - 1;
+        if(orderIndex >= lane->TileCount)
+            break;
+        TiledRenderData *tile = lane->Tiles + lane->Order[orderIndex];
+        RenderQueueItems(tile->Queue, tile->Target, tile->ClipRect, tile->Stats);
+    }
 }
 
-internal void RenderPass(platform_work_queue *workQueue, RenderQueue *renderQueue, Texture *target)
+/* NOTE(Joey):
+
+  Picks the tile grid of a RenderPass. The base grid gives each lane (worker
+  threads plus the calling thread) RENDER_TILES_PER_LANE tiles of roughly
+  square shape, bounded by a minimum tile size s.t. small targets aren't 
+  split into slivers. On top of that the previous frame's tile costs refine 
+  the grid: each refinement level doubles the tile count along the longer 
+  tile axis. A tile that costs more than half a lane's fair share of the 
+  frame will likely finish last, so the level goes up; if even the costliest 
+  tile is under an eighth of a lane's share the split is finer than needed 
+  and the level goes down.
+
+*/
+internal render_tile_grid ChooseRenderTileGrid(Texture *target, uint32 laneCount, render_stats *previous)
+{
+    uint8 refinement = 0;
+    if(previous && previous->FrameIndex > 0 && 
+       previous->TargetWidth == target->Width && previous->TargetHeight == target->Height)
+    {
+        refinement = previous->Refinement;
+        
+        uint64 totalCycles = 0;
+        uint64 maxCycles   = 0;
+        uint32 tileCount = previous->Grid.CountX * previous->Grid.CountY;
+        for(uint32 i = 0; i < tileCount; ++i)
+        {
+            totalCycles += previous->Tiles[i].Cycles;
+            maxCycles = Maximum(maxCycles, previous->Tiles[i].Cycles);
+        }
+        uint64 laneShare = totalCycles / laneCount;
+        if(laneCount > 1 && maxCycles*2 > laneShare && refinement < RENDER_TILE_MAX_REFINEMENT)
+            ++refinement;
+        else if(maxCycles*8 < laneShare && refinement > 0)
+            --refinement;
+    }
+    
+    uint32 maxCountX = Maximum(1, Minimum((uint32)RENDER_TILE_MAX_COUNT_X, (uint32)(target->Width / RENDER_TILE_MIN_WIDTH)));
+    uint32 maxCountY = Maximum(1, Minimum((uint32)RENDER_TILE_MAX_COUNT_Y, (uint32)(target->Height / RENDER_TILE_MIN_HEIGHT)));
+    
+    // NOTE(Joey): split the wanted tile count over both axes s.t. tiles are about square
+    uint32 tileCount = laneCount*RENDER_TILES_PER_LANE;
+    uint32 countY = RoundReal32ToUInt32(SquareRoot((real32)(tileCount*target->Height) / (real32)target->Width));
+    countY = Maximum(1, Minimum(maxCountY, countY));
+    uint32 countX = Maximum(1, Minimum(maxCountX, (tileCount + countY - 1) / countY));
+    
+    for(uint8 level = 0; level < refinement; ++level)
+    {
+        if(target->Width*countY >= target->Height*countX && countX*2 <= maxCountX)
+            countX *= 2;
+        else if(countY*2 <= maxCountY)
+            countY *= 2;
+        else if(countX*2 <= maxCountX)
+            countX *= 2;
+    }
+    
+    render_tile_grid result;
+    result.CountX = (uint8)countX;
+    result.CountY = (uint8)countY;
+    if(previous)
+        previous->Refinement = refinement;
+    return result;
+}
+
+// NOTE(Joey): threadCount is the amount of lanes (including the calling thread) that render the 
+// tiles; 0 uses all threads of the work queue. The tile grid is picked from the lane count and, if 
+// stats are given, the previous frame's tile costs, which are then overwritten w/ this frame's.
+// A fixedGrid skips the selection altogether (the regression suite compares against it).
+internal void RenderPass(platform_work_queue *workQueue, 
+                         RenderQueue *renderQueue, 
+                         Texture *target, 
+                         uint32 threadCount = 0, 
+                         render_stats *stats = 0,
+                         render_tile_grid *fixedGrid = 0)
 {
     // NOTE(Joey): sort render items based on item->Depth before rendering
     
     
     // NOTE(Joey): tiled multithreaded rendering.
-    const uint8 tileCountX  = 4;
-    const uint8 tileCountY  = 4; 
-    uint16 tileWidth  = target->Width / tileCountX;
-    uint16 tileHeight = target->Height / tileCountY;
-    tileWidth = ((tileWidth + 3) / 4) * 4; // memory alignment
-    
     Assert(((uintptr_t)target->Texels & 15) == 0); // make sure memory is aligned
     
+    rectangle2Di targetRect = { 0, 0, (int32)target->Width, (int32)target->Height };
+    for(uint32 i = 0; i < renderQueue->RenderCount; ++i)
+        renderQueue->ItemBounds[i] = GetRenderItemBounds(renderQueue->RenderItems + i, targetRect);
+    
+    uint32 laneCount = 1;
+    if(workQueue)
+        laneCount = threadCount ? threadCount : PlatformAPI.HighPriorityThreadCount + 1;
+    render_tile_grid grid = fixedGrid ? *fixedGrid : ChooseRenderTileGrid(target, laneCount, stats);
+    
+    // NOTE(Joey): hand out the previous frame's costliest tiles first s.t. the cheap ones fill up 
+    // the gaps at the end; only if the grid didn't change, otherwise keep scanline order.
+    uint16 tileCount = grid.CountX*grid.CountY;
+    uint16 order[RENDER_TILE_MAX_COUNT_X * RENDER_TILE_MAX_COUNT_Y];
+    for(uint16 i = 0; i < tileCount; ++i)
+        order[i] = i;
+    if(stats && stats->Grid.CountX == grid.CountX && stats->Grid.CountY == grid.CountY)
+    {
+        for(uint16 i = 1; i < tileCount; ++i)
+        {
+            uint16 tileIndex = order[i];
+            uint64 cycles = stats->Tiles[tileIndex].Cycles;
+            uint16 j = i;
+            for(; j > 0 && stats->Tiles[order[j - 1]].Cycles < cycles; --j)
+                order[j] = order[j - 1];
+            order[j] = tileIndex;
+        }
+    }
+    if(stats)
+    {
+        stats->Grid = grid;
+        stats->TargetWidth  = target->Width;
+        stats->TargetHeight = target->Height;
+    }
+    
     // store TiledRenderData structs here to keep them in the stack
-    TiledRenderData tiledData[tileCountX * tileCountY];
-    uint16 tileCount = 0;
-    for(uint8 y = 0; y < tileCountY; ++y)
+    TiledRenderData tiledData[RENDER_TILE_MAX_COUNT_X * RENDER_TILE_MAX_COUNT_Y];
+    for(uint8 y = 0; y < grid.CountY; ++y)
     {
-        for(uint8 x = 0; x < tileCountX; ++x)
+        for(uint8 x = 0; x < grid.CountX; ++x)
         {
             // NOTE(Joey): define clip rectangles to subdivide render work among multiple threads
-            rectangle2Di clipRect;
-            clipRect.MinX = x*tileWidth;
-            clipRect.MaxX = clipRect.MinX + tileWidth;
-            clipRect.MinY = y*tileHeight;
-            clipRect.MaxY = clipRect.MinY + tileHeight;
-
-            if(x == (tileCountX - 1))
-                clipRect.MaxX = target->Width;
-            if(y == (tileCountY - 1))
-                clipRect.MaxY = target->Height;
-            
-            TiledRenderData *data = tiledData + tileCount++;
+            uint16 tileIndex = y*grid.CountX + x;
+            TiledRenderData *data = tiledData + tileIndex;
             data->Queue = renderQueue;
             data->Target = target;
-            data->ClipRect = clipRect;
-            
-            if(workQueue)
-            {   // NOTE(Joey): we support multithreaded rendering
-                PlatformAPI.AddWorkEntry(workQueue, DoTiledRenderWork, data);
-            }
-            else
-            {   // NOTE(Joey): else render single-threaded
-                RenderQueueItems(renderQueue, target, { 0, 0, (int32)target->Width, (int32)target->Height });
+            data->ClipRect = GetRenderTileClipRect(target, grid, x, y);
+            data->Stats = 0;
+            if(stats)
+            {
+                data->Stats = stats->Tiles + tileIndex;
+                *data->Stats = {};
             }
         }
     }
+    
+    tiled_render_lane lane = {};
+    lane.Tiles = tiledData;
+    lane.Order = order;
+    lane.TileCount = tileCount;
     if(workQueue)
+    {   // NOTE(Joey): we support multithreaded rendering; lanes take tiles until none are left
+        for(uint32 i = 0; i < laneCount; ++i)
+            PlatformAPI.AddWorkEntry(workQueue, DoTiledRenderLaneWork, &lane);
         PlatformAPI.CompleteAllWork(workQueue);
+    }
+    else
+    {   // NOTE(Joey): else render single-threaded
+        DoTiledRenderLaneWork(0, &lane);
+    }
+    if(stats)
+        stats->FrameIndex += 1;
    
 #if 0
     for(uint32 i = 0; i < queue->RenderCount; ++i)
@@ -138,4 +419,63 @@ internal void RenderPass(platform_work_queue *workQueue, RenderQueue *renderQueu
         }
     }    
 #endif
-}
\ No newline at end of file
+}
+
+#if INTERNAL
+// NOTE(Joey): tints each render tile from green (cheapest) to red (most expensive tile) by its cycle count
+internal void RenderTileStatsOverlay(Texture *target, render_stats *stats)
+{
+    if(target->Format != TEXTURE_FORMAT_ARGB32)
+        return;
+    
+    uint64 maxCycles = 1;
+    for(uint32 i = 0; i < stats->Grid.CountX*stats->Grid.CountY; ++i)
+        maxCycles = Maximum(maxCycles, stats->Tiles[i].Cycles);
+    
+    const uint32 alpha = 90; // NOTE(Joey): ~0.35 opacity
+    for(uint8 y = 0; y < stats->Grid.CountY; ++y)
+    {
+        for(uint8 x = 0; x < stats->Grid.CountX; ++x)
+        {
+            render_tile_stats *tile = stats->Tiles + y*stats->Grid.CountX + x;
+            uint32 cost = (uint32)((tile->Cycles * 255) / maxCycles);
+            uint32 tintR = cost * alpha;
+            uint32 tintG = (255 - cost) * alpha;
+            
+            rectangle2Di clipRect = GetRenderTileClipRect(target, stats->Grid, x, y);
+            for(int32 py = clipRect.MinY; py < clipRect.MaxY; ++py)
+            {
+                uint32 *pixel = (uint32*)((uint8*)target->Texels + py*target->Pitch) + clipRect.MinX;
+                for(int32 px = clipRect.MinX; px < clipRect.MaxX; ++px)
+                {
+                    uint32 color = *pixel;
+                    uint32 r = (((color >> 16) & 0xFF) * (255 - alpha) + tintR) / 255;
+                    uint32 g = (((color >>  8) & 0xFF) * (255 - alpha) + tintG) / 255;
+                    uint32 b = (((color >>  0) & 0xFF) * (255 - alpha)) / 255;
+                    *pixel++ = (color & 0xFF000000) | (r << 16) | (g << 8) | b;
+                }
+            }
+        }
+    }
+}
+
+// NOTE(Joey): exports a frame's tile counters as CSV lines: render_stats,frame,tileX,tileY,cycles,items,written,rejected
+internal void OutputRenderStats(render_stats *stats)
+{
+    for(uint8 y = 0; y < stats->Grid.CountY; ++y)
+    {
+        for(uint8 x = 0; x < stats->Grid.CountX; ++x)
+        {
+            render_tile_stats *tile = stats->Tiles + y*stats->Grid.CountX + x;
+            PlatformAPI.WriteDebugOutput("render_stats,%u,%u,%u,%llu,%u,%u,%u\n",
+                                         stats->FrameIndex, x, y, tile->Cycles, 
+                                         tile->ItemCount, tile->PixelsWritten, tile->PixelsRejected);
+        }
+    }
+}
+#endif
+
+// NOTE(Joey): debug code that drives RenderPass itself
+#if INTERNAL
+#include "render_regression.cpp"
+#endif
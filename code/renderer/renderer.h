@@ -14,7 +14,90 @@
 
 #include "texture.h"
 #include "render_primitives.h"
+#include "particles.h"
+#include "virtual_texture.h"
+#if INTERNAL
+#include "debug_draw.h"
+#endif
 #include "render_queue.h"
+#include "tilemap.h"
+#include "sprite_cache.h"
+#include "lighting.h"
+#include "post_process.h"
+#if INTERNAL
+#include "render_regression.h"
+#endif
+
+// NOTE(Joey): the fixed grid lighting and particle binning work in; RenderPass picks its own (see render_tile_grid)
+const uint8 RENDER_TILE_COUNT_X = 4;
+const uint8 RENDER_TILE_COUNT_Y = 4;
+
+const uint8  RENDER_TILE_MAX_COUNT_X = 16;
+const uint8  RENDER_TILE_MAX_COUNT_Y = 16;
+const uint16 RENDER_TILE_MIN_WIDTH   = 64; // NOTE(Joey): below this per tile overhead outweighs the balancing
+const uint16 RENDER_TILE_MIN_HEIGHT  = 32;
+const uint32 RENDER_TILES_PER_LANE   = 4;  // NOTE(Joey): tiles per rendering thread s.t. lanes that finish early can pick up work
+const uint8  RENDER_TILE_MAX_REFINEMENT = 2;
+
+// NOTE(Joey): the tile grid a RenderPass subdivides its target in
+struct render_tile_grid
+{
+    uint8 CountX;
+    uint8 CountY;
+};
+
+inline rectangle2Di GetRenderTileClipRect(Texture *target, render_tile_grid grid, uint8 tileX, uint8 tileY)
+{
+    uint16 tileWidth  = target->Width / grid.CountX;
+    uint16 tileHeight = target->Height / grid.CountY;
+    tileWidth = ((tileWidth + 3) / 4) * 4; // memory alignment
+    
+    rectangle2Di clipRect;
+    clipRect.MinX = Minimum(tileX*tileWidth, (int32)target->Width);
+    clipRect.MaxX = Minimum(clipRect.MinX + tileWidth, (int32)target->Width);
+    clipRect.MinY = tileY*tileHeight;
+    clipRect.MaxY = clipRect.MinY + tileHeight;
+
+    if(tileX == (grid.CountX - 1))
+        clipRect.MaxX = target->Width;
+    if(tileY == (grid.CountY - 1))
+        clipRect.MaxY = target->Height;
+    
+    return clipRect;
+}
+
+inline rectangle2Di GetRenderTileClipRect(Texture *target, uint8 tileX, uint8 tileY)
+{
+    render_tile_grid grid = { RENDER_TILE_COUNT_X, RENDER_TILE_COUNT_Y };
+    return GetRenderTileClipRect(target, grid, tileX, tileY);
+}
+
+// NOTE(Joey): per tile counters of a RenderPass; all but Cycles are only gathered in INTERNAL builds
+struct render_tile_stats
+{
+    uint64 Cycles;
+    uint32 ItemCount;      // NOTE(Joey): items whose bounds overlap the tile; see GetRenderItemBounds
+    uint32 PixelsWritten;  // NOTE(Joey): by textured quads
+    uint32 PixelsRejected; // NOTE(Joey): pixels of textured quads' 4-wide groups masked out (clip/UV/coverage)
+};
+
+/* NOTE(Joey):
+
+  Per frame tile counters of a RenderPass. They also drive the next frame's
+  tile grid: if the costliest tile takes a large share of a lane's work it
+  becomes a straggler and the grid is refined; if all tiles are cheap it's
+  coarsened again. Refinement holds the current level.
+
+*/
+struct render_stats
+{
+    uint32 FrameIndex;
+    render_tile_grid Grid;
+    uint8  Refinement;
+    uint16 TargetWidth;
+    uint16 TargetHeight;
+    render_tile_stats Tiles[RENDER_TILE_MAX_COUNT_X * RENDER_TILE_MAX_COUNT_Y];
+};
 
 
 
@@ -0,0 +1,589 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Cache of pre-rotated and pre-scaled sprites. Sprites whose rotation
+  changes slowly (or not at all), and crowds of sprites that share a
+  rotation and size, are otherwise re-projected and bilinearly filtered
+  from scratch every frame. A cached sprite is drawn with an axis-aligned
+  blended blit instead, which is close to a memcpy.
+
+  Sprites are keyed by source asset, rotation quantized to
+  SPRITE_CACHE_ANGLE_STEPS, size in whole pixels, modulation color and
+  (for distance fields) spread. On a miss the sprite is drawn the regular
+  way while its cached copy is built on the low priority work queue, the
+  same way as the tilemap's chunk cache.
+
+  Slot memory comes from a fixed budget in a small number of power-of-two
+  size classes. A slot splits into 4 slots of the next smaller size class
+  and merges back once all 4 are free, so the budget is shared between
+  size classes. When no slot is free, the least recently used entry of the
+  requested size class is evicted; if there's none, the least recently
+  used block of slots of that size is emptied. Entries that are built or
+  drawn this frame are never evicted. Sprites larger than the biggest size
+  class are never cached.
+
+*/
+
+inline memory_index GetSpriteSlotBytes(uint32 sizeClass)
+{
+    memory_index slotSize = SPRITE_CACHE_MIN_SLOT_SIZE << sizeClass;
+    return slotSize*slotSize*sizeof(uint32);
+}
+
+inline uint32 GetSpriteSlotCount(sprite_cache *cache, uint32 sizeClass)
+{
+    return cache->RootSlotCount << 2*(SPRITE_CACHE_SIZE_CLASS_COUNT - 1 - sizeClass);
+}
+
+internal void InitSpriteCache(sprite_cache *cache, memory_arena *arena, memory_index budget)
+{
+    uint32 topClass = SPRITE_CACHE_SIZE_CLASS_COUNT - 1;
+    cache->RootSlotCount = (uint32)(budget / GetSpriteSlotBytes(topClass));
+    Assert(cache->RootSlotCount > 0);
+    cache->SlotMemory = (uint8*)PushSize_(arena, cache->RootSlotCount*GetSpriteSlotBytes(topClass), 16);
+    for(uint32 sizeClass = 0; sizeClass < SPRITE_CACHE_SIZE_CLASS_COUNT; ++sizeClass)
+    {
+        uint32 slotCount = GetSpriteSlotCount(cache, sizeClass);
+        cache->SlotStates[sizeClass] = PushArray(arena, slotCount, uint8);
+        for(uint32 i = 0; i < slotCount; ++i)
+            cache->SlotStates[sizeClass][i] = (uint8)(sizeClass == topClass ? SPRITE_SLOT_FREE : SPRITE_SLOT_ABSENT);
+    }
+    cache->BlockUse = PushArray(arena, GetSpriteSlotCount(cache, 0), uint32);
+
+    cache->FrameIndex  = 0;
+    cache->EntryCount  = 0;
+    cache->FreeEntries = 0;
+    cache->HitCount   = 0;
+    cache->MissCount  = 0;
+    for(uint32 i = 0; i < SPRITE_CACHE_HASH_SIZE; ++i)
+        cache->Hash[i] = 0;
+    for(uint32 i = 0; i < SPRITE_CACHE_SIZE_CLASS_COUNT; ++i)
+    {
+        cached_sprite *sentinel = cache->Sentinels + i;
+        sentinel->Next = sentinel;
+        sentinel->Prev = sentinel;
+    }
+}
+
+// NOTE(Joey): call once per frame before any sprites are pushed
+inline void BeginSpriteCacheFrame(sprite_cache *cache)
+{
+    ++cache->FrameIndex;
+    cache->HitCount  = 0;
+    cache->MissCount = 0;
+}
+
+inline uint32 GetSpriteCacheHash(sprite_cache_key *key)
+{
+    // NOTE(Joey): FNV-1a over the key's words, followed by a final avalanche so the low bits
+    // used for the bucket depend on every field
+    uint64 source = (uint64)(memory_index)key->StaticSource;
+    uint32 words[] =
+    {
+        key->SourceID,
+        key->SourceGeneration,
+        (uint32)source ^ (uint32)(source >> 32),
+        key->AngleIndex,
+        ((uint32)(uint16)key->SizeX << 16) | (uint32)(uint16)key->SizeY,
+        key->Color,
+        (uint32)RoundReal32ToInt32(256.0f*key->SDFSpread),
+    };
+    uint32 hash = 2166136261;
+    for(uint32 i = 0; i < ArrayCount(words); ++i)
+        hash = (hash ^ words[i])*16777619;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    return hash & (SPRITE_CACHE_HASH_SIZE - 1);
+}
+
+inline bool32 SpriteCacheKeysEqual(sprite_cache_key *a, sprite_cache_key *b)
+{
+    return a->SourceID == b->SourceID && a->SourceGeneration == b->SourceGeneration &&
+           a->StaticSource == b->StaticSource && a->AngleIndex == b->AngleIndex &&
+           a->SizeX == b->SizeX && a->SizeY == b->SizeY &&
+           a->Color == b->Color && a->SDFSpread == b->SDFSpread;
+}
+
+inline vector2D GetSpriteCacheBasis(uint32 angleIndex)
+{
+    real32 angle = (real32)angleIndex*(2.0f*Pi32 / (real32)SPRITE_CACHE_ANGLE_STEPS);
+    vector2D result = { Cos(angle), Sin(angle) };
+    return result;
+}
+
+inline uint32 PackColor(vector4D color)
+{
+    uint32 result = (RoundReal32ToUInt32(255.0f*Clamp01(color.a)) << 24) |
+                    (RoundReal32ToUInt32(255.0f*Clamp01(color.r)) << 16) |
+                    (RoundReal32ToUInt32(255.0f*Clamp01(color.g)) << 8)  |
+                    (RoundReal32ToUInt32(255.0f*Clamp01(color.b)) << 0);
+    return result;
+}
+
+internal void UnlinkCachedSprite(sprite_cache *cache, cached_sprite *sprite)
+{
+    cached_sprite **slot = cache->Hash + GetSpriteCacheHash(&sprite->Key);
+    while(*slot)
+    {
+        if(*slot == sprite)
+        {
+            *slot = sprite->NextInHash;
+            break;
+        }
+        slot = &(*slot)->NextInHash;
+    }
+    sprite->NextInHash = 0;
+    sprite->State = SPRITE_CACHE_EMPTY;
+}
+
+inline void TouchCachedSprite(sprite_cache *cache, cached_sprite *sprite)
+{
+    // NOTE(Joey): move to the front of its size class' LRU list
+    sprite->Prev->Next = sprite->Next;
+    sprite->Next->Prev = sprite->Prev;
+
+    cached_sprite *sentinel = cache->Sentinels + sprite->SizeClass;
+    sprite->Next = sentinel->Next;
+    sprite->Prev = sentinel;
+    sprite->Next->Prev = sprite;
+    sprite->Prev->Next = sprite;
+
+    sprite->LastUsedFrame = cache->FrameIndex;
+}
+
+internal bool32 AllocateSpriteSlot(sprite_cache *cache, uint32 sizeClass, uint32 *slotIndex)
+{
+    // NOTE(Joey): take the first free slot of the smallest size class that fits and split it down
+    for(uint32 freeClass = sizeClass; freeClass < SPRITE_CACHE_SIZE_CLASS_COUNT; ++freeClass)
+    {
+        uint8 *states = cache->SlotStates[freeClass];
+        uint32 slotCount = GetSpriteSlotCount(cache, freeClass);
+        for(uint32 i = 0; i < slotCount; ++i)
+        {
+            if(states[i] == SPRITE_SLOT_FREE)
+            {
+                uint32 index = i;
+                for(uint32 splitClass = freeClass; splitClass > sizeClass; --splitClass)
+                {
+                    cache->SlotStates[splitClass][index] = SPRITE_SLOT_SPLIT;
+                    index *= 4;
+                    for(uint32 j = 0; j < 4; ++j)
+                        cache->SlotStates[splitClass - 1][index + j] = SPRITE_SLOT_FREE;
+                }
+                cache->SlotStates[sizeClass][index] = SPRITE_SLOT_USED;
+                *slotIndex = index;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+internal void FreeSpriteSlot(sprite_cache *cache, uint32 sizeClass, uint32 slotIndex)
+{
+    // NOTE(Joey): merge into the parent slot for as long as all 4 of its children are free
+    cache->SlotStates[sizeClass][slotIndex] = SPRITE_SLOT_FREE;
+    while(sizeClass + 1 < SPRITE_CACHE_SIZE_CLASS_COUNT)
+    {
+        uint8 *siblings = cache->SlotStates[sizeClass] + (slotIndex & ~3u);
+        if(siblings[0] != SPRITE_SLOT_FREE || siblings[1] != SPRITE_SLOT_FREE ||
+           siblings[2] != SPRITE_SLOT_FREE || siblings[3] != SPRITE_SLOT_FREE)
+            break;
+        for(uint32 i = 0; i < 4; ++i)
+            siblings[i] = SPRITE_SLOT_ABSENT;
+        ++sizeClass;
+        slotIndex >>= 2;
+        cache->SlotStates[sizeClass][slotIndex] = SPRITE_SLOT_FREE;
+    }
+}
+
+// NOTE(Joey): entries still being built or drawn this frame (their texels are read by this frame's RenderPass)
+inline bool32 IsCachedSpriteInUse(sprite_cache *cache, cached_sprite *sprite)
+{
+    return sprite->State == SPRITE_CACHE_BUILDING || sprite->LastUsedFrame == cache->FrameIndex;
+}
+
+internal void EvictCachedSprite(sprite_cache *cache, cached_sprite *sprite)
+{
+    UnlinkCachedSprite(cache, sprite);
+    sprite->Prev->Next = sprite->Next;
+    sprite->Next->Prev = sprite->Prev;
+    FreeSpriteSlot(cache, sprite->SizeClass, sprite->SlotIndex);
+
+    sprite->NextInHash = cache->FreeEntries;
+    cache->FreeEntries = sprite;
+}
+
+// NOTE(Joey): the range of slots of blockClass that overlap the sprite's slot
+inline void GetOverlappedSpriteSlots(cached_sprite *sprite, uint32 blockClass, uint32 *first, uint32 *count)
+{
+    if(sprite->SizeClass >= blockClass)
+    {
+        uint32 shift = 2*(sprite->SizeClass - blockClass);
+        *first = sprite->SlotIndex << shift;
+        *count = 1u << shift;
+    }
+    else
+    {
+        *first = sprite->SlotIndex >> 2*(blockClass - sprite->SizeClass);
+        *count = 1;
+    }
+}
+
+/* NOTE(Joey):
+
+  Empties the block of slots of the given size class whose most recently
+  used entry is the oldest, skipping blocks holding entries that are in
+  use. Blocks without any entries are skipped too: if there were one,
+  AllocateSpriteSlot would've found it (so we're out of entries, not
+  memory). Returns false if no block can be emptied.
+
+*/
+internal bool32 EvictSpriteSlotBlock(sprite_cache *cache, uint32 sizeClass)
+{
+    uint32 blockCount = GetSpriteSlotCount(cache, sizeClass);
+    uint32 *blockUse = cache->BlockUse;
+    for(uint32 i = 0; i < blockCount; ++i)
+        blockUse[i] = 0;
+
+    for(uint32 i = 0; i < cache->EntryCount; ++i)
+    {
+        cached_sprite *sprite = cache->Entries + i;
+        if(sprite->State == SPRITE_CACHE_EMPTY)
+            continue;
+        uint32 use = IsCachedSpriteInUse(cache, sprite) ? 0xFFFFFFFF : sprite->LastUsedFrame + 1;
+        uint32 first, count;
+        GetOverlappedSpriteSlots(sprite, sizeClass, &first, &count);
+        for(uint32 j = first; j < first + count; ++j)
+            blockUse[j] = Maximum(blockUse[j], use);
+    }
+
+    uint32 victim = blockCount;
+    for(uint32 i = 0; i < blockCount; ++i)
+    {
+        if(blockUse[i] != 0 && blockUse[i] != 0xFFFFFFFF &&
+           (victim == blockCount || blockUse[i] < blockUse[victim]))
+            victim = i;
+    }
+    if(victim == blockCount)
+        return false;
+
+    for(uint32 i = 0; i < cache->EntryCount; ++i)
+    {
+        cached_sprite *sprite = cache->Entries + i;
+        if(sprite->State == SPRITE_CACHE_EMPTY)
+            continue;
+        uint32 first, count;
+        GetOverlappedSpriteSlots(sprite, sizeClass, &first, &count);
+        if(victim >= first && victim < first + count)
+            EvictCachedSprite(cache, sprite);
+    }
+    return true;
+}
+
+internal cached_sprite *AcquireCachedSprite(sprite_cache *cache, uint32 sizeClass)
+{
+    uint32 slotSize = SPRITE_CACHE_MIN_SLOT_SIZE << sizeClass;
+    for(;;)
+    {
+        // NOTE(Joey): take a free slot if there's one
+        cached_sprite *sprite = cache->FreeEntries;
+        if(!sprite && cache->EntryCount < SPRITE_CACHE_MAX_ENTRIES)
+            sprite = cache->Entries + cache->EntryCount;
+        uint32 slotIndex;
+        if(sprite && AllocateSpriteSlot(cache, sizeClass, &slotIndex))
+        {
+            if(sprite == cache->FreeEntries)
+                cache->FreeEntries = sprite->NextInHash;
+            else
+                ++cache->EntryCount;
+
+            sprite->State         = SPRITE_CACHE_EMPTY;
+            sprite->SizeClass     = sizeClass;
+            sprite->SlotIndex     = slotIndex;
+            sprite->LastUsedFrame = 0;
+            sprite->NextInHash    = 0;
+            sprite->Sprite.Format = TEXTURE_FORMAT_ARGB32;
+            sprite->Sprite.Pitch  = slotSize*sizeof(uint32);
+            sprite->Sprite.Texels = (uint32*)(cache->SlotMemory + slotIndex*GetSpriteSlotBytes(sizeClass));
+
+            cached_sprite *sentinel = cache->Sentinels + sizeClass;
+            sprite->Next = sentinel->Next;
+            sprite->Prev = sentinel;
+            sprite->Next->Prev = sprite;
+            sprite->Prev->Next = sprite;
+            return sprite;
+        }
+
+        // NOTE(Joey): otherwise the least recently used entry of the same size class takes its slot over
+        cached_sprite *sentinel = cache->Sentinels + sizeClass;
+        for(sprite = sentinel->Prev; sprite != sentinel; sprite = sprite->Prev)
+        {
+            if(!IsCachedSpriteInUse(cache, sprite))
+            {
+                UnlinkCachedSprite(cache, sprite);
+                return sprite;
+            }
+        }
+
+        // NOTE(Joey): otherwise make room from other size classes and retry; each call evicts at least one entry
+        if(!EvictSpriteSlotBlock(cache, sizeClass))
+            return 0;
+    }
+}
+
+// NOTE(Joey): scalar bilinear fetch with the same texel mapping as RenderTexture_; returns [0, 255] per channel
+inline vector4D SampleSpriteSource(Texture *texture, real32 u, real32 v)
+{
+    real32 tX = u*(real32)(texture->Width - 2) + 0.5f;
+    real32 tY = v*(real32)(texture->Height - 2) + 0.5f;
+    int32 fetchX = (int32)tX;
+    int32 fetchY = (int32)tY;
+    real32 fX = tX - (real32)fetchX;
+    real32 fY = tY - (real32)fetchY;
+
+    // NOTE(Joey): GetTexel decodes palettized/block-compressed sources
+    uint32 texel00 = GetTexel(texture, fetchX,     fetchY);
+    uint32 texel10 = GetTexel(texture, fetchX + 1, fetchY);
+    uint32 texel01 = GetTexel(texture, fetchX,     fetchY + 1);
+    uint32 texel11 = GetTexel(texture, fetchX + 1, fetchY + 1);
+    vector4D top    = Lerp(TexelToVector4D(&texel00), TexelToVector4D(&texel10), fX);
+    vector4D bottom = Lerp(TexelToVector4D(&texel01), TexelToVector4D(&texel11), fX);
+    vector4D result = Lerp(top, bottom, fY);
+    result.a *= 255.0f; // NOTE(Joey): TexelToVector4D normalizes alpha
+    return result;
+}
+
+/* NOTE(Joey):
+
+  Resamples the source texture at the cached sprite's quantized transform.
+  The result is stored with straight alpha, where alpha is the blend factor
+  RenderTexture_ (or RenderTextureSDF_) would've used, so blending the cached
+  sprite with RenderBlitBlended_ gives the same result as drawing it directly.
+  This runs once per cache entry so it's kept scalar.
+
+*/
+void DoBuildCachedSpriteWork(platform_work_queue *queue, void *data)
+{
+    cached_sprite *sprite = (cached_sprite*)data;
+    sprite_cache_key *key = &sprite->Key;
+    Texture *source = sprite->Source;
+    Texture *dest = &sprite->Sprite;
+
+    vector2D basisX = GetSpriteCacheBasis(key->AngleIndex);
+    vector2D axisX = (real32)key->SizeX*basisX;
+    vector2D axisY = (real32)key->SizeY*Perpendicular(basisX);
+    vector2D origin = { 0.5f*(real32)dest->Width, 0.5f*(real32)dest->Height };
+    origin = origin - 0.5f*axisX - 0.5f*axisY;
+    real32 invSquareLengthX = 1.0f / LengthSq(axisX);
+    real32 invSquareLengthY = 1.0f / LengthSq(axisY);
+
+    vector4D color = { (real32)((key->Color >> 16) & 0xFF) / 255.0f,
+                       (real32)((key->Color >> 8) & 0xFF) / 255.0f,
+                       (real32)((key->Color >> 0) & 0xFF) / 255.0f,
+                       (real32)((key->Color >> 24) & 0xFF) / 255.0f };
+
+    // NOTE(Joey): same edge reconstruction as RenderTextureSDF_
+    real32 edgeMin = 0.0f;
+    real32 invEdgeRange = 0.0f;
+    if(key->SDFSpread > 0.0f)
+    {
+        real32 texelsPerPixel = Max((real32)source->Width / Max(Length(axisX), 1.0f),
+                                    (real32)source->Height / Max(Length(axisY), 1.0f));
+        real32 edgeHalfWidth = Clamp(1.0f / 255.0f, 0.5f, 0.25f*texelsPerPixel / key->SDFSpread);
+        edgeMin = 0.5f - edgeHalfWidth;
+        invEdgeRange = 1.0f / (2.0f*edgeHalfWidth);
+    }
+
+    uint8 *destRow = (uint8*)dest->Texels;
+    for(uint32 y = 0; y < dest->Height; ++y, destRow += dest->Pitch)
+    {
+        uint32 *destTexel = (uint32*)destRow;
+        for(uint32 x = 0; x < dest->Width; ++x)
+        {
+            vector2D d = { (real32)x - origin.x, (real32)y - origin.y };
+            real32 u = InnerProduct(d, axisX)*invSquareLengthX;
+            real32 v = InnerProduct(d, axisY)*invSquareLengthY;
+            if(u < 0.0f || u > 1.0f || v < 0.0f || v > 1.0f)
+            {
+                *destTexel++ = 0;
+                continue;
+            }
+
+            vector4D texel = SampleSpriteSource(source, u, v);
+            real32 r, g, b, a;
+            if(key->SDFSpread > 0.0f)
+            {
+                real32 t = Clamp01((texel.a / 255.0f - edgeMin)*invEdgeRange);
+                a = 255.0f*t*t*(3.0f - 2.0f*t)*color.a;
+                r = 255.0f*color.r;
+                g = 255.0f*color.g;
+                b = 255.0f*color.b;
+            }
+            else
+            {
+                a = texel.a*color.a;
+                r = Min(texel.r*color.r, 255.0f);
+                g = Min(texel.g*color.g, 255.0f);
+                b = Min(texel.b*color.b, 255.0f);
+            }
+            *destTexel++ = (RoundReal32ToUInt32(a) << 24) |
+                           (RoundReal32ToUInt32(r) << 16) |
+                           (RoundReal32ToUInt32(g) << 8)  |
+                           (RoundReal32ToUInt32(b) << 0);
+        }
+    }
+
+    // NOTE(Joey): done reading the source; its asset may be evicted from here on
+    if(sprite->SourceReferenceCount)
+        _InterlockedDecrement((volatile long*)sprite->SourceReferenceCount);
+
+    // NOTE(Joey): make sure all texels are written before the main thread sees the sprite as ready
+    _WriteBarrier();
+    _InterlockedExchange((volatile long*)&sprite->State, SPRITE_CACHE_READY);
+}
+
+/* NOTE(Joey):
+
+  Pushes a blended blit of the cached sprite if it's available and returns
+  true. Otherwise the sprite is queued for building (if it's cacheable and
+  there's room) and false is returned; the caller then draws the sprite
+  the regular way this frame.
+
+  referenceCount (if any) is incremented for as long as the sprite is
+  built, as the build reads the texture on a background thread.
+
+  Only uniformly scaled rotations are cacheable: basisY has to be basisX's
+  unit-length perpendicular. The cached sprite is placed at whole pixels,
+  so it may be offset by up to half a pixel compared to the direct path.
+
+*/
+internal bool32 PushCachedSprite_(RenderQueue *queue,
+                                  sprite_cache *cache,
+                                  Texture *texture,
+                                  uint32 sourceID,
+                                  uint32 sourceGeneration,
+                                  volatile uint32 *referenceCount,
+                                  vector2D position,
+                                  uint32 depth,
+                                  vector2D size,
+                                  vector2D basisX,
+                                  vector2D basisY,
+                                  vector4D color,
+                                  real32 sdfSpread)
+{
+    if(!texture || !texture->Texels)
+        return false;
+
+    vector2D perpendicular = Perpendicular(basisX);
+    if(Absolute(LengthSq(basisX) - 1.0f) > 0.001f ||
+       Absolute(basisY.x - perpendicular.x) > 0.001f || Absolute(basisY.y - perpendicular.y) > 0.001f)
+        return false;
+
+    sprite_cache_key key;
+    key.SourceID         = sourceID;
+    key.SourceGeneration = sourceGeneration;
+    key.StaticSource     = sourceID ? 0 : texture;
+    key.AngleIndex       = (uint32)RoundReal32ToInt32(ATan2(basisX.y, basisX.x)*((real32)SPRITE_CACHE_ANGLE_STEPS / (2.0f*Pi32))) &
+                           (SPRITE_CACHE_ANGLE_STEPS - 1);
+    key.SizeX            = (int16)RoundReal32ToInt32(size.x);
+    key.SizeY            = (int16)RoundReal32ToInt32(size.y);
+    key.Color            = PackColor(color);
+    key.SDFSpread        = sdfSpread;
+    if(key.SizeX == 0 || key.SizeY == 0)
+        return false;
+
+    cached_sprite **slot = cache->Hash + GetSpriteCacheHash(&key);
+    for(cached_sprite *sprite = *slot; sprite; sprite = sprite->NextInHash)
+    {
+        if(SpriteCacheKeysEqual(&sprite->Key, &key))
+        {
+            TouchCachedSprite(cache, sprite);
+            if(sprite->State != SPRITE_CACHE_READY)
+            {   // NOTE(Joey): still being built
+                ++cache->MissCount;
+                return false;
+            }
+
+            vector2D spriteSize = { (real32)sprite->Sprite.Width, (real32)sprite->Sprite.Height };
+            PushBlitBlended(queue, &sprite->Sprite, position - 0.5f*spriteSize, depth);
+            ++cache->HitCount;
+            return true;
+        }
+    }
+    ++cache->MissCount;
+
+    // NOTE(Joey): bounds of the rotated quad plus a pixel of border for the bilinear footprint
+    vector2D quantizedBasisX = GetSpriteCacheBasis(key.AngleIndex);
+    vector2D axisX = (real32)key.SizeX*quantizedBasisX;
+    vector2D axisY = (real32)key.SizeY*Perpendicular(quantizedBasisX);
+    int32 width  = CeilReal32ToInt32(Absolute(axisX.x) + Absolute(axisY.x)) + 2;
+    int32 height = CeilReal32ToInt32(Absolute(axisX.y) + Absolute(axisY.y)) + 2;
+    uint32 edge = (uint32)Maximum(width, height);
+
+    uint32 sizeClass = 0;
+    while(sizeClass < SPRITE_CACHE_SIZE_CLASS_COUNT && (SPRITE_CACHE_MIN_SLOT_SIZE << sizeClass) < edge)
+        ++sizeClass;
+    if(sizeClass == SPRITE_CACHE_SIZE_CLASS_COUNT)
+        return false;
+
+    cached_sprite *sprite = AcquireCachedSprite(cache, sizeClass);
+    if(sprite)
+    {
+        sprite->Key           = key;
+        sprite->Source        = texture;
+        sprite->SourceReferenceCount = referenceCount;
+        if(referenceCount)
+            _InterlockedIncrement((volatile long*)referenceCount);
+        sprite->Sprite.Width  = (uint16)width;
+        sprite->Sprite.Height = (uint16)height;
+        sprite->State         = SPRITE_CACHE_BUILDING;
+        sprite->NextInHash    = *slot;
+        *slot = sprite;
+        TouchCachedSprite(cache, sprite);
+
+        PlatformAPI.AddWorkEntry(PlatformAPI.WorkQueueLowPriority, DoBuildCachedSpriteWork, sprite);
+    }
+    return false;
+}
+
+internal void PushTextureCached(RenderQueue *queue,
+                                sprite_cache *cache,
+                                Texture *texture,
+                                vector2D position,
+                                uint32 depth,
+                                vector2D size,
+                                vector2D basisX,
+                                vector2D basisY,
+                                vector4D color)
+{
+    if(!PushCachedSprite_(queue, cache, texture, 0, 0, 0, position, depth, size, basisX, basisY, color, 0.0f))
+        PushTexture(queue, texture, position, depth, size, basisX, basisY, color);
+}
+
+internal void PushTextureSDFCached(RenderQueue *queue,
+                                   sprite_cache *cache,
+                                   Texture *texture,
+                                   vector2D position,
+                                   uint32 depth,
+                                   vector2D size,
+                                   vector2D basisX,
+                                   vector2D basisY,
+                                   vector4D color,
+                                   real32 spread)
+{
+    if(!PushCachedSprite_(queue, cache, texture, 0, 0, 0, position, depth, size, basisX, basisY, color, spread))
+        PushTextureSDF(queue, texture, position, depth, size, basisX, basisY, color, spread);
+}
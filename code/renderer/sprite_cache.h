@@ -0,0 +1,93 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef SPRITE_CACHE_H
+#define SPRITE_CACHE_H
+
+// NOTE(Joey): rotations are quantized to 256 steps (~1.4 degrees) before they're cached
+const uint32 SPRITE_CACHE_ANGLE_STEPS      = 256;
+const uint32 SPRITE_CACHE_HASH_SIZE        = 512;
+const uint32 SPRITE_CACHE_MAX_ENTRIES      = 512;
+// NOTE(Joey): slots are square with an edge of 32, 64, 128, 256 or 512 pixels; a slot of one
+// size class splits into 4 slots of the size class below it (see AllocateSpriteSlot)
+const uint32 SPRITE_CACHE_MIN_SLOT_SIZE    = 32;
+const uint32 SPRITE_CACHE_SIZE_CLASS_COUNT = 5;
+
+enum sprite_cache_state
+{
+    SPRITE_CACHE_EMPTY,
+    SPRITE_CACHE_BUILDING,
+    SPRITE_CACHE_READY,
+};
+
+enum sprite_slot_state
+{
+    SPRITE_SLOT_ABSENT, // NOTE(Joey): part of a larger slot that isn't split
+    SPRITE_SLOT_FREE,
+    SPRITE_SLOT_USED,
+    SPRITE_SLOT_SPLIT,
+};
+
+// NOTE(Joey): assets are keyed by asset_id and load generation as a reloaded asset's texture keeps its
+// address; textures that aren't assets (SourceID 0) are keyed by address and have to outlive the cache
+struct sprite_cache_key
+{
+    uint32   SourceID;
+    uint32   SourceGeneration;
+    Texture *StaticSource;
+    uint32   AngleIndex;
+    int16    SizeX, SizeY; // NOTE(Joey): in whole pixels; negative sizes mirror the sprite
+    uint32   Color;        // NOTE(Joey): modulation color packed as 0xAARRGGBB
+    real32   SDFSpread;    // NOTE(Joey): 0 for regular textures
+};
+
+// NOTE(Joey): a pre-transformed sprite; kept in a doubly linked list per size class in LRU order
+struct cached_sprite
+{
+    sprite_cache_key Key;
+    volatile uint32  State; // sprite_cache_state; set to READY by the background job
+    uint32           SizeClass;
+    uint32           SlotIndex; // NOTE(Joey): within the slots of its size class
+    uint32           LastUsedFrame;
+    Texture         *Source;
+    volatile uint32 *SourceReferenceCount; // NOTE(Joey): held while the sprite builds; keeps its asset from being evicted
+
+    // NOTE(Joey): Width/Height are the transformed sprite's bounds; Pitch is that of its slot.
+    // Texels hold straight (non-premultiplied) color with the modulation color baked in.
+    Texture Sprite;
+
+    cached_sprite *NextInHash; // NOTE(Joey): next free entry while the entry is unused
+    cached_sprite *Prev;
+    cached_sprite *Next;
+};
+
+struct sprite_cache
+{
+    // NOTE(Joey): the cache's budget; RootSlotCount slots of the largest size class, split as needed
+    uint8  *SlotMemory;
+    uint32  RootSlotCount;
+    uint8  *SlotStates[SPRITE_CACHE_SIZE_CLASS_COUNT]; // NOTE(Joey): sprite_slot_state per slot of each size class
+    uint32 *BlockUse; // NOTE(Joey): scratch of EvictSpriteSlotBlock; an entry per smallest slot
+
+    uint32 FrameIndex;
+    uint32 EntryCount; // NOTE(Joey): entries ever taken from Entries; unused ones are on FreeEntries
+    cached_sprite *FreeEntries;
+
+    // NOTE(Joey): statistics of the current frame
+    uint32 HitCount;
+    uint32 MissCount;
+
+    cached_sprite *Hash[SPRITE_CACHE_HASH_SIZE];
+    cached_sprite  Sentinels[SPRITE_CACHE_SIZE_CLASS_COUNT]; // NOTE(Joey): Next is most recently used
+    cached_sprite  Entries[SPRITE_CACHE_MAX_ENTRIES];
+};
+
+#endif
@@ -19,11 +19,39 @@ inline vector4D TexelToVector4D(uint32 *texel)
     return color;
 }
 
+// NOTE(Joey): scalar counterparts of AddressTexCoord_4x and AddressTexelIndex_4x
+inline real32 AddressTexCoord(real32 coord, texture_address address)
+{
+    if(address == TEXTURE_ADDRESS_WRAP)
+    {
+        coord = coord - (real32)FloorReal32ToInt32(coord);
+    }
+    else if(address == TEXTURE_ADDRESS_MIRROR)
+    {
+        coord = coord - 2.0f*(real32)FloorReal32ToInt32(0.5f*coord);
+        coord = Min(coord, 2.0f - coord);
+    }
+    return Clamp01(coord);
+}
+
+inline int32 AddressTexelIndex(int32 index, int32 size, texture_address address)
+{
+    if(index < 0)
+        index = address == TEXTURE_ADDRESS_WRAP ? size - 1 : 0;
+    else if(index > size - 1)
+        index = address == TEXTURE_ADDRESS_WRAP ? 0 : size - 1;
+    return index;
+}
+
+inline uint32* GetTexelAddress(Texture *texture, int32 x, int32 y)
+{
+    return (uint32*)((uint8*)texture->Texels + y*texture->Pitch + x*sizeof(uint32));
+}
+
 // TODO(Joey): work out overall engine structure before implementing details
-// TODO(Joey): work out wrapping modes w/ uv coordinates out of bound
 internal vector4D TextureSample(Texture *texture, 
                                 vector2D uv, 
-                                bool32 bilinear = true)
+                                texture_sampler sampler = TextureSampler())
 {
     // SEE https://hero.handmadedev.org/videos/game-architecture/day093.html for implementation.    
     /* NOTE(Joey): How texture sampling works:
@@ -43,107 +71,297 @@ internal vector4D TextureSample(Texture *texture,
       neighbouring texels.
 
       The color is returned as 4 color bytes.    
+      
+      The sampler's UV transform, filter and address mode are applied the same
+      way as RenderTextureSampled_ does, texel mapping included.
     */
     
-    // 1. Transform UV data to bitmap space
+    // 1. Transform UV data by the sampler and address it into [0, 1]
     // 2. Sample from texture bitmap
     // 3. If bilinear sampling is enabled: similarly sample from neighbouring texels
 
-    // NOTE(Joey): scale UV to texture size
-    uv.x = Clamp01(uv.x);
-    uv.y = Clamp01(uv.y);
-    uv = Hadamard(uv, { (real32)texture->Width - 2, (real32)texture->Height - 2});
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+
+    uv.x = AddressTexCoord(uv.x*sampler.UVScale.x + sampler.UVOffset.x, sampler.Address);
+    uv.y = AddressTexCoord(uv.y*sampler.UVScale.y + sampler.UVOffset.y, sampler.Address);
+    int32 width = (int32)texture->Width;
+    int32 height = (int32)texture->Height;
+
+    if(sampler.Filter == TEXTURE_FILTER_NEAREST)
+    {
+        int32 X = (int32)Min(uv.x*(real32)width, (real32)(width - 1));
+        int32 Y = (int32)Min(uv.y*(real32)height, (real32)(height - 1));
+        return TexelToVector4D(GetTexelAddress(texture, X, Y));
+    }
 
     // NOTE(Joey): transform to texture sampling data
-    uint32 X = (uint32)uv.x;
-    uint32 Y = (uint32)uv.y;
-    real32 dX = uv.x - X;
-    real32 dY = uv.y - Y;     
-    
-    Assert(X >= 0 && X <= texture->Width);
-    Assert(Y >= 0 && Y <= texture->Height);
-    
-    // NOTE(Joey): sample from texture
-    uint32 *texel00 = (uint32*)((uint8*)texture->Texels + Y*texture->Pitch + X*sizeof(uint32));           
-    vector4D color = TexelToVector4D(texel00);       
-    
-    if(bilinear)
-    {   // lerp between multiple samples given dX and dY
-        uint32 *texel10 = texel00 + 1;
-        uint32 *texel01 = texel00 + (texture->Pitch/sizeof(uint32));
-        uint32 *texel11 = texel01 + 1;
-        
-        vector4D horizontalLerpTop    = Lerp(TexelToVector4D(texel00), TexelToVector4D(texel10), dX);
-        vector4D horizontalLerpBottom = Lerp(TexelToVector4D(texel01), TexelToVector4D(texel11), dX);
-        color = Lerp(horizontalLerpTop, horizontalLerpBottom, dY);
+    int32 X, Y, nextX, nextY;
+    real32 dX, dY;
+    if(sampler.Address == TEXTURE_ADDRESS_CLAMP)
+    {   // NOTE(Joey): biased s.t. the neighbouring texels never leave the texture
+        real32 tX = uv.x*(real32)(width - 2) + 0.5f;
+        real32 tY = uv.y*(real32)(height - 2) + 0.5f;
+        X = (int32)tX;
+        Y = (int32)tY;
+        dX = tX - (real32)X;
+        dY = tY - (real32)Y;
+        nextX = X + 1;
+        nextY = Y + 1;
+    }
+    else
+    {   // NOTE(Joey): texel centers at +0.5; neighbours that fall off the texture are addressed
+        real32 tX = uv.x*(real32)width - 0.5f;
+        real32 tY = uv.y*(real32)height - 0.5f;
+        X = FloorReal32ToInt32(tX);
+        Y = FloorReal32ToInt32(tY);
+        dX = tX - (real32)X;
+        dY = tY - (real32)Y;
+        nextX = AddressTexelIndex(X + 1, width, sampler.Address);
+        nextY = AddressTexelIndex(Y + 1, height, sampler.Address);
+        X = AddressTexelIndex(X, width, sampler.Address);
+        Y = AddressTexelIndex(Y, height, sampler.Address);
     }
     
-    return color;
+    // NOTE(Joey): lerp between the 4 samples given dX and dY
+    vector4D horizontalLerpTop    = Lerp(TexelToVector4D(GetTexelAddress(texture, X, Y)), 
+                                         TexelToVector4D(GetTexelAddress(texture, nextX, Y)), dX);
+    vector4D horizontalLerpBottom = Lerp(TexelToVector4D(GetTexelAddress(texture, X, nextY)), 
+                                         TexelToVector4D(GetTexelAddress(texture, nextX, nextY)), dX);
+    return Lerp(horizontalLerpTop, horizontalLerpBottom, dY);
 }
 
 
-// .BMP Texture loading
-internal Texture LoadTexture(debug_platform_read_entire_file *readEntireFile, 
-                             char *fileName)
+// NOTE(Joey): a fetch position reads texels x and x + 1 of two texel rows; see texture_spans
+inline bool32 IsFetchLive(uint32 *row0, uint32 *row1, uint32 x)
 {
-    Texture result = {};
-    
-    debug_read_file_result readResult = readEntireFile(fileName);    
-    if(readResult.ContentSize != 0)
+    return ((row0[x] | row0[x + 1] | row1[x] | row1[x + 1]) & 0xFF000000) != 0;
+}
+
+internal uint32 CountTextureSpans(Texture *texture)
+{
+    uint32 rowCount = texture->Height - 1;
+    uint32 fetchWidth = texture->Width - 1;
+    uint32 spanCount = 0;
+    for(uint32 y = 0; y < rowCount; ++y)
     {
-        bitmap_header *header = (bitmap_header *)readResult.Contents;
-        uint32 *pixels = (uint32*)((uint8*)readResult.Contents + header->BitmapOffset);
-        result.Texels = pixels;
-        result.Width  = (uint16)header->Width;
-        result.Height = (uint16)header->Height;
-        
+        uint32 *row0 = (uint32*)((uint8*)texture->Texels + y*texture->Pitch);
+        uint32 *row1 = (uint32*)((uint8*)row0 + texture->Pitch);
+        bool32 inSpan = false;
+        for(uint32 x = 0; x < fetchWidth; ++x)
+        {
+            bool32 live = IsFetchLive(row0, row1, x);
+            if(live && !inSpan)
+                ++spanCount;
+            inSpan = live;
+        }
+    }
+    return spanCount;
+}
 
-        //Assert(header->Compression == 3);
-        
-        // NOTE(Joey): byte order in memory is AA BB GG RR (AA first in lowest memory address), bottom upper_bound
-        // CPU reads it in as: RR GG BB AA (first reads AA, then BB)
-        // we need AA first so switch AA to the back for each pixel
-        // !!!actually: byte order is determined by the header itself with 3 masks for each individual color
-        
-        uint32 redMask = header->RedMask;
-        uint32 greenMask = header->GreenMask;
-        uint32 blueMask = header->BlueMask;
-        uint32 alphaMask = ~(redMask | greenMask | blueMask);
-        
-        uint32 redShift = 0;
-        uint32 greenShift = 0;
-        uint32 blueShift = 0;
-        uint32 alphaShift = 0;              
-        
-        bool32 found = FindLeastSignificantSetBit(&redShift, redMask);
-        Assert(found);
-        found = FindLeastSignificantSetBit(&greenShift, greenMask);
-        Assert(found);
-        found = FindLeastSignificantSetBit(&blueShift, blueMask);
-        Assert(found);
-        found = FindLeastSignificantSetBit(&alphaShift, alphaMask);
-        Assert(found);
-        
-        redShift = 16 - (int32)redShift;
-        greenShift = 8 - (int32)greenShift;
-        blueShift = 0 - (int32)blueShift;
-        alphaShift = 24 - (int32)alphaShift;
+inline memory_index GetTextureSpansSize(Texture *texture, uint32 spanCount)
+{
+    uint32 rowCount = texture->Height - 1;
+    uint32 coverageWidth = (texture->Width - 1 + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    uint32 coverageHeight = (rowCount + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    // NOTE(Joey): add some slack for the alignment of each of the 4 allocations
+    return sizeof(texture_spans) + (rowCount + 1)*sizeof(uint32) + 
+           2*spanCount*sizeof(uint16) + coverageWidth*coverageHeight + 4*8;
+}
+
+// NOTE(Joey): memory BuildTextureSpans needs for the texture's span table; 0 if it doesn't get one
+internal memory_index GetTextureSpansSize(Texture *texture)
+{
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+    if(texture->Width < 2 || texture->Height < 2)
+        return 0;
+    return GetTextureSpansSize(texture, CountTextureSpans(texture));
+}
+
+/* NOTE(Joey):
+
+  Builds the texture's span table (see texture_spans) in two passes: one to
+  count the spans so the exact amount of memory is known up front and one 
+  to store them. If the arena can't hold the table the texture is simply 
+  left without one and gets rasterized in full.
+
+*/
+internal bool32 BuildTextureSpans(Texture *texture, memory_arena *arena)
+{
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+    texture->Spans = 0;
+    if(texture->Width < 2 || texture->Height < 2)
+        return false;
+    
+    uint32 rowCount = texture->Height - 1;
+    uint32 fetchWidth = texture->Width - 1;
+    uint32 spanCount = CountTextureSpans(texture);
+    uint32 coverageWidth = (fetchWidth + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    uint32 coverageHeight = (rowCount + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    memory_index size = GetTextureSpansSize(texture, spanCount);
+    if(arena->Used + size > arena->Size)
+        return false;
+    
+    texture_spans *spans = PushStruct(arena, texture_spans, 8);
+    spans->RowCount       = rowCount;
+    spans->RowSpanStart   = PushArray(arena, rowCount + 1, uint32);
+    spans->Spans          = PushArray(arena, 2*spanCount, uint16);
+    spans->CoverageWidth  = coverageWidth;
+    spans->CoverageHeight = coverageHeight;
+    spans->Coverage       = PushArray(arena, coverageWidth*coverageHeight, uint8);
+    ZeroSize(spans->Coverage, coverageWidth*coverageHeight);
+    
+    uint32 spanIndex = 0;
+    for(uint32 y = 0; y < rowCount; ++y)
+    {
+        uint32 *row0 = (uint32*)((uint8*)texture->Texels + y*texture->Pitch);
+        uint32 *row1 = (uint32*)((uint8*)row0 + texture->Pitch);
+        uint8 *coverageRow = spans->Coverage + (y >> TEXTURE_COVERAGE_CELL_SHIFT)*coverageWidth;
+        spans->RowSpanStart[y] = spanIndex;
         
-        result.Pitch = result.Width*sizeof(uint32);
-        uint32 *sourceDest = pixels;
-        for(uint32 y = 0; y < result.Height; ++y)
+        uint32 x = 0;
+        while(x < fetchWidth)
         {
-            for(uint32 x = 0; x < result.Width; ++x)
+            // NOTE(Joey): skip the transparent run, then store the live one
+            while(x < fetchWidth && !IsFetchLive(row0, row1, x))
+                ++x;
+            if(x == fetchWidth)
+                break;
+            uint32 spanMinX = x;
+            while(x < fetchWidth && IsFetchLive(row0, row1, x))
             {
-                uint32 C = *sourceDest;
-
-                *sourceDest++ = (RotateLeft(C & redMask, redShift) |
-                                 RotateLeft(C & greenMask, greenShift) |
-                                 RotateLeft(C & blueMask, blueShift) |
-                                 RotateLeft(C & alphaMask, alphaShift));
-            }            
+                coverageRow[x >> TEXTURE_COVERAGE_CELL_SHIFT] = 1;
+                ++x;
+            }
+            spans->Spans[2*spanIndex + 0] = (uint16)spanMinX;
+            spans->Spans[2*spanIndex + 1] = (uint16)x;
+            ++spanIndex;
         }
     }
+    spans->RowSpanStart[rowCount] = spanIndex;
+    Assert(spanIndex == spanCount);
+    
+    texture->Spans = spans;
+    return true;
+}
+
+/* NOTE(Joey):
+
+  Packed span tables (see vpak.h) store the arrays of a texture_spans back
+  to back: RowSpanStart, Spans, then Coverage. Each array stays 4 byte 
+  aligned as long as the table itself is.
+
+*/
+inline memory_index GetPackedTextureSpansSize(uint32 width, uint32 height, uint32 spanCount)
+{
+    uint32 rowCount = height - 1;
+    uint32 coverageWidth = (width - 1 + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    uint32 coverageHeight = (rowCount + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    return (rowCount + 1)*sizeof(uint32) + 2*spanCount*sizeof(uint16) + coverageWidth*coverageHeight;
+}
+
+// NOTE(Joey): points spans at a packed span table in memory; nothing is copied
+internal void MapPackedTextureSpans(texture_spans *spans, uint32 width, uint32 height, uint32 spanCount, void *memory)
+{
+    spans->RowCount       = height - 1;
+    spans->CoverageWidth  = (width - 1 + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    spans->CoverageHeight = (spans->RowCount + (1 << TEXTURE_COVERAGE_CELL_SHIFT) - 1) >> TEXTURE_COVERAGE_CELL_SHIFT;
+    spans->RowSpanStart   = (uint32*)memory;
+    spans->Spans          = (uint16*)(spans->RowSpanStart + spans->RowCount + 1);
+    spans->Coverage       = (uint8*)(spans->Spans + 2*spanCount);
+}
+
+// NOTE(Joey): stores the texture's span table in the packed layout; dest holds GetPackedTextureSpansSize bytes
+internal void StorePackedTextureSpans(Texture *texture, void *dest)
+{
+    texture_spans *spans = texture->Spans;
+    uint32 spanCount = spans->RowSpanStart[spans->RowCount];
+    texture_spans packed;
+    MapPackedTextureSpans(&packed, texture->Width, texture->Height, spanCount, dest);
+    Assert(packed.RowCount == spans->RowCount && packed.CoverageWidth == spans->CoverageWidth);
+    
+    for(uint32 i = 0; i <= spans->RowCount; ++i)
+        packed.RowSpanStart[i] = spans->RowSpanStart[i];
+    for(uint32 i = 0; i < 2*spanCount; ++i)
+        packed.Spans[i] = spans->Spans[i];
+    for(uint32 i = 0; i < spans->CoverageWidth*spans->CoverageHeight; ++i)
+        packed.Coverage[i] = spans->Coverage[i];
+}
+
+// NOTE(Joey): byte order in memory is AA BB GG RR (AA first in lowest memory address), bottom upper_bound
+// CPU reads it in as: RR GG BB AA (first reads AA, then BB)
+// we need AA first so switch AA to the back for each pixel
+// !!!actually: byte order is determined by the header itself with 3 masks for each individual color
+internal bitmap_format GetBitmapFormat(bitmap_header *header)
+{
+    bitmap_format format;
+    format.RedMask = header->RedMask;
+    format.GreenMask = header->GreenMask;
+    format.BlueMask = header->BlueMask;
+    format.AlphaMask = ~(format.RedMask | format.GreenMask | format.BlueMask);
+    
+    uint32 redShift = 0;
+    uint32 greenShift = 0;
+    uint32 blueShift = 0;
+    uint32 alphaShift = 0;              
+    
+    bool32 found = FindLeastSignificantSetBit(&redShift, format.RedMask);
+    Assert(found);
+    found = FindLeastSignificantSetBit(&greenShift, format.GreenMask);
+    Assert(found);
+    found = FindLeastSignificantSetBit(&blueShift, format.BlueMask);
+    Assert(found);
+    found = FindLeastSignificantSetBit(&alphaShift, format.AlphaMask);
+    Assert(found);
+    
+    format.RedShift = 16 - (int32)redShift;
+    format.GreenShift = 8 - (int32)greenShift;
+    format.BlueShift = 0 - (int32)blueShift;
+    format.AlphaShift = 24 - (int32)alphaShift;
+    
+    return format;
+}
+
+inline uint32 ConvertBitmapTexel(bitmap_format *format, uint32 C)
+{
+    return (RotateLeft(C & format->RedMask, format->RedShift) |
+            RotateLeft(C & format->GreenMask, format->GreenShift) |
+            RotateLeft(C & format->BlueMask, format->BlueShift) |
+            RotateLeft(C & format->AlphaMask, format->AlphaShift));
+}
+
+// .BMP Texture loading
+// NOTE(Joey): whether the .BMP's texels can be decoded: 32 bit and tightly packed
+inline bool32 IsSupportedBitmap(bitmap_header *header)
+{
+    return header->FileType == 0x4D42 && header->BitsPerPixel == 32 && 
+           header->Width > 0 && header->Height > 0;
+}
+
+// NOTE(Joey): size of the texels DecodeBitmap writes; the .BMP's header isn't part of them
+inline memory_index GetDecodedBitmapSize(bitmap_header *header)
+{
+    return (memory_index)header->Width*header->Height*sizeof(uint32);
+}
+
+// NOTE(Joey): converts the .BMP's texels to ARGB into dest; dest may be the texels in the file's own memory
+internal Texture DecodeBitmap(void *contents, uint32 *dest)
+{
+    Texture result = {};
+    
+    bitmap_header *header = (bitmap_header *)contents;
+    uint32 *source = (uint32*)((uint8*)contents + header->BitmapOffset);
+    result.Texels = dest;
+    result.Width  = (uint16)header->Width;
+    result.Height = (uint16)header->Height;
+    
+    //Assert(header->Compression == 3);
+    
+    bitmap_format format = GetBitmapFormat(header);
+    
+    result.Pitch = result.Width*sizeof(uint32);
+    uint32 texelCount = result.Width*result.Height;
+    for(uint32 i = 0; i < texelCount; ++i)
+        dest[i] = ConvertBitmapTexel(&format, source[i]);
     return result;
 }
 
@@ -164,10 +382,430 @@ internal Texture CreateEmptyTexture(memory_arena *arena,
     return texture;
 }    
 
+// NOTE(Joey): expands a 5:6:5 color to 0xAARRGGBB, replicating the top bits into the lowest ones
+inline uint32 ExpandColor565(uint32 color)
+{
+    uint32 r = (color >> 11) & 0x1F;
+    uint32 g = (color >> 5) & 0x3F;
+    uint32 b = (color >> 0) & 0x1F;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+// NOTE(Joey): expands 4 5:6:5 colors to 0x00RRGGBB
+inline __m128i ExpandColor565_4x(__m128i color)
+{
+    const __m128i mask1F = _mm_set1_epi32(0x1F);
+    const __m128i mask3F = _mm_set1_epi32(0x3F);
+    __m128i r = _mm_and_si128(_mm_srli_epi32(color, 11), mask1F);
+    __m128i g = _mm_and_si128(_mm_srli_epi32(color, 5), mask3F);
+    __m128i b = _mm_and_si128(color, mask1F);
+    r = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+    g = _mm_or_si128(_mm_slli_epi32(g, 2), _mm_srli_epi32(g, 4));
+    b = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8)), b);
+}
+
+/* NOTE(Joey):
+
+  A TEXTURE_FORMAT_BLOCK4X4 block holds two 5:6:5 endpoints followed by 16
+  2 bit indices, texel (x, y) of the block at bits 2*(4*y + x). As in DXT1: 
+  if endpoint 0 > endpoint 1 the indices select from both endpoints and 2 
+  colors at a third and two thirds in between, otherwise from the endpoints,
+  their average and transparent black. RenderTextureSampled_ decodes the
+  same palette 4 blocks at a time; keep both in sync.
+
+*/
+inline void GetBlockPalette(uint32 endpoints, uint32 *palette)
+{
+    uint32 color0 = endpoints & 0xFFFF;
+    uint32 color1 = endpoints >> 16;
+    palette[0] = ExpandColor565(color0);
+    palette[1] = ExpandColor565(color1);
+    palette[2] = 0xFF000000;
+    palette[3] = color0 > color1 ? 0xFF000000 : 0;
+    for(uint32 shift = 0; shift < 24; shift += 8)
+    {
+        uint32 a = (palette[0] >> shift) & 0xFF;
+        uint32 b = (palette[1] >> shift) & 0xFF;
+        if(color0 > color1)
+        {
+            palette[2] |= ((2*a + b) / 3) << shift;
+            palette[3] |= ((a + 2*b) / 3) << shift;
+        }
+        else
+        {
+            palette[2] |= ((a + b) / 2) << shift;
+        }
+    }
+}
+
+// NOTE(Joey): scalar texel fetch of any texture format; returns 0xAARRGGBB
+inline uint32 GetTexel(Texture *texture, uint32 x, uint32 y)
+{
+    uint32 result = 0;
+    switch(texture->Format)
+    {
+        case TEXTURE_FORMAT_ARGB32:
+        {
+            result = *(uint32*)((uint8*)texture->Texels + y*texture->Pitch + x*sizeof(uint32));
+        } break;
+        case TEXTURE_FORMAT_PALETTE8:
+        {
+            result = texture->Palette[*((uint8*)texture->Texels + y*texture->Pitch + x)];
+        } break;
+        case TEXTURE_FORMAT_BLOCK4X4:
+        {
+            uint8 *block = (uint8*)texture->Texels + (y >> 2)*texture->Pitch + (x >> 2)*TEXTURE_BLOCK_BYTES;
+            uint32 palette[4];
+            GetBlockPalette(*(uint32*)block, palette);
+            result = palette[(*(uint32*)(block + 4) >> 2*(4*(y & 3) + (x & 3))) & 3];
+        } break;
+        default:
+        {
+            InvalidCodePath;
+        }
+    }
+    return result;
+}
+
+inline uint32 GetPaletteBucketKey(uint32 texel)
+{
+    return ((texel >> 17) & 0x7000) | ((texel >> 12) & 0x0F00) | ((texel >> 8) & 0x00F0) | ((texel >> 4) & 0x000F);
+}
+
+// NOTE(Joey): extent of the box's bucket keys along its widest channel (0 is blue, 3 is alpha)
+internal uint32 GetPaletteBoxRange(uint16 *order, palette_box *box, uint32 *widestChannel)
+{
+    uint32 minValue[4] = { 15, 15, 15, 7 };
+    uint32 maxValue[4] = { 0, 0, 0, 0 };
+    for(uint32 i = box->First; i < box->OnePastLast; ++i)
+    {
+        for(uint32 channel = 0; channel < 4; ++channel)
+        {
+            uint32 value = (order[i] >> 4*channel) & 0xF;
+            minValue[channel] = Minimum(minValue[channel], value);
+            maxValue[channel] = Maximum(maxValue[channel], value);
+        }
+    }
+    
+    uint32 range = 0;
+    for(uint32 channel = 0; channel < 4; ++channel)
+    {
+        // NOTE(Joey): alpha buckets are twice as wide
+        uint32 channelRange = (maxValue[channel] - minValue[channel]) << (channel == 3 ? 1 : 0);
+        if(channelRange >= range)
+        {
+            range = channelRange;
+            *widestChannel = channel;
+        }
+    }
+    return range;
+}
+
+// NOTE(Joey): offset in bytes of a TEXTURE_FORMAT_PALETTE8 texture's palette from its indices
+inline uint32 GetTexturePaletteOffset(uint32 width, uint32 height)
+{
+    return (width*height + 3) & ~3;
+}
+
+// NOTE(Joey): in bytes; per row of blocks for TEXTURE_FORMAT_BLOCK4X4
+inline uint32 GetTexturePitch(uint32 width, texture_format format)
+{
+    uint32 result = 0;
+    switch(format)
+    {
+        case TEXTURE_FORMAT_ARGB32:   { result = width*sizeof(uint32); } break;
+        case TEXTURE_FORMAT_PALETTE8: { result = width; } break;
+        case TEXTURE_FORMAT_BLOCK4X4: { result = ((width + 3) / 4)*TEXTURE_BLOCK_BYTES; } break;
+    }
+    return result;
+}
+
+// NOTE(Joey): memory a texture's texels take in the given format, including the palette of TEXTURE_FORMAT_PALETTE8
+inline memory_index GetTextureDataSize(uint32 width, uint32 height, texture_format format)
+{
+    if(format == TEXTURE_FORMAT_PALETTE8)
+        return GetTexturePaletteOffset(width, height) + TEXTURE_PALETTE_SIZE*sizeof(uint32);
+    uint32 rowCount = format == TEXTURE_FORMAT_BLOCK4X4 ? (height + 3) / 4 : height;
+    return (memory_index)rowCount*GetTexturePitch(width, format);
+}
+
+/* NOTE(Joey):
+
+  Converts an ARGB32 texture to TEXTURE_FORMAT_PALETTE8 in place with median
+  cut quantization: the texels' histogram buckets are recursively split at
+  the median of the widest channel of the box that has the most texels times
+  extent, until there are 255 boxes; each palette entry is the average color
+  of a box. Index 0 is reserved for fully transparent texels s.t. they stay
+  fully transparent (the texture's span tables remain valid).
+  
+  Indices are written over the texels they replace; the palette is stored 
+  right after them, so textures need at least 342 texels.
+
+*/
+internal bool32 CompressTexturePalette(Texture *texture, memory_arena *scratchArena)
+{
+    uint32 texelCount = texture->Width*texture->Height;
+    uint32 paletteOffset = GetTexturePaletteOffset(texture->Width, texture->Height);
+    if(paletteOffset + TEXTURE_PALETTE_SIZE*sizeof(uint32) > texelCount*sizeof(uint32))
+        return false;
+    
+    temp_memory scratchMemory = BeginTempMemory(scratchArena);
+    palette_bucket *buckets = PushArray(scratchArena, PALETTE_BUCKET_COUNT, palette_bucket);
+    uint16 *order = PushArray(scratchArena, PALETTE_BUCKET_COUNT, uint16);
+    uint16 *sorted = PushArray(scratchArena, PALETTE_BUCKET_COUNT, uint16);
+    uint8 *bucketIndex = PushArray(scratchArena, PALETTE_BUCKET_COUNT, uint8);
+    ZeroSize(buckets, PALETTE_BUCKET_COUNT*sizeof(palette_bucket));
+    
+    uint32 *texels = texture->Texels;
+    for(uint32 i = 0; i < texelCount; ++i)
+    {
+        uint32 texel = texels[i];
+        if(texel & 0xFF000000)
+        {
+            palette_bucket *bucket = buckets + GetPaletteBucketKey(texel);
+            ++bucket->Count;
+            for(uint32 channel = 0; channel < 4; ++channel)
+                bucket->Sum[channel] += (texel >> 8*channel) & 0xFF;
+        }
+    }
+    
+    uint32 keyCount = 0;
+    for(uint32 key = 0; key < PALETTE_BUCKET_COUNT; ++key)
+    {
+        if(buckets[key].Count)
+            order[keyCount++] = (uint16)key;
+    }
+    
+    palette_box boxes[TEXTURE_PALETTE_SIZE - 1];
+    uint32 boxCount = 0;
+    if(keyCount)
+    {
+        boxes[0].First = 0;
+        boxes[0].OnePastLast = keyCount;
+        boxes[0].Count = 0;
+        for(uint32 i = 0; i < keyCount; ++i)
+            boxes[0].Count += buckets[order[i]].Count;
+        boxCount = 1;
+    }
+    while(boxCount < ArrayCount(boxes))
+    {
+        palette_box *split = 0;
+        uint32 splitChannel = 0;
+        uint64 bestScore = 0;
+        for(uint32 i = 0; i < boxCount; ++i)
+        {
+            uint32 channel = 0;
+            uint64 score = (uint64)boxes[i].Count*GetPaletteBoxRange(order, boxes + i, &channel);
+            if(score > bestScore)
+            {
+                bestScore = score;
+                split = boxes + i;
+                splitChannel = channel;
+            }
+        }
+        if(!split)
+            break;
+        
+        // NOTE(Joey): counting sort the box's keys on the widest channel, then split at its median
+        uint32 offsets[17] = {};
+        for(uint32 i = split->First; i < split->OnePastLast; ++i)
+            ++offsets[((order[i] >> 4*splitChannel) & 0xF) + 1];
+        for(uint32 value = 1; value < 17; ++value)
+            offsets[value] += offsets[value - 1];
+        for(uint32 i = split->First; i < split->OnePastLast; ++i)
+            sorted[split->First + offsets[(order[i] >> 4*splitChannel) & 0xF]++] = order[i];
+        for(uint32 i = split->First; i < split->OnePastLast; ++i)
+            order[i] = sorted[i];
+        
+        uint32 median = split->First;
+        uint32 lowerCount = 0;
+        while(median + 1 < split->OnePastLast && 2*(lowerCount + buckets[order[median]].Count) <= split->Count)
+            lowerCount += buckets[order[median++]].Count;
+        if(median == split->First)
+            lowerCount += buckets[order[median++]].Count;
+        
+        palette_box *upper = boxes + boxCount++;
+        upper->First = median;
+        upper->OnePastLast = split->OnePastLast;
+        upper->Count = split->Count - lowerCount;
+        split->OnePastLast = median;
+        split->Count = lowerCount;
+    }
+    
+    uint32 palette[TEXTURE_PALETTE_SIZE] = {};
+    for(uint32 boxIndex = 0; boxIndex < boxCount; ++boxIndex)
+    {
+        palette_box *box = boxes + boxIndex;
+        uint64 sum[4] = {};
+        for(uint32 i = box->First; i < box->OnePastLast; ++i)
+        {
+            palette_bucket *bucket = buckets + order[i];
+            for(uint32 channel = 0; channel < 4; ++channel)
+                sum[channel] += bucket->Sum[channel];
+            bucketIndex[order[i]] = (uint8)(boxIndex + 1);
+        }
+        for(uint32 channel = 0; channel < 4; ++channel)
+            palette[boxIndex + 1] |= (uint32)((sum[channel] + box->Count/2) / box->Count) << 8*channel;
+    }
+    
+    // NOTE(Joey): index i is written after texel i / 4 is read, so this can be done in place
+    uint8 *indices = (uint8*)texture->Texels;
+    for(uint32 i = 0; i < texelCount; ++i)
+    {
+        uint32 texel = texels[i];
+        indices[i] = (texel & 0xFF000000) ? bucketIndex[GetPaletteBucketKey(texel)] : 0;
+    }
+    EndTempMemory(scratchMemory);
+    
+    texture->Palette = (uint32*)(indices + paletteOffset);
+    for(uint32 i = 0; i < TEXTURE_PALETTE_SIZE; ++i)
+        texture->Palette[i] = palette[i];
+    texture->Pitch = texture->Width;
+    texture->Format = TEXTURE_FORMAT_PALETTE8;
+    return true;
+}
+
+inline uint32 GetColorDistanceSq(uint32 a, uint32 b)
+{
+    int32 dr = (int32)((a >> 16) & 0xFF) - (int32)((b >> 16) & 0xFF);
+    int32 dg = (int32)((a >> 8) & 0xFF) - (int32)((b >> 8) & 0xFF);
+    int32 db = (int32)((a >> 0) & 0xFF) - (int32)((b >> 0) & 0xFF);
+    return dr*dr + dg*dg + db*db;
+}
+
+inline uint32 PackColor565(uint32 r, uint32 g, uint32 b)
+{
+    return (((r*31 + 127) / 255) << 11) | (((g*63 + 127) / 255) << 5) | ((b*31 + 127) / 255);
+}
+
+/* NOTE(Joey):
+
+  Converts an ARGB32 texture to TEXTURE_FORMAT_BLOCK4X4 in place (see 
+  GetBlockPalette). Endpoints are the corners of the bounding box of the
+  block's opaque colors; blocks with texels of alpha below 128 use the mode
+  with a transparent index, so alpha is reduced to a single bit. Blocks are
+  written over the texel rows they're read from, which is safe as each block 
+  row takes up less memory than a single texel row.
+
+*/
+internal bool32 CompressTextureBlocks(Texture *texture)
+{
+    uint32 blockCountX = (texture->Width + 3) / 4;
+    uint32 blockCountY = (texture->Height + 3) / 4;
+    uint32 sourcePitch = texture->Pitch;
+    uint8 *dest = (uint8*)texture->Texels;
+    for(uint32 blockY = 0; blockY < blockCountY; ++blockY)
+    {
+        for(uint32 blockX = 0; blockX < blockCountX; ++blockX)
+        {
+            // NOTE(Joey): read the entire block before its memory is overwritten
+            uint32 texels[16];
+            uint32 texelCount = 0;
+            bool32 transparent = false;
+            uint32 minColor[3] = { 255, 255, 255 };
+            uint32 maxColor[3] = { 0, 0, 0 };
+            for(uint32 y = 0; y < 4; ++y)
+            {
+                for(uint32 x = 0; x < 4; ++x)
+                {
+                    uint32 texelX = Minimum(4*blockX + x, (uint32)texture->Width - 1);
+                    uint32 texelY = Minimum(4*blockY + y, (uint32)texture->Height - 1);
+                    uint32 texel = *(uint32*)((uint8*)texture->Texels + texelY*sourcePitch + texelX*sizeof(uint32));
+                    texels[texelCount++] = texel;
+                    if((texel >> 24) < 128)
+                    {
+                        transparent = true;
+                        continue;
+                    }
+                    for(uint32 channel = 0; channel < 3; ++channel)
+                    {
+                        uint32 value = (texel >> 8*channel) & 0xFF;
+                        minColor[channel] = Minimum(minColor[channel], value);
+                        maxColor[channel] = Maximum(maxColor[channel], value);
+                    }
+                }
+            }
+            
+            uint32 color0 = PackColor565(maxColor[2], maxColor[1], maxColor[0]);
+            uint32 color1 = PackColor565(minColor[2], minColor[1], minColor[0]);
+            if(minColor[0] > maxColor[0]) // NOTE(Joey): no opaque texels at all
+                color0 = color1 = 0;
+            // NOTE(Joey): the endpoints' order selects the block's mode
+            if((transparent && color0 > color1) || (!transparent && color0 < color1))
+            {
+                uint32 swap = color0;
+                color0 = color1;
+                color1 = swap;
+            }
+            uint32 endpoints = color0 | (color1 << 16);
+            uint32 palette[4];
+            GetBlockPalette(endpoints, palette);
+            
+            uint32 indices = 0;
+            uint32 colorCount = color0 > color1 ? 4 : 3;
+            for(uint32 i = 0; i < 16; ++i)
+            {
+                uint32 index = 3;
+                if(!transparent || (texels[i] >> 24) >= 128)
+                {
+                    index = 0;
+                    for(uint32 j = 1; j < colorCount; ++j)
+                    {
+                        if(GetColorDistanceSq(texels[i], palette[j]) < GetColorDistanceSq(texels[i], palette[index]))
+                            index = j;
+                    }
+                }
+                indices |= index << 2*i;
+            }
+            
+            *(uint32*)(dest + 0) = endpoints;
+            *(uint32*)(dest + 4) = indices;
+            dest += TEXTURE_BLOCK_BYTES;
+        }
+    }
+    
+    texture->Pitch = blockCountX*TEXTURE_BLOCK_BYTES;
+    texture->Format = TEXTURE_FORMAT_BLOCK4X4;
+    return true;
+}
+
+// NOTE(Joey): compresses an ARGB32 texture in place; build its span table (if any) before doing so
+internal bool32 CompressTexture(Texture *texture, texture_format format, memory_arena *scratchArena)
+{
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
+    Assert(texture->Pitch == texture->Width*sizeof(uint32));
+    bool32 result = false;
+    switch(format)
+    {
+        case TEXTURE_FORMAT_ARGB32:
+        {
+            result = true;
+        } break;
+        case TEXTURE_FORMAT_PALETTE8:
+        {
+            result = CompressTexturePalette(texture, scratchArena);
+        } break;
+        case TEXTURE_FORMAT_BLOCK4X4:
+        {
+            result = CompressTextureBlocks(texture);
+        } break;
+        default:
+        {
+            InvalidCodePath;
+        }
+    }
+    return result;
+}
+
 // NOTE(Joey): more efficient direct blit scheme compared to rendering a full-screen texture into the 
 // buffer with normal render code.
 internal void BlitTextureToScreen(game_offscreen_buffer *screenBuffer, Texture *texture)
 {
+    Assert(texture->Format == TEXTURE_FORMAT_ARGB32);
     Assert(texture->Width <= screenBuffer->Width);
     Assert(texture->Height <= screenBuffer->Height);
     
@@ -12,6 +12,96 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+// NOTE(Joey): coverage cells span 8x8 bilinear fetch positions
+const uint32 TEXTURE_COVERAGE_CELL_SHIFT = 3;
+
+/* NOTE(Joey):
+
+  Span tables of a texture, in bilinear fetch space: fetch position (x, y) 
+  blends texels (x, y) to (x + 1, y + 1) and is live if any of those has a 
+  non-zero alpha. Each of the Height - 1 fetch rows stores its live runs as
+  [MinX, MaxX) pairs; the gaps in between are fully transparent. Coverage 
+  holds a byte per cell, set if any fetch position in the cell is live.
+
+*/
+struct texture_spans
+{
+    uint32  RowCount;
+    uint32 *RowSpanStart; // NOTE(Joey): RowCount + 1 offsets; row y's spans are [RowSpanStart[y], RowSpanStart[y + 1])
+    uint16 *Spans;        // NOTE(Joey): MinX, MaxX pairs
+    
+    uint32  CoverageWidth;
+    uint32  CoverageHeight;
+    uint8  *Coverage;
+};
+
+enum texture_format
+{
+    TEXTURE_FORMAT_ARGB32,
+    TEXTURE_FORMAT_PALETTE8, // NOTE(Joey): a byte per texel indexing a 256 entry ARGB palette
+    TEXTURE_FORMAT_BLOCK4X4, // NOTE(Joey): 8 bytes per block of 4x4 texels; see CompressTextureBlocks
+};
+
+const uint32 TEXTURE_PALETTE_SIZE = 256;
+const uint32 TEXTURE_BLOCK_BYTES  = 8;
+
+/* NOTE(Joey):
+
+  Scratch memory of the palette quantizer (see CompressTexturePalette). Texels
+  are histogrammed in buckets keyed by their top 3 alpha and top 4 color bits;
+  each bucket accumulates its texels' full precision colors.
+
+*/
+const uint32 PALETTE_BUCKET_COUNT = 1 << 15;
+struct palette_bucket
+{
+    uint32 Count;
+    uint64 Sum[4]; // NOTE(Joey): b, g, r, a
+};
+
+struct palette_box
+{
+    uint32 First;       // NOTE(Joey): range of bucket keys in the quantizer's order
+    uint32 OnePastLast;
+    uint32 Count;       // NOTE(Joey): texels in the box
+};
+
+enum texture_filter
+{
+    TEXTURE_FILTER_BILINEAR,
+    TEXTURE_FILTER_NEAREST,
+};
+
+// NOTE(Joey): how texture coordinates outside [0, 1] are resolved
+enum texture_address
+{
+    TEXTURE_ADDRESS_CLAMP,
+    TEXTURE_ADDRESS_WRAP,
+    TEXTURE_ADDRESS_MIRROR,
+};
+
+// NOTE(Joey): per render item sampler state; the quad's [0, 1] UVs are mapped to UV*UVScale + UVOffset
+struct texture_sampler
+{
+    texture_filter  Filter;
+    texture_address Address;
+    vector2D        UVScale;
+    vector2D        UVOffset;
+};
+
+inline texture_sampler TextureSampler(texture_filter filter = TEXTURE_FILTER_BILINEAR, 
+                                      texture_address address = TEXTURE_ADDRESS_CLAMP,
+                                      vector2D uvScale = { 1.0f, 1.0f },
+                                      vector2D uvOffset = { 0.0f, 0.0f })
+{
+    texture_sampler result;
+    result.Filter   = filter;
+    result.Address  = address;
+    result.UVScale  = uvScale;
+    result.UVOffset = uvOffset;
+    return result;
+}
+
 // TODO(Joey): convert bitmaps to texture objects
 struct Texture
 {
@@ -19,7 +109,12 @@ struct Texture
     uint16 Height;
     
     uint32 *Texels;        
-    uint32 Pitch;
+    uint32 Pitch; // NOTE(Joey): in bytes; per row of blocks for TEXTURE_FORMAT_BLOCK4X4
+    
+    texture_format Format;
+    uint32 *Palette; // NOTE(Joey): TEXTURE_FORMAT_PALETTE8
+    
+    texture_spans *Spans; // NOTE(Joey): optional; lets RenderTexture_ skip transparent texels
 };
 
 
@@ -60,4 +155,18 @@ struct bitmap_header
 };
 #pragma pack(pop)
 
+// NOTE(Joey): channel masks of a .BMP's texels and the rotations that move them to ARGB
+struct bitmap_format
+{
+    uint32 RedMask;
+    uint32 GreenMask;
+    uint32 BlueMask;
+    uint32 AlphaMask;
+    
+    uint32 RedShift;
+    uint32 GreenShift;
+    uint32 BlueShift;
+    uint32 AlphaShift;
+};
+
 #endif
\ No newline at end of file
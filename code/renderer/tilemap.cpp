@@ -0,0 +1,320 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Tilemap layer for large static backgrounds. Instead of pushing a quad per
+  tile each frame, every visible chunk's tiles are pre-rendered into a cached
+  chunk texture that is drawn with a single axis-aligned blit.
+
+  Cached chunk textures live in a pool kept in LRU order. The pool holds
+  every chunk that can be visible on the largest target the tilemap is
+  initialized for, plus a ring of chunks around it s.t. scrolling builds the
+  chunks coming into view without evicting ones still on screen. Whenever a
+  visible chunk has no cache of its current Version (it's new or its tiles
+  changed) the least recently used cache entry that isn't in use this frame
+  is rebuilt on the low priority work queue. Until that job is done the
+  previous (stale) version of the chunk, if any, keeps being drawn.
+
+  All cache book-keeping happens on the main thread; background jobs only
+  write the chunk texture and then flag it as READY.
+
+*/
+
+inline uint32 GetTilemapChunkHash(int32 chunkX, int32 chunkY)
+{
+    // NOTE(Joey): multiply-xorshift mix; neighbouring chunks spread over the whole table
+    uint32 hash = (uint32)chunkX*0x8DA6B343u ^ (uint32)chunkY*0xD8163841u;
+    hash ^= hash >> 16;
+    hash *= 0x7FEB352Du;
+    hash ^= hash >> 15;
+    return hash & (TILEMAP_CHUNK_HASH_SIZE - 1);
+}
+
+// NOTE(Joey): chunks a span of pixels can overlap at any (sub-pixel) offset
+inline uint32 GetMaxVisibleChunks(uint32 pixels, uint32 chunkPixelSize)
+{
+    return (pixels + chunkPixelSize - 1) / chunkPixelSize + 1;
+}
+
+// NOTE(Joey): maxTargetWidth/Height is the largest target the tilemap is ever pushed to; the chunk cache is sized on it
+internal void InitTilemap(tilemap *map, memory_arena *arena, uint32 tilePixelSize, uint32 maxTargetWidth, uint32 maxTargetHeight)
+{
+    map->TilePixelSize = tilePixelSize;
+    map->ChunkCount = 0;
+    map->FrameIndex = 0;
+    for(uint32 i = 0; i < TILEMAP_CHUNK_HASH_SIZE; ++i)
+    {
+        map->ChunkHash[i] = 0;
+        map->CacheHash[i] = 0;
+    }
+
+    cached_chunk *sentinel = &map->CacheSentinel;
+    sentinel->Next = sentinel;
+    sentinel->Prev = sentinel;
+
+    uint16 chunkPixelSize = (uint16)(tilePixelSize*TILEMAP_TILES_PER_CHUNK);
+    uint32 visibleX = GetMaxVisibleChunks(maxTargetWidth, chunkPixelSize);
+    uint32 visibleY = GetMaxVisibleChunks(maxTargetHeight, chunkPixelSize);
+    map->CacheCount = (visibleX + 2)*(visibleY + 2);
+    map->Cache = PushArray(arena, map->CacheCount, cached_chunk);
+    map->BuildChunks = PushArray(arena, map->CacheCount, tilemap_chunk*);
+    for(uint32 i = 0; i < map->CacheCount; ++i)
+    {
+        cached_chunk *cache = map->Cache + i;
+        cache->State = CHUNK_CACHE_EMPTY;
+        cache->LastUsedFrame = 0;
+        cache->NextInHash = 0;
+        cache->Hashed = false;
+        cache->ChunkTexture = CreateEmptyTexture(arena, chunkPixelSize, chunkPixelSize);
+
+        cache->Next = sentinel->Next;
+        cache->Prev = sentinel;
+        cache->Next->Prev = cache;
+        cache->Prev->Next = cache;
+    }
+}
+
+inline tilemap_chunk *GetTilemapChunk(tilemap *map, int32 chunkX, int32 chunkY, memory_arena *arena = 0)
+{
+    tilemap_chunk **slot = map->ChunkHash + GetTilemapChunkHash(chunkX, chunkY);
+    for(tilemap_chunk *chunk = *slot; chunk; chunk = chunk->NextInHash)
+    {
+        if(chunk->ChunkX == chunkX && chunk->ChunkY == chunkY)
+            return chunk;
+    }
+
+    // NOTE(Joey): only create chunk if an arena is given
+    tilemap_chunk *chunk = 0;
+    if(arena)
+    {
+        chunk = PushStruct(arena, tilemap_chunk);
+        chunk->ChunkX = chunkX;
+        chunk->ChunkY = chunkY;
+        chunk->Version = 0;
+        for(uint32 i = 0; i < ArrayCount(chunk->Tiles); ++i)
+            chunk->Tiles[i] = 0;
+        chunk->NextInHash = *slot;
+        *slot = chunk;
+        ++map->ChunkCount;
+    }
+    return chunk;
+}
+
+internal void SetTile(tilemap *map, memory_arena *arena, int32 tileX, int32 tileY, uint8 tile)
+{
+    // NOTE(Joey): arithmetic shift/mask gives floored chunk coordinates for negative tiles as well
+    tilemap_chunk *chunk = GetTilemapChunk(map, tileX >> TILEMAP_CHUNK_SHIFT, tileY >> TILEMAP_CHUNK_SHIFT, arena);
+    uint8 *dest = chunk->Tiles + (tileY & (TILEMAP_TILES_PER_CHUNK - 1))*TILEMAP_TILES_PER_CHUNK + (tileX & (TILEMAP_TILES_PER_CHUNK - 1));
+    if(*dest != tile)
+    {
+        *dest = tile;
+        ++chunk->Version;
+    }
+}
+
+internal uint8 GetTile(tilemap *map, int32 tileX, int32 tileY)
+{
+    tilemap_chunk *chunk = GetTilemapChunk(map, tileX >> TILEMAP_CHUNK_SHIFT, tileY >> TILEMAP_CHUNK_SHIFT);
+    if(!chunk)
+        return 0;
+    return chunk->Tiles[(tileY & (TILEMAP_TILES_PER_CHUNK - 1))*TILEMAP_TILES_PER_CHUNK + (tileX & (TILEMAP_TILES_PER_CHUNK - 1))];
+}
+
+void DoBuildChunkWork(platform_work_queue *queue, void *data)
+{
+    cached_chunk *cache = (cached_chunk*)data;
+    Texture *dest = &cache->ChunkTexture;
+    Texture *tileset = cache->Tileset;
+    uint32 tileSize = cache->TilePixelSize;
+    uint32 tilesetColumns = tileSize ? tileset->Width / tileSize : 0;
+    uint32 tilesetCells = tileSize ? tilesetColumns*(tileset->Height / tileSize) : 0;
+
+    for(int32 tileY = 0; tileY < TILEMAP_TILES_PER_CHUNK; ++tileY)
+    {
+        for(int32 tileX = 0; tileX < TILEMAP_TILES_PER_CHUNK; ++tileX)
+        {
+            uint8 tile = cache->Tiles[tileY*TILEMAP_TILES_PER_CHUNK + tileX];
+            uint8 *destRow = (uint8*)dest->Texels + tileY*tileSize*dest->Pitch + tileX*tileSize*sizeof(uint32);
+            if(tile == 0 || tile > tilesetCells)
+            {   // NOTE(Joey): empty tiles are fully transparent; so are tiles the tileset has no cell for
+                for(uint32 y = 0; y < tileSize; ++y, destRow += dest->Pitch)
+                    ZeroSize(destRow, tileSize*sizeof(uint32));
+            }
+            else
+            {
+                uint32 cellX = ((tile - 1) % tilesetColumns)*tileSize;
+                uint32 cellY = ((tile - 1) / tilesetColumns)*tileSize;
+                uint8 *sourceRow = (uint8*)tileset->Texels + cellY*tileset->Pitch + cellX*sizeof(uint32);
+                for(uint32 y = 0; y < tileSize; ++y, destRow += dest->Pitch, sourceRow += tileset->Pitch)
+                {
+                    uint32 *destTexel = (uint32*)destRow;
+                    uint32 *sourceTexel = (uint32*)sourceRow;
+                    for(uint32 x = 0; x < tileSize; ++x)
+                        *destTexel++ = *sourceTexel++;
+                }
+            }
+        }
+    }
+
+    // NOTE(Joey): make sure all texels are written before the main thread sees the chunk as ready
+    _WriteBarrier();
+    _InterlockedExchange((volatile long*)&cache->State, CHUNK_CACHE_READY);
+}
+
+inline void TouchCachedChunk(tilemap *map, cached_chunk *cache)
+{
+    // NOTE(Joey): move to the front of the LRU list
+    cache->Prev->Next = cache->Next;
+    cache->Next->Prev = cache->Prev;
+
+    cached_chunk *sentinel = &map->CacheSentinel;
+    cache->Next = sentinel->Next;
+    cache->Prev = sentinel;
+    cache->Next->Prev = cache;
+    cache->Prev->Next = cache;
+
+    cache->LastUsedFrame = map->FrameIndex;
+}
+
+// NOTE(Joey): moves the cache entry to the hash bucket of the chunk it's (re)assigned to
+internal void RehashCachedChunk(tilemap *map, cached_chunk *cache, int32 chunkX, int32 chunkY)
+{
+    if(cache->Hashed)
+    {
+        cached_chunk **link = map->CacheHash + GetTilemapChunkHash(cache->ChunkX, cache->ChunkY);
+        while(*link != cache)
+            link = &(*link)->NextInHash;
+        *link = cache->NextInHash;
+    }
+    cache->ChunkX = chunkX;
+    cache->ChunkY = chunkY;
+
+    cached_chunk **slot = map->CacheHash + GetTilemapChunkHash(chunkX, chunkY);
+    cache->NextInHash = *slot;
+    *slot = cache;
+    cache->Hashed = true;
+}
+
+internal cached_chunk *AcquireCachedChunk(tilemap *map)
+{
+    // NOTE(Joey): walk from the least recently used entry; skip entries still being built or
+    // drawn this frame (their texture is read by this frame's RenderPass).
+    cached_chunk *sentinel = &map->CacheSentinel;
+    for(cached_chunk *cache = sentinel->Prev; cache != sentinel; cache = cache->Prev)
+    {
+        if(cache->State != CHUNK_CACHE_BUILDING && cache->LastUsedFrame != map->FrameIndex)
+            return cache;
+    }
+    return 0;
+}
+
+// NOTE(Joey): screenOrigin is the pixel position of tile (0, 0)'s bottom-left corner
+internal void PushTilemap(RenderQueue *queue,
+                          tilemap *map,
+                          Texture *tileset,
+                          vector2D screenOrigin,
+                          Texture *target,
+                          uint32 depth)
+{
+    TIMING_BLOCK();
+    ++map->FrameIndex;
+
+    real32 chunkPixelSize = (real32)(map->TilePixelSize*TILEMAP_TILES_PER_CHUNK);
+    int32 minChunkX = FloorReal32ToInt32(-screenOrigin.x / chunkPixelSize);
+    int32 minChunkY = FloorReal32ToInt32(-screenOrigin.y / chunkPixelSize);
+    int32 maxChunkX = FloorReal32ToInt32(((real32)target->Width - screenOrigin.x) / chunkPixelSize);
+    int32 maxChunkY = FloorReal32ToInt32(((real32)target->Height - screenOrigin.y) / chunkPixelSize);
+
+    // NOTE(Joey): the visible chunks are drawn; the ring of chunks around them is only built ahead of
+    // time s.t. chunks scrolling into view are ready once they show up. Builds of visible chunks are
+    // listed from the front of BuildChunks and the ring's from the back s.t. visible ones go first.
+    Assert((uint32)(maxChunkX - minChunkX + 3)*(uint32)(maxChunkY - minChunkY + 3) <= map->CacheCount);
+    tilemap_chunk **buildChunks = map->BuildChunks;
+    uint32 buildCount = 0;
+    uint32 prefetchStart = map->CacheCount;
+    for(int32 chunkY = minChunkY - 1; chunkY <= maxChunkY + 1; ++chunkY)
+    {
+        for(int32 chunkX = minChunkX - 1; chunkX <= maxChunkX + 1; ++chunkX)
+        {
+            tilemap_chunk *chunk = GetTilemapChunk(map, chunkX, chunkY);
+            if(!chunk)
+                continue;
+            bool32 visible = chunkX >= minChunkX && chunkX <= maxChunkX && chunkY >= minChunkY && chunkY <= maxChunkY;
+
+            // NOTE(Joey): find a cache of the current version and/or a stale one to draw meanwhile
+            cached_chunk *current = 0;
+            cached_chunk *stale = 0;
+            for(cached_chunk *cache = map->CacheHash[GetTilemapChunkHash(chunkX, chunkY)]; cache; cache = cache->NextInHash)
+            {
+                if(cache->State == CHUNK_CACHE_EMPTY || cache->ChunkX != chunkX || cache->ChunkY != chunkY)
+                    continue;
+                if(cache->Version == chunk->Version)
+                    current = cache;
+                else if(cache->State == CHUNK_CACHE_READY)
+                    stale = cache;
+            }
+
+            cached_chunk *draw = stale;
+            if(current)
+            {
+                TouchCachedChunk(map, current);
+                if(current->State == CHUNK_CACHE_READY)
+                {
+                    draw = current;
+                    if(stale)
+                        stale->State = CHUNK_CACHE_EMPTY;
+                }
+            }
+            else if(buildCount < prefetchStart)
+            {
+                if(visible)
+                    buildChunks[buildCount++] = chunk;
+                else
+                    buildChunks[--prefetchStart] = chunk;
+            }
+
+            if(draw && visible)
+            {
+                TouchCachedChunk(map, draw);
+                vector2D position = { screenOrigin.x + chunkX*chunkPixelSize, screenOrigin.y + chunkY*chunkPixelSize };
+                PushBlit(queue, &draw->ChunkTexture, position, depth);
+            }
+        }
+    }
+    // NOTE(Joey): move the ring's builds right behind the visible ones
+    for(uint32 i = prefetchStart; i < map->CacheCount; ++i)
+        buildChunks[buildCount++] = buildChunks[i];
+
+    // NOTE(Joey): (re)build missing chunks in the background once all caches in use are marked as such
+    if(tileset && tileset->Texels)
+    {
+        for(uint32 i = 0; i < buildCount; ++i)
+        {
+            cached_chunk *cache = AcquireCachedChunk(map);
+            if(!cache)
+                break;
+
+            tilemap_chunk *chunk = buildChunks[i];
+            RehashCachedChunk(map, cache, chunk->ChunkX, chunk->ChunkY);
+            cache->Version       = chunk->Version;
+            cache->Tileset       = tileset;
+            cache->TilePixelSize = map->TilePixelSize;
+            for(uint32 t = 0; t < ArrayCount(cache->Tiles); ++t)
+                cache->Tiles[t] = chunk->Tiles[t];
+            cache->State = CHUNK_CACHE_BUILDING;
+            TouchCachedChunk(map, cache);
+
+            PlatformAPI.AddWorkEntry(PlatformAPI.WorkQueueLowPriority, DoBuildChunkWork, cache);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+// NOTE(Joey): same chunk dimensions as the (currently unused) world chunks in map.h
+const int32  TILEMAP_CHUNK_SHIFT     = 4;
+const int32  TILEMAP_TILES_PER_CHUNK = 1 << TILEMAP_CHUNK_SHIFT;
+const uint32 TILEMAP_CHUNK_HASH_SIZE = 256;
+
+// NOTE(Joey): tile data of a single chunk; tile 0 is empty, tile n maps to tileset cell n - 1 (tiles
+// past the tileset's last cell are drawn empty as well)
+struct tilemap_chunk
+{
+    int32  ChunkX, ChunkY;
+    uint32 Version; // NOTE(Joey): incremented on every tile change; caches compare against this
+    uint8  Tiles[TILEMAP_TILES_PER_CHUNK*TILEMAP_TILES_PER_CHUNK];
+
+    tilemap_chunk *NextInHash;
+};
+
+enum chunk_cache_state
+{
+    CHUNK_CACHE_EMPTY,
+    CHUNK_CACHE_BUILDING,
+    CHUNK_CACHE_READY,
+};
+
+// NOTE(Joey): a pre-rendered chunk texture; kept in a doubly linked list in LRU order
+struct cached_chunk
+{
+    int32  ChunkX, ChunkY;
+    uint32 Version;
+    volatile uint32 State; // chunk_cache_state; set to READY by the background job
+
+    Texture  ChunkTexture;
+    Texture *Tileset;
+    uint8    Tiles[TILEMAP_TILES_PER_CHUNK*TILEMAP_TILES_PER_CHUNK]; // NOTE(Joey): snapshot used while building
+    uint32   TilePixelSize;
+    uint32   LastUsedFrame;
+
+    cached_chunk *Prev;
+    cached_chunk *Next;
+    cached_chunk *NextInHash; // NOTE(Joey): in CacheHash under ChunkX, ChunkY once Hashed
+    bool32        Hashed;
+};
+
+struct tilemap
+{
+    uint32 TilePixelSize; // NOTE(Joey): the layer is blitted 1:1; tiles are this many pixels on screen
+    uint32 ChunkCount;
+    uint32 FrameIndex;
+
+    tilemap_chunk *ChunkHash[TILEMAP_CHUNK_HASH_SIZE];
+
+    cached_chunk   CacheSentinel; // NOTE(Joey): Next is most recently used, Prev least recently used
+    cached_chunk  *Cache;
+    cached_chunk  *CacheHash[TILEMAP_CHUNK_HASH_SIZE];
+    uint32         CacheCount;    // NOTE(Joey): sized at init from the largest target; see InitTilemap
+    tilemap_chunk **BuildChunks;  // NOTE(Joey): PushTilemap's scratch list of chunks to (re)build; CacheCount entries
+};
+
+#endif
@@ -0,0 +1,583 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Virtual texturing for images too large to keep resident (star-field and
+  map backdrops). Instead of reading the entire .BMP into memory, texels are
+  streamed from file in 128x128 pages into a fixed pool of physical pages,
+  so memory use depends on the pool's budget, not on the size of the image.
+
+  Pages of mip levels > 0 are box filtered from the full resolution rows
+  while streaming them in; nothing but the original .BMP lives on disk.
+
+  Each frame goes as follows:
+
+  1. UpdateVirtualTextures (main thread) maps the pages of finished loads,
+     then walks the feedback of the last RenderPass: resident pages that
+     were sampled are moved to the front of the LRU list, missing ones are
+     queued on the low priority work queue (coarser mips first) as long as
+     there are free load slots and pages not sampled last frame to evict.
+  2. RenderVirtualTexture_ (render workers) samples each page it covers if
+     resident, otherwise the first resident page of a coarser mip; the last
+     mip is always resident. Every page it wanted or used is flagged as
+     Requested, which is the feedback for the next update.
+
+  Page tables are only changed in UpdateVirtualTextures, while no RenderPass
+  is in flight; background loads only write their page's texels.
+
+*/
+
+inline virtual_page_entry *GetVirtualPageEntry(virtual_texture *texture, uint32 mip, uint32 pageX, uint32 pageY)
+{
+    virtual_texture_mip *level = texture->Mips + mip;
+    Assert(pageX < level->PageCountX && pageY < level->PageCountY);
+    return level->Entries + pageY*level->PageCountX + pageX;
+}
+
+internal void InitVirtualTextureCache(virtual_texture_cache *cache, memory_arena *arena, memory_index budget)
+{
+    cache->FrameIndex = 0;
+    cache->TextureCount = 0;
+    cache->RequestCount = 0;
+    cache->LoadCount = 0;
+
+    memory_index pageSize = VIRTUAL_PAGE_TEXEL_SIZE*VIRTUAL_PAGE_TEXEL_SIZE*sizeof(uint32);
+    cache->PageCount = (uint32)Minimum(budget / pageSize, (memory_index)VIRTUAL_PAGE_NONE);
+    cache->Pages = PushArray(arena, cache->PageCount, virtual_page);
+
+    virtual_page *sentinel = &cache->Sentinel;
+    sentinel->Next = sentinel;
+    sentinel->Prev = sentinel;
+    for(uint32 i = 0; i < cache->PageCount; ++i)
+    {
+        virtual_page *page = cache->Pages + i;
+        page->Texels = CreateEmptyTexture(arena, VIRTUAL_PAGE_TEXEL_SIZE, VIRTUAL_PAGE_TEXEL_SIZE);
+        page->State = VIRTUAL_PAGE_EMPTY;
+        page->LastUsedFrame = 0;
+        page->Owner = 0;
+
+        page->Next = sentinel->Next;
+        page->Prev = sentinel;
+        page->Next->Prev = page;
+        page->Prev->Next = page;
+    }
+
+    for(uint32 i = 0; i < VIRTUAL_TEXTURE_MAX_LOADS; ++i)
+    {
+        virtual_page_load *load = cache->Loads + i;
+        load->State   = VIRTUAL_PAGE_LOAD_FREE;
+        load->Page    = 0;
+        load->Staging = PushArray(arena, VIRTUAL_PAGE_STAGING_TEXELS, uint32);
+        load->Sums    = PushArray(arena, 4*VIRTUAL_PAGE_TEXEL_SIZE, uint32);
+    }
+}
+
+/* NOTE(Joey):
+
+  Streams page (pageX, pageY) of the given mip level from file into dest. A
+  mip texel is the average of the (up to) 2^mip x 2^mip full resolution
+  texels it covers; these are read one full resolution row at a time in
+  chunks of at most VIRTUAL_PAGE_STAGING_TEXELS texels and accumulated per
+  page column. Columns and rows past the mip's edge, including the page's
+  border, repeat the mip's last texel (clamp addressing).
+
+*/
+internal void LoadVirtualPage(virtual_texture *texture,
+                              uint32 mip,
+                              uint32 pageX,
+                              uint32 pageY,
+                              Texture *dest,
+                              uint32 *staging,
+                              uint32 *sums)
+{
+    virtual_texture_mip *level = texture->Mips + mip;
+    uint32 mipMinX = pageX << VIRTUAL_PAGE_SIZE_SHIFT;
+    uint32 mipMinY = pageY << VIRTUAL_PAGE_SIZE_SHIFT;
+    uint32 columnCount = Minimum(VIRTUAL_PAGE_TEXEL_SIZE, level->Width - mipMinX);
+    uint32 rowCount = Minimum(VIRTUAL_PAGE_TEXEL_SIZE, level->Height - mipMinY);
+    uint32 sourceMinX = mipMinX << mip;
+    uint32 sourceMaxX = Minimum((mipMinX + columnCount) << mip, texture->Width);
+
+    uint8 *destRow = (uint8*)dest->Texels;
+    for(uint32 row = 0; row < rowCount; ++row, destRow += dest->Pitch)
+    {
+        uint32 sourceMinY = (mipMinY + row) << mip;
+        uint32 sourceMaxY = Minimum(sourceMinY + (1 << mip), texture->Height);
+        ZeroSize(sums, 4*columnCount*sizeof(uint32));
+        for(uint32 sourceY = sourceMinY; sourceY < sourceMaxY; ++sourceY)
+        {
+            for(uint32 sourceX = sourceMinX; sourceX < sourceMaxX; sourceX += VIRTUAL_PAGE_STAGING_TEXELS)
+            {
+                uint32 count = Minimum(VIRTUAL_PAGE_STAGING_TEXELS, sourceMaxX - sourceX);
+                u64 offset = texture->TexelOffset + ((u64)sourceY*texture->Width + sourceX)*sizeof(uint32);
+                PlatformAPI.ReadFile(texture->File, offset, count*sizeof(uint32), staging);
+                for(uint32 i = 0; i < count; ++i)
+                {
+                    uint32 texel = ConvertBitmapTexel(&texture->Format, staging[i]);
+                    uint32 *sum = sums + 4*(((sourceX + i) >> mip) - mipMinX);
+                    sum[0] += (texel >>  0) & 0xFF;
+                    sum[1] += (texel >>  8) & 0xFF;
+                    sum[2] += (texel >> 16) & 0xFF;
+                    sum[3] += (texel >> 24) & 0xFF;
+                }
+            }
+        }
+
+        uint32 *destTexel = (uint32*)destRow;
+        uint32 boxHeight = sourceMaxY - sourceMinY;
+        for(uint32 column = 0; column < columnCount; ++column)
+        {
+            uint32 boxMinX = (mipMinX + column) << mip;
+            uint32 boxWidth = Minimum(boxMinX + (1 << mip), texture->Width) - boxMinX;
+            uint32 count = boxWidth*boxHeight;
+            uint32 *sum = sums + 4*column;
+            destTexel[column] = (((sum[0] + count/2) / count) <<  0) |
+                                (((sum[1] + count/2) / count) <<  8) |
+                                (((sum[2] + count/2) / count) << 16) |
+                                (((sum[3] + count/2) / count) << 24);
+        }
+        for(uint32 column = columnCount; column < VIRTUAL_PAGE_TEXEL_SIZE; ++column)
+            destTexel[column] = destTexel[columnCount - 1];
+    }
+    uint8 *lastRow = (uint8*)dest->Texels + (rowCount - 1)*dest->Pitch;
+    for(uint32 row = rowCount; row < VIRTUAL_PAGE_TEXEL_SIZE; ++row, destRow += dest->Pitch)
+    {
+        uint32 *destTexel = (uint32*)destRow;
+        uint32 *sourceTexel = (uint32*)lastRow;
+        for(uint32 column = 0; column < VIRTUAL_PAGE_TEXEL_SIZE; ++column)
+            *destTexel++ = *sourceTexel++;
+    }
+}
+
+void DoLoadVirtualPageWork(platform_work_queue *queue, void *data)
+{
+    virtual_page_load *load = (virtual_page_load*)data;
+    virtual_page *page = load->Page;
+    LoadVirtualPage(page->Owner, page->Mip, page->PageX, page->PageY, &page->Texels, load->Staging, load->Sums);
+
+    // NOTE(Joey): make sure all texels are written before the main thread sees the load as done
+    _WriteBarrier();
+    _InterlockedExchange((volatile long*)&load->State, VIRTUAL_PAGE_LOAD_DONE);
+}
+
+// NOTE(Joey): opens a 32 bit .BMP as virtual texture; only its header and last mip are read right away
+internal virtual_texture *LoadVirtualTexture(virtual_texture_cache *cache, memory_arena *arena, char *fileName)
+{
+    if(cache->TextureCount == VIRTUAL_TEXTURE_MAX_TEXTURES)
+        return 0;
+
+    platform_file_handle *file = PlatformAPI.OpenFile(fileName);
+    if(!file)
+        return 0;
+
+    bitmap_header header;
+    PlatformAPI.ReadFile(file, 0, sizeof(bitmap_header), &header);
+    // NOTE(Joey): texel rows are only addressable in file if they're tightly packed 32 bit texels
+    if(file->HasErrors || header.FileType != 0x4D42 || header.BitsPerPixel != 32 ||
+       header.Width <= 0 || header.Height <= 0)
+    {
+        PlatformAPI.CloseFile(file);
+        return 0;
+    }
+
+    virtual_texture *texture = cache->Textures + cache->TextureCount;
+    texture->File        = file;
+    texture->TexelOffset = header.BitmapOffset;
+    texture->Format      = GetBitmapFormat(&header);
+    texture->Width       = header.Width;
+    texture->Height      = header.Height;
+    texture->Pages       = cache->Pages;
+
+    // NOTE(Joey): halve the texture until a mip fits in a single page
+    uint32 mipCount = 0;
+    for(;;)
+    {
+        virtual_texture_mip *level = texture->Mips + mipCount;
+        level->Width      = (texture->Width + (1 << mipCount) - 1) >> mipCount;
+        level->Height     = (texture->Height + (1 << mipCount) - 1) >> mipCount;
+        level->PageCountX = (level->Width + VIRTUAL_PAGE_SIZE - 1) >> VIRTUAL_PAGE_SIZE_SHIFT;
+        level->PageCountY = (level->Height + VIRTUAL_PAGE_SIZE - 1) >> VIRTUAL_PAGE_SIZE_SHIFT;
+        level->Entries    = 0;
+        ++mipCount;
+        if(level->PageCountX == 1 && level->PageCountY == 1)
+            break;
+        Assert(mipCount < VIRTUAL_TEXTURE_MAX_MIPS);
+    }
+    texture->MipCount = mipCount;
+
+    // NOTE(Joey): the last mip is the always resident fallback and doesn't need a page table
+    for(uint32 mip = 0; mip < mipCount - 1; ++mip)
+    {
+        virtual_texture_mip *level = texture->Mips + mip;
+        uint32 entryCount = level->PageCountX*level->PageCountY;
+        level->Entries = PushArray(arena, entryCount, virtual_page_entry);
+        for(uint32 i = 0; i < entryCount; ++i)
+        {
+            level->Entries[i].PhysicalPage = VIRTUAL_PAGE_NONE;
+            level->Entries[i].Requested    = false;
+            level->Entries[i].Pending      = false;
+        }
+    }
+
+    // NOTE(Joey): the fallback streams in the entire image once; this is done right away, on the
+    // calling thread, with scratch memory that is released afterwards.
+    texture->Fallback = CreateEmptyTexture(arena, VIRTUAL_PAGE_TEXEL_SIZE, VIRTUAL_PAGE_TEXEL_SIZE);
+    temp_memory scratchMemory = BeginTempMemory(arena);
+    uint32 *staging = PushArray(arena, VIRTUAL_PAGE_STAGING_TEXELS, uint32);
+    uint32 *sums = PushArray(arena, 4*VIRTUAL_PAGE_TEXEL_SIZE, uint32);
+    LoadVirtualPage(texture, mipCount - 1, 0, 0, &texture->Fallback, staging, sums);
+    EndTempMemory(scratchMemory);
+
+    ++cache->TextureCount;
+    return texture;
+}
+
+inline void TouchVirtualPage(virtual_texture_cache *cache, virtual_page *page)
+{
+    // NOTE(Joey): move to the front of the LRU list
+    page->Prev->Next = page->Next;
+    page->Next->Prev = page->Prev;
+
+    virtual_page *sentinel = &cache->Sentinel;
+    page->Next = sentinel->Next;
+    page->Prev = sentinel;
+    page->Next->Prev = page;
+    page->Prev->Next = page;
+
+    page->LastUsedFrame = cache->FrameIndex;
+}
+
+internal virtual_page *AcquireVirtualPage(virtual_texture_cache *cache)
+{
+    // NOTE(Joey): walk from the least recently used page; skip pages being loaded or sampled last frame
+    virtual_page *sentinel = &cache->Sentinel;
+    for(virtual_page *page = sentinel->Prev; page != sentinel; page = page->Prev)
+    {
+        if(page->State != VIRTUAL_PAGE_LOADING && page->LastUsedFrame != cache->FrameIndex)
+            return page;
+    }
+    return 0;
+}
+
+// NOTE(Joey): call once per frame on the main thread, before pushing any virtual textures
+internal void UpdateVirtualTextures(virtual_texture_cache *cache)
+{
+    TIMING_BLOCK();
+    ++cache->FrameIndex;
+
+    // NOTE(Joey): map the pages of finished loads
+    for(uint32 i = 0; i < VIRTUAL_TEXTURE_MAX_LOADS; ++i)
+    {
+        virtual_page_load *load = cache->Loads + i;
+        if(load->State == VIRTUAL_PAGE_LOAD_DONE)
+        {
+            virtual_page *page = load->Page;
+            virtual_page_entry *entry = GetVirtualPageEntry(page->Owner, page->Mip, page->PageX, page->PageY);
+            entry->PhysicalPage = (uint16)(page - cache->Pages);
+            entry->Pending = false;
+            page->State = VIRTUAL_PAGE_READY;
+
+            load->Page = 0;
+            load->State = VIRTUAL_PAGE_LOAD_FREE;
+        }
+    }
+
+    // NOTE(Joey): walk the last RenderPass's feedback; coarser mips go first as they're the fallback
+    // of the finer ones.
+    virtual_page_request requests[VIRTUAL_TEXTURE_MAX_REQUESTS];
+    uint32 requestCount = 0;
+    for(uint32 textureIndex = 0; textureIndex < cache->TextureCount; ++textureIndex)
+    {
+        virtual_texture *texture = cache->Textures + textureIndex;
+        for(int32 mip = texture->MipCount - 2; mip >= 0; --mip)
+        {
+            virtual_texture_mip *level = texture->Mips + mip;
+            virtual_page_entry *entry = level->Entries;
+            for(uint32 pageY = 0; pageY < level->PageCountY; ++pageY)
+            {
+                for(uint32 pageX = 0; pageX < level->PageCountX; ++pageX, ++entry)
+                {
+                    if(!entry->Requested)
+                        continue;
+                    entry->Requested = false;
+
+                    if(entry->PhysicalPage != VIRTUAL_PAGE_NONE)
+                    {
+                        TouchVirtualPage(cache, cache->Pages + entry->PhysicalPage);
+                    }
+                    else if(!entry->Pending && requestCount < VIRTUAL_TEXTURE_MAX_REQUESTS)
+                    {
+                        virtual_page_request *request = requests + requestCount++;
+                        request->Texture = texture;
+                        request->Mip     = mip;
+                        request->PageX   = pageX;
+                        request->PageY   = pageY;
+                    }
+                }
+            }
+        }
+    }
+    cache->RequestCount = requestCount;
+
+    // NOTE(Joey): start loading missing pages while there are free load slots and evictable pages;
+    // requests that don't make it are flagged again by the next RenderPass.
+    uint32 loadCount = 0;
+    uint32 loadIndex = 0;
+    for(uint32 i = 0; i < requestCount; ++i)
+    {
+        while(loadIndex < VIRTUAL_TEXTURE_MAX_LOADS && cache->Loads[loadIndex].State != VIRTUAL_PAGE_LOAD_FREE)
+            ++loadIndex;
+        if(loadIndex == VIRTUAL_TEXTURE_MAX_LOADS)
+            break;
+
+        virtual_page *page = AcquireVirtualPage(cache);
+        if(!page)
+            break;
+        if(page->State == VIRTUAL_PAGE_READY)
+        {   // NOTE(Joey): evict
+            GetVirtualPageEntry(page->Owner, page->Mip, page->PageX, page->PageY)->PhysicalPage = VIRTUAL_PAGE_NONE;
+        }
+
+        virtual_page_request *request = requests + i;
+        page->Owner = request->Texture;
+        page->Mip   = request->Mip;
+        page->PageX = request->PageX;
+        page->PageY = request->PageY;
+        page->State = VIRTUAL_PAGE_LOADING;
+        TouchVirtualPage(cache, page);
+        GetVirtualPageEntry(request->Texture, request->Mip, request->PageX, request->PageY)->Pending = true;
+
+        virtual_page_load *load = cache->Loads + loadIndex;
+        load->Page  = page;
+        load->State = VIRTUAL_PAGE_LOAD_BUSY;
+        PlatformAPI.AddWorkEntry(PlatformAPI.WorkQueueLowPriority, DoLoadVirtualPageWork, load);
+        ++loadCount;
+    }
+    cache->LoadCount = loadCount;
+}
+
+/* NOTE(Joey):
+
+  Draws an axis-aligned virtual texture; position is the quad's center. The
+  mip is chosen once per draw: the finest one that has at most 2 texels per
+  pixel. Each row is walked in runs of pixels that fall within the same page
+  column; every run samples a single (resident) page with the same bilinear
+  footprint as RenderTexture_'s wrap/mirror addressing, where texel centers
+  lie at +0.5.
+
+*/
+internal void RenderVirtualTexture_(Texture *target,
+                                    virtual_texture *texture,
+                                    vector2D position,
+                                    vector2D size,
+                                    rectangle2Di clipRect,
+                                    vector4D color)
+{
+    TIMING_BLOCK();
+
+    if(size.x <= 0.0f || size.y <= 0.0f)
+        return;
+
+    vector2D origin = position - 0.5f*size;
+    rectangle2Di fillRect;
+    fillRect.MinX = CeilReal32ToInt32(origin.x);
+    fillRect.MinY = CeilReal32ToInt32(origin.y);
+    fillRect.MaxX = FloorReal32ToInt32(origin.x + size.x) + 1;
+    fillRect.MaxY = FloorReal32ToInt32(origin.y + size.y) + 1;
+    fillRect = Intersect(fillRect, clipRect);
+    if(!HasArea(fillRect))
+        return;
+
+    real32 texelsPerPixel = Maximum((real32)texture->Width / size.x, (real32)texture->Height / size.y);
+    uint32 mip = 0;
+    while(mip + 1 < texture->MipCount && texelsPerPixel > 2.0f)
+    {
+        texelsPerPixel *= 0.5f;
+        ++mip;
+    }
+    virtual_texture_mip *level = texture->Mips + mip;
+
+    __m128i startClipMask = _mm_set1_epi8(-1);
+    __m128i endClipMask = _mm_set1_epi8(-1);
+    __m128i startClipMasks[] =
+    {
+        _mm_slli_si128(startClipMask, 0*4),
+        _mm_slli_si128(startClipMask, 1*4),
+        _mm_slli_si128(startClipMask, 2*4),
+        _mm_slli_si128(startClipMask, 3*4),
+    };
+    __m128i endClipMasks[] =
+    {
+        _mm_srli_si128(endClipMask, 0*4),
+        _mm_srli_si128(endClipMask, 3*4),
+        _mm_srli_si128(endClipMask, 2*4),
+        _mm_srli_si128(endClipMask, 1*4),
+    };
+
+    #define Mi(a, i) ((uint32*)&(a))[i]
+    const __m128 zero = _mm_set1_ps(0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 pageSize = _mm_set1_ps((real32)VIRTUAL_PAGE_SIZE);
+    const __m128i pageSizeM1_4x = _mm_set1_epi32(VIRTUAL_PAGE_SIZE - 1);
+    const __m128i maskFF = _mm_set1_epi32(0xFF);
+    const __m128i fullMask = _mm_set1_epi8(-1);
+    const __m128 inv255_4x = _mm_set1_ps(1.0f / 255.0f);
+    const __m128 maxColorValue = _mm_set1_ps(255.0f);
+    const __m128 colorr_4x = _mm_set1_ps(color.r);
+    const __m128 colorg_4x = _mm_set1_ps(color.g);
+    const __m128 colorb_4x = _mm_set1_ps(color.b);
+    const __m128 colora_4x = _mm_set1_ps(color.a);
+
+    uint32 destPitch = target->Width*sizeof(uint32);
+    uint8 *destRow = (uint8*)target->Texels + fillRect.MinY*destPitch;
+    for(int32 y = fillRect.MinY; y < fillRect.MaxY; ++y, destRow += destPitch)
+    {
+        real32 v = ((real32)y - origin.y) / size.y;
+        real32 mipY = Clamp(0.0f, (real32)level->Height - 1.0f, v*level->Height - 0.5f);
+        uint32 pageY = (uint32)mipY >> VIRTUAL_PAGE_SIZE_SHIFT;
+
+        real32 mipMinX = Clamp(0.0f, (real32)level->Width - 1.0f, ((real32)fillRect.MinX - origin.x)*level->Width/size.x - 0.5f);
+        int32 runMinX = fillRect.MinX;
+        for(uint32 pageX = (uint32)mipMinX >> VIRTUAL_PAGE_SIZE_SHIFT; runMinX < fillRect.MaxX; ++pageX)
+        {
+            // NOTE(Joey): pixels up to runMaxX have their mip texel coordinate before the next page column
+            int32 runMaxX = fillRect.MaxX;
+            if(pageX + 1 < level->PageCountX)
+            {
+                real32 pageEnd = (real32)((pageX + 1) << VIRTUAL_PAGE_SIZE_SHIFT) + 0.5f;
+                runMaxX = Minimum(runMaxX, CeilReal32ToInt32(origin.x + pageEnd*size.x/level->Width));
+            }
+            if(runMaxX <= runMinX)
+                continue;
+
+            // NOTE(Joey): sample the requested page if resident, otherwise that of the first coarser mip
+            // that is; flag both for the next UpdateVirtualTextures.
+            Texture *source = &texture->Fallback;
+            uint32 sourceMip = texture->MipCount - 1;
+            uint32 sourcePageX = 0;
+            uint32 sourcePageY = 0;
+            for(uint32 m = mip; m + 1 < texture->MipCount; ++m)
+            {
+                virtual_page_entry *entry = GetVirtualPageEntry(texture, m, pageX >> (m - mip), pageY >> (m - mip));
+                bool32 resident = entry->PhysicalPage != VIRTUAL_PAGE_NONE;
+                if((m == mip || resident) && !entry->Requested)
+                    entry->Requested = true;
+                if(resident)
+                {
+                    source = &texture->Pages[entry->PhysicalPage].Texels;
+                    sourceMip = m;
+                    sourcePageX = pageX >> (m - mip);
+                    sourcePageY = pageY >> (m - mip);
+                    break;
+                }
+            }
+            virtual_texture_mip *sourceLevel = texture->Mips + sourceMip;
+
+            // NOTE(Joey): the page's row is fixed per run; clamp to the page as the coarser mip's
+            // coordinates of the run's first/last pixel can fall just outside of it.
+            real32 pageTexelY = Clamp(0.0f, (real32)sourceLevel->Height - 1.0f, v*sourceLevel->Height - 0.5f);
+            pageTexelY = Clamp(0.0f, (real32)VIRTUAL_PAGE_SIZE, pageTexelY - (real32)(sourcePageY << VIRTUAL_PAGE_SIZE_SHIFT));
+            uint32 fetchY = Minimum((uint32)pageTexelY, VIRTUAL_PAGE_SIZE - 1);
+            __m128 fY = _mm_set1_ps(pageTexelY - (real32)fetchY);
+            __m128 ifY = _mm_sub_ps(one, fY);
+            uint32 *row0 = (uint32*)((uint8*)source->Texels + fetchY*source->Pitch);
+            uint32 *row1 = (uint32*)((uint8*)row0 + source->Pitch);
+
+            real32 scaleX = (real32)sourceLevel->Width / size.x;
+            const __m128 scaleX_4x = _mm_set1_ps(scaleX);
+            const __m128 offsetX_4x = _mm_set1_ps(-origin.x*scaleX - 0.5f);
+            const __m128 maxMipX_4x = _mm_set1_ps((real32)sourceLevel->Width - 1.0f);
+            const __m128 pageMinX_4x = _mm_set1_ps((real32)(sourcePageX << VIRTUAL_PAGE_SIZE_SHIFT));
+
+            int32 alignedMinX = runMinX & ~3;
+            int32 alignedMaxX = (runMaxX + 3) & ~3;
+            __m128i runStartMask = startClipMasks[runMinX & 3];
+            __m128i runEndMask = (runMaxX & 3) ? endClipMasks[runMaxX & 3] : fullMask;
+            uint32 *dest = (uint32*)destRow + alignedMinX;
+            __m128 pixelPosX = _mm_set_ps((real32)(alignedMinX + 3),
+                                          (real32)(alignedMinX + 2),
+                                          (real32)(alignedMinX + 1),
+                                          (real32)(alignedMinX + 0));
+            for(int32 x = alignedMinX; x < alignedMaxX; x += 4, dest += 4, pixelPosX = _mm_add_ps(pixelPosX, four))
+            {
+                __m128i writeMask = fullMask;
+                if(x == alignedMinX)
+                    writeMask = runStartMask;
+                if(x + 4 == alignedMaxX)
+                    writeMask = _mm_and_si128(writeMask, runEndMask);
+
+                __m128i originalDest = _mm_loadu_si128((__m128i *)dest);
+
+                // NOTE(Joey): mip texel coordinate, clamped to the mip, then relative to the page
+                __m128 tX = _mm_add_ps(_mm_mul_ps(pixelPosX, scaleX_4x), offsetX_4x);
+                tX = _mm_sub_ps(_mm_min_ps(_mm_max_ps(tX, zero), maxMipX_4x), pageMinX_4x);
+                tX = _mm_min_ps(_mm_max_ps(tX, zero), pageSize);
+                __m128i fetchX_4x = _mm_min_epi16(_mm_cvttps_epi32(tX), pageSizeM1_4x);
+                __m128 fX = _mm_sub_ps(tX, _mm_cvtepi32_ps(fetchX_4x));
+                __m128 ifX = _mm_sub_ps(one, fX);
+
+                __m128i sampleA = _mm_setr_epi32(row0[Mi(fetchX_4x, 0)], row0[Mi(fetchX_4x, 1)],
+                                                 row0[Mi(fetchX_4x, 2)], row0[Mi(fetchX_4x, 3)]);
+                __m128i sampleB = _mm_setr_epi32(row0[Mi(fetchX_4x, 0) + 1], row0[Mi(fetchX_4x, 1) + 1],
+                                                 row0[Mi(fetchX_4x, 2) + 1], row0[Mi(fetchX_4x, 3) + 1]);
+                __m128i sampleC = _mm_setr_epi32(row1[Mi(fetchX_4x, 0)], row1[Mi(fetchX_4x, 1)],
+                                                 row1[Mi(fetchX_4x, 2)], row1[Mi(fetchX_4x, 3)]);
+                __m128i sampleD = _mm_setr_epi32(row1[Mi(fetchX_4x, 0) + 1], row1[Mi(fetchX_4x, 1) + 1],
+                                                 row1[Mi(fetchX_4x, 2) + 1], row1[Mi(fetchX_4x, 3) + 1]);
+
+                __m128 l0 = _mm_mul_ps(ifY, ifX);
+                __m128 l1 = _mm_mul_ps(ifY, fX);
+                __m128 l2 = _mm_mul_ps(fY, ifX);
+                __m128 l3 = _mm_mul_ps(fY, fX);
+
+                // NOTE(Joey): bilinear blend per channel; shift selects the channel
+                #define VirtualBilinear(shift) \
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(l0, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(sampleA, shift), maskFF))),  \
+                                          _mm_mul_ps(l1, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(sampleB, shift), maskFF)))), \
+                               _mm_add_ps(_mm_mul_ps(l2, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(sampleC, shift), maskFF))),  \
+                                          _mm_mul_ps(l3, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(sampleD, shift), maskFF)))))
+                __m128 texelb = _mm_mul_ps(VirtualBilinear(0), colorb_4x);
+                __m128 texelg = _mm_mul_ps(VirtualBilinear(8), colorg_4x);
+                __m128 texelr = _mm_mul_ps(VirtualBilinear(16), colorr_4x);
+                __m128 texela = _mm_mul_ps(VirtualBilinear(24), colora_4x);
+                #undef VirtualBilinear
+
+                texelr = _mm_min_ps(_mm_max_ps(texelr, zero), maxColorValue);
+                texelg = _mm_min_ps(_mm_max_ps(texelg, zero), maxColorValue);
+                texelb = _mm_min_ps(_mm_max_ps(texelb, zero), maxColorValue);
+
+                // NOTE(Joey): destination/framebuffer blend
+                __m128 destb = _mm_cvtepi32_ps(_mm_and_si128(originalDest, maskFF));
+                __m128 destg = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 8), maskFF));
+                __m128 destr = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 16), maskFF));
+                __m128 desta = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(originalDest, 24), maskFF));
+
+                __m128 mulAlpha  = _mm_mul_ps(inv255_4x, texela);
+                __m128 invTexelA = _mm_sub_ps(one, mulAlpha);
+                __m128i intr = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(invTexelA, destr), _mm_mul_ps(mulAlpha, texelr)));
+                __m128i intg = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(invTexelA, destg), _mm_mul_ps(mulAlpha, texelg)));
+                __m128i intb = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(invTexelA, destb), _mm_mul_ps(mulAlpha, texelb)));
+                __m128i inta = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(invTexelA, desta), _mm_mul_ps(mulAlpha, texela)));
+                __m128i out = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(intr, 16), _mm_slli_epi32(intg, 8)),
+                                           _mm_or_si128(intb, _mm_slli_epi32(inta, 24)));
+
+                // NOTE(Joey): only write to memory where mask bits are set
+                __m128i maskedOut = _mm_or_si128(_mm_and_si128(writeMask, out),
+                                                 _mm_andnot_si128(writeMask, originalDest));
+                _mm_storeu_si128((__m128i *)dest, maskedOut);
+            }
+            runMinX = runMaxX;
+        }
+    }
+}
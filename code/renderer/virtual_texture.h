@@ -0,0 +1,135 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+#ifndef VIRTUAL_TEXTURE_H
+#define VIRTUAL_TEXTURE_H
+
+const uint32 VIRTUAL_PAGE_SIZE_SHIFT = 7;
+const uint32 VIRTUAL_PAGE_SIZE       = 1 << VIRTUAL_PAGE_SIZE_SHIFT;
+// NOTE(Joey): pages store one extra column/row of texels s.t. bilinear fetches never cross a page
+const uint32 VIRTUAL_PAGE_TEXEL_SIZE = VIRTUAL_PAGE_SIZE + 1;
+const uint16 VIRTUAL_PAGE_NONE       = 0xFFFF;
+
+const uint32 VIRTUAL_TEXTURE_MAX_MIPS     = 10; // NOTE(Joey): enough for 65535x65535 textures
+const uint32 VIRTUAL_TEXTURE_MAX_TEXTURES = 8;
+const uint32 VIRTUAL_TEXTURE_MAX_LOADS    = 8;  // NOTE(Joey): page loads in flight at any time
+const uint32 VIRTUAL_TEXTURE_MAX_REQUESTS = 64; // NOTE(Joey): missing pages considered per frame
+const uint32 VIRTUAL_PAGE_STAGING_TEXELS  = 4096;
+
+// NOTE(Joey): only written on the main thread, except for Requested which is set by the render workers
+struct virtual_page_entry
+{
+    uint16         PhysicalPage; // NOTE(Joey): index in the cache's page pool or VIRTUAL_PAGE_NONE
+    volatile uint8 Requested;    // NOTE(Joey): sampled (or wanted) by the last RenderPass
+    uint8          Pending;      // NOTE(Joey): a load of this page is in flight
+};
+
+struct virtual_texture_mip
+{
+    uint32 Width;
+    uint32 Height;
+    uint32 PageCountX;
+    uint32 PageCountY;
+    virtual_page_entry *Entries;
+};
+
+struct virtual_page;
+
+/* NOTE(Joey):
+
+  A texture too large to keep resident. Its .BMP stays open and texels are
+  streamed from it in pages of 128x128 texels of any of its mip levels. The
+  last mip level fits in a single page; it is loaded at registration and
+  always resident, so there's always something to fall back on.
+
+*/
+struct virtual_texture
+{
+    platform_file_handle *File;
+    uint32        TexelOffset; // NOTE(Joey): file offset of the bottom row's texels
+    bitmap_format Format;
+
+    uint32 Width;
+    uint32 Height;
+    uint32 MipCount;
+    virtual_texture_mip Mips[VIRTUAL_TEXTURE_MAX_MIPS];
+
+    Texture Fallback; // NOTE(Joey): mip MipCount - 1
+    virtual_page *Pages; // NOTE(Joey): page pool of the owning cache; indexed by PhysicalPage
+};
+
+enum virtual_page_state
+{
+    VIRTUAL_PAGE_EMPTY,
+    VIRTUAL_PAGE_LOADING,
+    VIRTUAL_PAGE_READY,
+};
+
+// NOTE(Joey): a physical page; kept in a doubly linked list in LRU order
+struct virtual_page
+{
+    Texture Texels;
+    uint32  State; // virtual_page_state
+    uint32  LastUsedFrame;
+
+    virtual_texture *Owner;
+    uint32 Mip;
+    uint32 PageX;
+    uint32 PageY;
+
+    virtual_page *Prev;
+    virtual_page *Next;
+};
+
+enum virtual_page_load_state
+{
+    VIRTUAL_PAGE_LOAD_FREE,
+    VIRTUAL_PAGE_LOAD_BUSY,
+    VIRTUAL_PAGE_LOAD_DONE,
+};
+
+// NOTE(Joey): work data of a background page load, with scratch memory s.t. loads don't allocate
+struct virtual_page_load
+{
+    volatile uint32 State; // virtual_page_load_state; set to DONE by the background job
+    virtual_page   *Page;
+
+    uint32 *Staging; // NOTE(Joey): VIRTUAL_PAGE_STAGING_TEXELS texels read from file
+    uint32 *Sums;    // NOTE(Joey): 4 channel sums per page column for box filtering mips
+};
+
+struct virtual_page_request
+{
+    virtual_texture *Texture;
+    uint32 Mip;
+    uint32 PageX;
+    uint32 PageY;
+};
+
+struct virtual_texture_cache
+{
+    uint32 FrameIndex;
+
+    uint32        PageCount;
+    virtual_page *Pages;
+    virtual_page  Sentinel; // NOTE(Joey): Next is most recently used
+
+    virtual_page_load Loads[VIRTUAL_TEXTURE_MAX_LOADS];
+
+    uint32          TextureCount;
+    virtual_texture Textures[VIRTUAL_TEXTURE_MAX_TEXTURES];
+
+    // NOTE(Joey): statistics of the last update
+    uint32 RequestCount;
+    uint32 LoadCount;
+};
+
+#endif
@@ -0,0 +1,585 @@
+/*******************************************************************
+** Copyright (C) 2015-2016 {Joey de Vries} {joey.d.vries@gmail.com}
+**
+** This code is part of Voidt.
+** https://github.com/JoeyDeVries/Voidt
+**
+** Voidt is free software: you can redistribute it and/or modify it
+** under the terms of the CC BY-NC 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+*******************************************************************/
+
+/* NOTE(Joey):
+
+  Offline asset packer: converts the game's source assets into a .vpak (see
+  vpak.h) that holds them in the engine's runtime layouts, s.t. loading an
+  asset at runtime is mapping the pack. Built by build.bat next to the game;
+  run it from the data directory as asset names are paths relative to it:
+
+    asset_packer <manifest> <output.vpak>
+
+  Each manifest line lists an asset as: type name [key=value ...]; # starts
+  a comment. For example:
+
+    texture space/enemy.bmp   format=block4x4
+    sound   audio/music.wav
+    font    fonts/consola.ttf source=C:/Windows/Fonts/consola.ttf bake=32 spread=4
+
+  source   reads the asset from another path than its name (all types)
+  format   argb32 | palette8 | block4x4 (textures; default argb32)
+  spans    1 | 0; build the texture's span table (textures; default 1)
+  bake     glyph height in pixels the font's SDF is baked at (fonts; default 32)
+  spread   distance range of the font's SDF in texels (fonts; default 4)
+
+  Rebuilds are incremental: each entry keeps a hash of its source's contents
+  and options. Entries of the existing output w/ a matching hash are copied
+  over instead of converted again; if nothing changed at all the output isn't
+  written. The game keeps its pack mapped, so close it before repacking.
+
+*/
+#include "../voidt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// NOTE(Joey): bump on changes to the conversions s.t. incremental rebuilds don't reuse stale entries
+const u32 PACKER_VERSION = 1;
+
+struct packer_asset
+{
+    vpak_entry_type Type;
+    char *Name;
+    char *Source;
+
+    texture_format Format;
+    bool32         Spans;
+    r32            BakeHeight;
+    r32            SDFSpread;
+
+    // NOTE(Joey): the entry's offsets are only filled in once its payload is written
+    vpak_entry   Entry;
+    u8          *Data;
+    u8          *SpansData;
+    memory_index SpansSize;
+    bool32       Reused;
+};
+
+global_variable memory_arena *PackerArena;
+
+// NOTE(Joey): stands in for the platform layer s.t. engine code reading files (LoadTrueTypeFont) works in the packer
+DEBUG_PLATFORM_READ_ENTIRE_FILE(PackerReadEntireFile)
+{
+    debug_read_file_result result = {};
+    FILE *file = fopen(fileName, "rb");
+    if(file)
+    {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if(size > 0 && (memory_index)size <= PackerArena->Size - PackerArena->Used - 16)
+        {
+            result.Contents = PushSize_(PackerArena, size, 16);
+            if(fread(result.Contents, 1, size, file) == (size_t)size)
+                result.ContentSize = (uint32)size;
+            else
+                result.Contents = 0;
+        }
+        fclose(file);
+    }
+    return result;
+}
+
+DEBUG_PLATFORM_FREE_FILE_MEMORY(PackerFreeFileMemory)
+{
+    // NOTE(Joey): file memory lives in the packer's arena until it exits
+}
+
+// NOTE(Joey): FNV-1a, 64 bit
+inline u64 HashBytes(u64 hash, void *data, memory_index size)
+{
+    u8 *bytes = (u8*)data;
+    for(memory_index i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i])*1099511628211ULL;
+    return hash;
+}
+
+internal u64 HashSource(packer_asset *asset, debug_read_file_result file)
+{
+    u64 hash = 14695981039346656037ULL;
+    u32 options[] = { PACKER_VERSION, VPAK_VERSION, (u32)asset->Type, (u32)asset->Format, (u32)asset->Spans };
+    r32 fontOptions[] = { asset->BakeHeight, asset->SDFSpread };
+    hash = HashBytes(hash, options, sizeof(options));
+    hash = HashBytes(hash, fontOptions, sizeof(fontOptions));
+    return HashBytes(hash, file.Contents, file.ContentSize);
+}
+
+inline bool32 IsManifestSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// NOTE(Joey): splits the line into zero terminated tokens in place; returns the token count
+internal u32 TokenizeManifestLine(char *line, char **tokens, u32 maxTokenCount)
+{
+    u32 count = 0;
+    char *c = line;
+    while(*c && *c != '#')
+    {
+        while(IsManifestSpace(*c))
+            *c++ = 0;
+        if(!*c || *c == '#')
+            break;
+        if(count < maxTokenCount)
+            tokens[count] = c;
+        ++count;
+        while(*c && *c != '#' && !IsManifestSpace(*c))
+            ++c;
+    }
+    *c = 0;
+    return count;
+}
+
+internal bool32 ParseManifestOption(packer_asset *asset, char *option)
+{
+    char *value = strchr(option, '=');
+    if(!value)
+        return false;
+    *value++ = 0;
+
+    bool32 result = true;
+    if(StringCompare(option, "source"))
+        asset->Source = value;
+    else if(StringCompare(option, "format") && asset->Type == VPAK_ENTRY_TEXTURE)
+    {
+        if(StringCompare(value, "argb32"))
+            asset->Format = TEXTURE_FORMAT_ARGB32;
+        else if(StringCompare(value, "palette8"))
+            asset->Format = TEXTURE_FORMAT_PALETTE8;
+        else if(StringCompare(value, "block4x4"))
+            asset->Format = TEXTURE_FORMAT_BLOCK4X4;
+        else
+            result = false;
+    }
+    else if(StringCompare(option, "spans") && asset->Type == VPAK_ENTRY_TEXTURE)
+        asset->Spans = atoi(value) != 0;
+    else if(StringCompare(option, "bake") && asset->Type == VPAK_ENTRY_FONT)
+        asset->BakeHeight = (r32)atof(value);
+    else if(StringCompare(option, "spread") && asset->Type == VPAK_ENTRY_FONT)
+        asset->SDFSpread = (r32)atof(value);
+    else
+        result = false;
+
+    if(!result)
+        value[-1] = '='; // NOTE(Joey): s.t. the error shows the option as written
+    return result;
+}
+
+internal bool32 ParseManifest(char *contents, packer_asset *assets, u32 *assetCount)
+{
+    u32 lineNumber = 0;
+    for(char *line = contents; line; )
+    {
+        char *nextLine = strchr(line, '\n');
+        if(nextLine)
+            *nextLine++ = 0;
+        ++lineNumber;
+
+        char *tokens[16];
+        u32 tokenCount = TokenizeManifestLine(line, tokens, ArrayCount(tokens));
+        line = nextLine;
+        if(tokenCount == 0)
+            continue;
+        if(tokenCount < 2 || tokenCount > ArrayCount(tokens) || *assetCount == MAX_ASSETS)
+        {
+            fprintf(stderr, "manifest(%u): expected 'type name [key=value ...]'\n", lineNumber);
+            return false;
+        }
+
+        packer_asset *asset = assets + (*assetCount)++;
+        ZeroSize(asset, sizeof(packer_asset));
+        if(StringCompare(tokens[0], "texture"))
+            asset->Type = VPAK_ENTRY_TEXTURE;
+        else if(StringCompare(tokens[0], "sound"))
+            asset->Type = VPAK_ENTRY_SOUND;
+        else if(StringCompare(tokens[0], "font"))
+            asset->Type = VPAK_ENTRY_FONT;
+        else
+        {
+            fprintf(stderr, "manifest(%u): unknown asset type '%s'\n", lineNumber, tokens[0]);
+            return false;
+        }
+        asset->Name       = tokens[1];
+        asset->Source     = tokens[1];
+        asset->Format     = TEXTURE_FORMAT_ARGB32;
+        asset->Spans      = true;
+        asset->BakeHeight = 32.0f;
+        asset->SDFSpread  = 4.0f;
+        for(u32 i = 2; i < tokenCount; ++i)
+        {
+            if(!ParseManifestOption(asset, tokens[i]))
+            {
+                fprintf(stderr, "manifest(%u): invalid option '%s' for %s\n", lineNumber, tokens[i], asset->Name);
+                return false;
+            }
+        }
+        for(u32 i = 0; i + 1 < *assetCount; ++i)
+        {
+            if(StringCompare(assets[i].Name, asset->Name))
+            {
+                fprintf(stderr, "manifest(%u): %s is listed twice\n", lineNumber, asset->Name);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// NOTE(Joey): the previous output, if it's a valid pack of this version; its entries can be reused
+internal vpak_header* ReadPreviousPack(char *fileName, memory_index *size)
+{
+    debug_read_file_result file = PackerReadEntireFile(fileName);
+    vpak_header *header = (vpak_header*)file.Contents;
+    *size = file.ContentSize;
+    if(!header || file.ContentSize < sizeof(vpak_header) ||
+       header->Magic != VPAK_MAGIC || header->Version != VPAK_VERSION ||
+       !IsPackRangeValid(header->EntriesOffset, (u64)header->EntryCount*sizeof(vpak_entry), file.ContentSize) ||
+       !IsPackRangeValid(header->NamesOffset, header->NamesSize, file.ContentSize) ||
+       header->NamesSize == 0 || ((char*)header)[header->NamesOffset + header->NamesSize - 1] != 0)
+        return 0;
+    return header;
+}
+
+internal vpak_entry* FindPreviousEntry(vpak_header *pack, memory_index packSize, char *name)
+{
+    vpak_entry *entries = (vpak_entry*)((u8*)pack + pack->EntriesOffset);
+    char *names = (char*)pack + pack->NamesOffset;
+    for(u32 i = 0; i < pack->EntryCount; ++i)
+    {
+        vpak_entry *entry = entries + i;
+        if(entry->NameOffset < pack->NamesSize && StringCompare(names + entry->NameOffset, name) &&
+           IsPackRangeValid(entry->DataOffset, entry->DataSize, packSize))
+            return entry;
+    }
+    return 0;
+}
+
+internal bool32 ReuseEntry(packer_asset *asset, vpak_header *pack, memory_index packSize, vpak_entry *entry)
+{
+    asset->SpansSize = 0;
+    asset->SpansData = 0;
+    if(entry->SpansOffset)
+    {
+        asset->SpansSize = GetPackedTextureSpansSize(entry->Width, entry->Height, entry->SpanCount);
+        if(!IsPackRangeValid(entry->SpansOffset, asset->SpansSize, packSize))
+            return false;
+        asset->SpansData = (u8*)pack + entry->SpansOffset;
+    }
+    asset->Entry  = *entry;
+    asset->Data   = (u8*)pack + entry->DataOffset;
+    asset->Reused = true;
+    return true;
+}
+
+// NOTE(Joey): .BMP to the texture's final format w/ its span table; the same steps GetTexture takes at runtime
+internal bool32 PackTexture(packer_asset *asset, debug_read_file_result file)
+{
+    bitmap_header *header = (bitmap_header*)file.Contents;
+    if(file.ContentSize < sizeof(bitmap_header) || !IsSupportedBitmap(header) ||
+       header->BitmapOffset + GetDecodedBitmapSize(header) > file.ContentSize ||
+       header->Width > 0xFFFF || header->Height > 0xFFFF)
+    {
+        fprintf(stderr, "%s: not a 32 bit .BMP\n", asset->Source);
+        return false;
+    }
+
+    Texture texture = DecodeBitmap(header, (uint32*)((u8*)header + header->BitmapOffset));
+    if(asset->Spans && GetTextureSpansSize(&texture))
+    {
+        memory_index spansSize = GetTextureSpansSize(&texture);
+        memory_arena spanArena;
+        InitializeArena(&spanArena, spansSize, PushSize_(PackerArena, spansSize, 16));
+        BuildTextureSpans(&texture, &spanArena);
+    }
+    if(!CompressTexture(&texture, asset->Format, PackerArena))
+    {
+        fprintf(stderr, "%s: too small to compress, stored as argb32\n", asset->Source);
+        asset->Format = TEXTURE_FORMAT_ARGB32;
+    }
+
+    asset->Entry.Format = (u16)texture.Format;
+    asset->Entry.Width  = (u16)texture.Width;
+    asset->Entry.Height = (u16)texture.Height;
+    asset->Entry.DataSize = GetTextureDataSize(texture.Width, texture.Height, texture.Format);
+    asset->Data = (u8*)texture.Texels;
+    if(texture.Spans)
+    {
+        asset->Entry.SpanCount = texture.Spans->RowSpanStart[texture.Spans->RowCount];
+        asset->SpansSize = GetPackedTextureSpansSize(texture.Width, texture.Height, asset->Entry.SpanCount);
+        asset->SpansData = (u8*)PushSize_(PackerArena, asset->SpansSize, 16);
+        StorePackedTextureSpans(&texture, asset->SpansData);
+    }
+    return true;
+}
+
+internal bool32 PackSound(packer_asset *asset, debug_read_file_result file)
+{
+    wav_samples samples = ParseWAV(file.Contents, file.ContentSize);
+    if(samples.ChannelCount == 0)
+    {
+        fprintf(stderr, "%s: not a valid .WAV (16 bit PCM, 48000 Hz, 1 or 2 channels)\n", asset->Source);
+        return false;
+    }
+    Sound sound = DecodeWAV(&samples, samples.Interleaved);
+    asset->Entry.SampleCount = sound.SampleCount;
+    asset->Entry.DataSize    = GetDecodedWAVSize(&samples);
+    asset->Data = (u8*)sound.Samples[0];
+    return true;
+}
+
+internal bool32 PackFont(packer_asset *asset)
+{
+    game_font *font = LoadTrueTypeFont(PackerArena, asset->Source);
+    if(!font)
+    {
+        fprintf(stderr, "%s: can't read font\n", asset->Source);
+        return false;
+    }
+    LoadFontGlyphsSDF(PackerArena, font, asset->BakeHeight, asset->SDFSpread);
+
+    u32 count = font->CodePointCount;
+    memory_index glyphsOffset = sizeof(vpak_font) + count*(sizeof(vector2D) + sizeof(r32));
+    memory_index size = glyphsOffset + count*sizeof(vpak_glyph);
+    for(u32 i = 0; i < count; ++i)
+    {
+        size = Align16(size);
+        size += font->CodePoints[i].Width*font->CodePoints[i].Height*sizeof(uint32);
+    }
+
+    u8 *data = (u8*)PushSize_(PackerArena, size, 16);
+    ZeroSize(data, size);
+    vpak_font *packed = (vpak_font*)data;
+    packed->CodePointCount = count;
+    packed->BakeHeight     = font->BakeHeight;
+    packed->SDFSpread      = font->SDFSpread;
+    packed->LineAdvance    = font->LineAdvance;
+    packed->SpaceAdvance   = font->SpaceAdvance;
+    packed->Ascent         = font->Ascent;
+    packed->Descent        = font->Descent;
+
+    vector2D *glyphOffsets = (vector2D*)(packed + 1);
+    r32 *glyphAdvances = (r32*)(glyphOffsets + count);
+    vpak_glyph *glyphs = (vpak_glyph*)(data + glyphsOffset);
+    memory_index texelsOffset = glyphsOffset + count*sizeof(vpak_glyph);
+    for(u32 i = 0; i < count; ++i)
+    {
+        Texture *glyph = font->CodePoints + i;
+        glyphOffsets[i]  = font->GlyphOffsets[i];
+        glyphAdvances[i] = font->GlyphAdvances[i];
+
+        texelsOffset = Align16(texelsOffset);
+        glyphs[i].Width        = (u16)glyph->Width;
+        glyphs[i].Height       = (u16)glyph->Height;
+        glyphs[i].TexelsOffset = (u32)texelsOffset;
+        uint32 *dest = (uint32*)(data + texelsOffset);
+        for(u32 y = 0; y < glyph->Height; ++y)
+        {
+            uint32 *row = (uint32*)((u8*)glyph->Texels + y*glyph->Pitch);
+            for(u32 x = 0; x < glyph->Width; ++x)
+                *dest++ = row[x];
+        }
+        texelsOffset += glyph->Width*glyph->Height*sizeof(uint32);
+    }
+    Assert(texelsOffset == size);
+
+    asset->Entry.DataSize = size;
+    asset->Data = data;
+    return true;
+}
+
+internal bool32 PackAsset(packer_asset *asset, vpak_header *previous, memory_index previousSize)
+{
+    debug_read_file_result file = PackerReadEntireFile(asset->Source);
+    if(!file.Contents)
+    {
+        fprintf(stderr, "%s: can't read file\n", asset->Source);
+        return false;
+    }
+
+    ZeroSize(&asset->Entry, sizeof(vpak_entry));
+    asset->Entry.Type       = (u16)asset->Type;
+    asset->Entry.NameHash   = HashAssetName(asset->Name);
+    asset->Entry.SourceHash = HashSource(asset, file);
+
+    vpak_entry *entry = previous ? FindPreviousEntry(previous, previousSize, asset->Name) : 0;
+    if(entry && entry->SourceHash == asset->Entry.SourceHash && entry->Type == asset->Entry.Type &&
+       ReuseEntry(asset, previous, previousSize, entry))
+        return true;
+
+    bool32 result = false;
+    switch(asset->Type)
+    {
+        case VPAK_ENTRY_TEXTURE:
+        {
+            result = PackTexture(asset, file);
+        } break;
+        case VPAK_ENTRY_SOUND:
+        {
+            result = PackSound(asset, file);
+        } break;
+        case VPAK_ENTRY_FONT:
+        {
+            result = PackFont(asset);
+        } break;
+    }
+    return result;
+}
+
+internal bool32 WritePadding(FILE *file, u64 *offset, u64 alignment)
+{
+    local_persist u8 zeroes[VPAK_ALIGNMENT] = {};
+    u64 padding = ((*offset + alignment - 1) & ~(alignment - 1)) - *offset;
+    *offset += padding;
+    return fwrite(zeroes, 1, (size_t)padding, file) == padding;
+}
+
+internal bool32 WriteBytes(FILE *file, u64 *offset, void *data, u64 size)
+{
+    *offset += size;
+    return fwrite(data, 1, (size_t)size, file) == size;
+}
+
+internal bool32 WritePack(char *fileName, packer_asset *assets, u32 assetCount)
+{
+    // NOTE(Joey): entries are sorted on name hash for the loader's binary search
+    for(u32 i = 1; i < assetCount; ++i)
+    {
+        packer_asset asset = assets[i];
+        u32 j = i;
+        for(; j > 0 && assets[j - 1].Entry.NameHash > asset.Entry.NameHash; --j)
+            assets[j] = assets[j - 1];
+        assets[j] = asset;
+    }
+
+    vpak_header header = {};
+    header.Magic         = VPAK_MAGIC;
+    header.Version       = VPAK_VERSION;
+    header.EntryCount    = assetCount;
+    header.EntriesOffset = sizeof(vpak_header);
+    header.NamesOffset   = header.EntriesOffset + assetCount*sizeof(vpak_entry);
+    for(u32 i = 0; i < assetCount; ++i)
+    {
+        assets[i].Entry.NameOffset = header.NamesSize;
+        header.NamesSize += (u32)strlen(assets[i].Name) + 1;
+    }
+
+    // NOTE(Joey): payload offsets follow from the sizes; lay them out before writing anything
+    u64 offset = header.NamesOffset + header.NamesSize;
+    for(u32 i = 0; i < assetCount; ++i)
+    {
+        vpak_entry *entry = &assets[i].Entry;
+        offset = (offset + VPAK_ALIGNMENT - 1) & ~((u64)VPAK_ALIGNMENT - 1);
+        entry->DataOffset = offset;
+        offset += entry->DataSize;
+        entry->SpansOffset = 0;
+        if(assets[i].SpansData)
+        {
+            offset = (offset + 3) & ~3ULL;
+            entry->SpansOffset = offset;
+            offset += assets[i].SpansSize;
+        }
+    }
+
+    FILE *file = fopen(fileName, "wb");
+    if(!file)
+        return false;
+    offset = 0;
+    bool32 result = WriteBytes(file, &offset, &header, sizeof(header));
+    for(u32 i = 0; i < assetCount; ++i)
+        result = result && WriteBytes(file, &offset, &assets[i].Entry, sizeof(vpak_entry));
+    for(u32 i = 0; i < assetCount; ++i)
+        result = result && WriteBytes(file, &offset, assets[i].Name, strlen(assets[i].Name) + 1);
+    for(u32 i = 0; i < assetCount && result; ++i)
+    {
+        result = WritePadding(file, &offset, VPAK_ALIGNMENT) &&
+                 WriteBytes(file, &offset, assets[i].Data, assets[i].Entry.DataSize);
+        if(result && assets[i].SpansData)
+        {
+            result = WritePadding(file, &offset, 4) &&
+                     WriteBytes(file, &offset, assets[i].SpansData, assets[i].SpansSize);
+            Assert(offset == assets[i].Entry.SpansOffset + assets[i].SpansSize);
+        }
+    }
+    result = fclose(file) == 0 && result;
+    return result;
+}
+
+int main(int argumentCount, char **arguments)
+{
+    if(argumentCount != 3)
+    {
+        fprintf(stderr, "usage: asset_packer <manifest> <output.vpak>\n");
+        return 1;
+    }
+    char *manifestName = arguments[1];
+    char *outputName   = arguments[2];
+
+    memory_index arenaSize = MegaBytes(512);
+    void *arenaMemory = malloc(arenaSize);
+    if(!arenaMemory)
+        return 1;
+    memory_arena arena;
+    InitializeArena(&arena, arenaSize, arenaMemory);
+    PackerArena = &arena;
+    PlatformAPI.DEBUGReadEntireFile = PackerReadEntireFile;
+    PlatformAPI.DEBUGFreeFileMemory = PackerFreeFileMemory;
+
+    debug_read_file_result manifest = PackerReadEntireFile(manifestName);
+    if(!manifest.Contents)
+    {
+        fprintf(stderr, "%s: can't read manifest\n", manifestName);
+        return 1;
+    }
+    // NOTE(Joey): zero terminate the manifest; names and options point into it
+    char *contents = (char*)PushSize_(&arena, manifest.ContentSize + 1);
+    memcpy(contents, manifest.Contents, manifest.ContentSize);
+    contents[manifest.ContentSize] = 0;
+
+    packer_asset *assets = PushArray(&arena, MAX_ASSETS, packer_asset);
+    u32 assetCount = 0;
+    if(!ParseManifest(contents, assets, &assetCount))
+        return 1;
+
+    memory_index previousSize;
+    vpak_header *previous = ReadPreviousPack(outputName, &previousSize);
+    u32 reusedCount = 0;
+    for(u32 i = 0; i < assetCount; ++i)
+    {
+        if(!PackAsset(assets + i, previous, previousSize))
+            return 1;
+        if(assets[i].Reused)
+            ++reusedCount;
+        else
+            printf("packed %s\n", assets[i].Name);
+    }
+
+    if(previous && reusedCount == assetCount && previous->EntryCount == assetCount)
+    {
+        printf("%s is up to date\n", outputName);
+        return 0;
+    }
+    if(!WritePack(outputName, assets, assetCount))
+    {
+        fprintf(stderr, "%s: can't write pack\n", outputName);
+        return 1;
+    }
+    printf("%s: %u assets, %u reused\n", outputName, assetCount, reusedCount);
+    return 0;
+}
+
+#if __COUNTER__ == 0
+timing_record TimingRecords[1];
+#else
+timing_record TimingRecords[__COUNTER__ - 1];
+#endif
@@ -12,6 +12,9 @@
 #include "voidt.h"
 
 internal void DisplayTimingRecords();
+#if INTERNAL
+internal void DebugUITimingPanel(debug_ui *ui, rectangle2Di rect);
+#endif
 
 extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
 {   
@@ -29,6 +32,8 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     PlatformAPI.OpenFile             = memory->PlatformAPI.OpenFile;
     PlatformAPI.ReadFile             = memory->PlatformAPI.ReadFile;
     PlatformAPI.CloseFile            = memory->PlatformAPI.CloseFile;
+    PlatformAPI.MapFile              = memory->PlatformAPI.MapFile;
+    PlatformAPI.UnmapFile            = memory->PlatformAPI.UnmapFile;
 
     // Assert((&input->Controllers[0].Back - &input->Controllers[0].Buttons[0]) == ArrayCount(input->Controllers[0].Buttons) - 1); // check if button array matches union struct members
     Assert(sizeof(game_state) <= memory->PermanentStorageSize);      
@@ -50,6 +55,9 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
         
         // generate entities
         gameState->PlayerPos = { 0.0f, 0.0f };
+        // NOTE(Joey): start past the fire/explosion cooldowns s.t. their flash lights stay off until triggered
+        gameState->FireDelay = 0.2f;
+        gameState->ExplosionDelay = 1.0f;
         
         for(u32 i = 0; i < ArrayCount(gameState->Entities); ++i)
         {
@@ -60,6 +68,39 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
             gameState->Entities[i].Size.y     = Max(RandomBetween(&GlobalRandom, -10.0f,  10.0f), 2.0f);
         }                
         
+        InitParticleSystem(&gameState->Particles, &gameState->WorldArena, 131072, 2.0f);
+        
+        // NOTE(Joey): procedural star field; a tileset of 4 sparse star tiles scattered over the tilemap
+        const u32 STAR_TILE_SIZE = 16;
+        const u32 STAR_TILE_COUNT = 4;
+        gameState->BackgroundTileset = CreateEmptyTexture(&gameState->WorldArena, STAR_TILE_SIZE*STAR_TILE_COUNT, STAR_TILE_SIZE);
+        for(u32 i = 0; i < 3*STAR_TILE_COUNT; ++i)
+        {
+            u32 x = RandomChoice(&GlobalRandom, gameState->BackgroundTileset.Width);
+            u32 y = RandomChoice(&GlobalRandom, gameState->BackgroundTileset.Height);
+            u32 brightness = 128 + RandomChoice(&GlobalRandom, 128);
+            gameState->BackgroundTileset.Texels[y*gameState->BackgroundTileset.Width + x] = 0xFF000000 | (brightness << 16) | (brightness << 8) | brightness;
+        }
+        InitTilemap(&gameState->Background, &gameState->WorldArena, STAR_TILE_SIZE, screenBuffer->Width, screenBuffer->Height);
+        for(i32 y = -64; y < 64; ++y)
+            for(i32 x = -64; x < 64; ++x)
+                SetTile(&gameState->Background, &gameState->WorldArena, x, y, (u8)(1 + RandomChoice(&GlobalRandom, STAR_TILE_COUNT)));
+        
+        InitSpriteCache(&gameState->SpriteCache, &gameState->WorldArena, MegaBytes(8));
+        
+        // post-processing
+        gameState->PostProcess.BloomEnabled      = true;
+        gameState->PostProcess.BloomThreshold    = 0.7f;
+        gameState->PostProcess.BloomIntensity    = 0.6f;
+        gameState->PostProcess.VignetteEnabled   = true;
+        gameState->PostProcess.VignetteStrength  = 0.35f;
+        gameState->PostProcess.ColorGradeEnabled = true;
+        GenerateColorGradeLUT(&gameState->PostProcess.ColorGrade, 1.1f, { 1.0f, 0.97f, 0.92f, 1.0f });
+        
+#if INTERNAL
+        InitDebugDraw(&gameState->DebugDraw, &gameState->WorldArena, 16384);
+#endif
+        
         gameState->IsInitialized = true;
     }            
     // NOTE(Joey): transient memory is memory that could in time be de-allocated / re-allocated (like 
@@ -75,30 +116,60 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
         // allocate game assets
         transientState->Assets.Arena = &transientState->TransientArena;
         transientState->Assets.Memory = GenerateGeneralPurposeAllocater(&transientState->TransientArena, MegaBytes(16));
+        transientState->Assets.MemoryMax = MegaBytes(16);
+        transientState->Assets.MemorySafetyRegion = MegaBytes(2);
+        transientState->Assets.MemoryInUse = 0;
+        transientState->Assets.MemoryLock = 0;
+        transientState->Assets.FrameIndex = 0;
+        transientState->Assets.EvictionCount = 0;
         transientState->Assets.LoadedTextureCount = 0;
         transientState->Assets.LoadedSoundCount = 0;
+        transientState->Assets.AssetCount = 0;
+        transientState->Assets.Pack = 0;
+        // NOTE(Joey): w/o the pack all assets load from their own files
+        OpenAssetPack(&transientState->Assets, "assets.vpak");
         
-        GetGeneralMemory(transientState->Assets.Memory, MegaBytes(2));
+        InitVirtualTextureCache(&transientState->VirtualTextures, &transientState->TransientArena, MegaBytes(12));
+        transientState->Background = LoadVirtualTexture(&transientState->VirtualTextures, 
+                                                        &transientState->TransientArena, 
+                                                        "space/background.bmp");
         
         // pre-fetch 
-        PreFetchTexture(&transientState->Assets, "space/background.bmp");
-        PreFetchTexture(&transientState->Assets, "space/player.bmp");
-        PreFetchTexture(&transientState->Assets, "space/enemy.bmp");
+        transientState->PlayerTexture = PreFetchTexture(&transientState->Assets, "space/player.bmp", false, TEXTURE_FORMAT_PALETTE8);
+        transientState->EnemyTexture  = PreFetchTexture(&transientState->Assets, "space/enemy.bmp", false, TEXTURE_FORMAT_BLOCK4X4);
 
-        PreFetchSound(&transientState->Assets, "audio/music.wav", true);
-        PreFetchSound(&transientState->Assets, "audio/gun.wav");
-        PreFetchSound(&transientState->Assets, "audio/explosion.wav");            
+        transientState->MusicSound     = PreFetchSound(&transientState->Assets, "audio/music.wav", true);
+        transientState->GunSound       = PreFetchSound(&transientState->Assets, "audio/gun.wav");
+        transientState->ExplosionSound = PreFetchSound(&transientState->Assets, "audio/explosion.wav");            
 
-        // stbtt_fontinfo font = LoadTrueTypeFont("C:/Windows/Fonts/Calibri.ttf");
-        // gameState->letterN = LoadCharacterGlyph(&transientState->TransientArena, font, 'N', 128.0f);
+        // NOTE(Joey): glyphs are baked once as distance fields; all entity sizes sample the same bake.
+        // game_font *font = LoadTrueTypeFont(&transientState->TransientArena, "C:/Windows/Fonts/Calibri.ttf");
+        // LoadFontGlyphsSDF(&transientState->TransientArena, font, 64.0f, 8.0f);
+        // gameState->letterN = *GetGlyph(font, 'N');
+#if INTERNAL
+        // NOTE(Joey): the pack holds the font pre-baked; w/o either the debug UI still draws its panels, just without text
+        game_font *debugFont = GetPackedFont(&transientState->Assets, "fonts/consola.ttf");
+        if(!debugFont)
+        {
+            debugFont = LoadTrueTypeFont(&transientState->TransientArena, "C:/Windows/Fonts/consola.ttf");
+            if(debugFont)
+                LoadFontGlyphsSDF(&transientState->TransientArena, debugFont, 32.0f, 4.0f);
+        }
+        InitDebugUI(&gameState->DebugUI, &gameState->WorldArena, debugFont, 14.0f);
+#endif
         
-        gameState->Music = PlaySound(&gameState->Mixer, GetSound(&transientState->Assets, "audio/music.wav"), 0.0f, 1.0f, true);   
-        SetVolume(gameState->Music, 1.0f, 1.0f, 25.5f);
+        gameState->Music = PlaySound(&gameState->Mixer, &transientState->Assets, transientState->MusicSound, 0.0f, 1.0f, true);   
+        if(gameState->Music)
+            SetVolume(gameState->Music, 1.0f, 1.0f, 25.5f);
         // SetVolume(sound, 0.75f, 0.75f, 7.5f);
          
         transientState->IsInitialized = true;
     }
       
+    const r32 METERS_TO_PIXELS = 25.0f;
+    const r32 PIXELS_TO_METERS = 1.0f / METERS_TO_PIXELS;
+    vector2D enemyPos = { 350.0f*PIXELS_TO_METERS, -150.0f*PIXELS_TO_METERS };
+    
     gameState->FireDelay += input->dtPerFrame;    
     gameState->ExplosionDelay += input->dtPerFrame;    
     //////////////////////////////////////////////////////////
@@ -141,14 +212,22 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
                 if(choice == 1) pitch = 1.25f;
                 if(choice == 2) pitch = 0.85f;
                 // PlaySound(&gameState->Mixer, GetSound(&transientState->Assets, "audio/gun.wav"), 1.0f, pitch);
-                PlaySound(&gameState->Mixer, GetSound(&transientState->Assets, "audio/gun.wav"), 1.0f, 1.0f);
+                PlaySound(&gameState->Mixer, &transientState->Assets, transientState->GunSound, 1.0f, 1.0f);
                 gameState->FireDelay = 0.0f;
             }
             if (controller->LeftShoulder.EndedDown && gameState->ExplosionDelay >= 1.0f)
             {
-                PlaySound(&gameState->Mixer, GetSound(&transientState->Assets, "audio/explosion.wav"), 1.0f, 1.0f);
+                PlaySound(&gameState->Mixer, &transientState->Assets, transientState->ExplosionSound, 1.0f, 1.0f);
+                SpawnParticleBurst(&gameState->Particles, &GlobalRandom, enemyPos, 25000, 
+                                   1.0f, 12.0f, 0.4f, 1.6f, { 1.0f, 0.6f, 0.25f });
                 gameState->ExplosionDelay = 0.0f;
             }
+#if INTERNAL
+            if(controller->Start.EndedDown && controller->Start.HalfTransitionCount > 0)
+                gameState->ShowRenderStats = !gameState->ShowRenderStats;
+            if(controller->Back.EndedDown && controller->Back.HalfTransitionCount > 0)
+                gameState->ShowDebugUI = !gameState->ShowDebugUI;
+#endif
         }
     }
     
@@ -160,6 +239,20 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     rectangle2D simBounds = { -0.5f*simRegionSize, 0.5f*simRegionSize };   
     
     sim_region *simRegion = BeginSimulation(gameState, transientArena, gameState->CameraPos, simBounds);    
+#if INTERNAL
+    // NOTE(Joey): shapes can be pushed from here on; they're drawn on top of the frame if enabled
+    BeginDebugDraw(&gameState->DebugDraw);
+    rectangle2D simRect = { gameState->CameraPos + simBounds.Min, gameState->CameraPos + simBounds.Max };
+    DebugDrawRectangle(&gameState->DebugDraw, simRect, { 0.2f, 1.0f, 0.2f, 1.0f });
+    for(u32 i = 0; i < simRegion->EntityCount; ++i)
+    {
+        sim_entity *entity = simRegion->Entities + i;
+        rectangle2D entityRect = { entity->Position - 0.5f*entity->Size, entity->Position + 0.5f*entity->Size };
+        DebugDrawRectangle(&gameState->DebugDraw, entityRect, { 1.0f, 0.3f, 0.3f, 0.75f });
+    }
+#endif
+    
+    UpdateParticles(&gameState->Particles, input->dtPerFrame);
     
     // NOTE(Joey): now do game logic on all sim entities
     for(u32 i = 0; i < simRegion->EntityCount; ++i)
@@ -174,24 +267,39 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     //////////////////////////////////////////////////////////
     //       RENDER
     //////////////////////////////////////////////////////////         
-    const r32 METERS_TO_PIXELS = 25.0f;
-    const r32 PIXELS_TO_METERS = 1.0f / METERS_TO_PIXELS;
     // TODO(Joey): make sure no other allocations happen in transient arena in the meantime
     // like: allocation of assets when requested (make sure this happens in different arena 
     // otherwise).
+#if INTERNAL
+    if(memory->RunRenderRegression)
+    {
+        RunRenderRegression(PlatformAPI.WorkQueueHighPriority, transientArena, "regression");
+        memory->RunRenderRegression = false;
+    }
+#endif
     temp_memory tempRenderMemory = BeginTempMemory(transientArena);
     
     Texture screenTexture = CreateEmptyTexture(transientArena, screenBuffer->Width, screenBuffer->Height);
     RenderQueue *renderQueue = CreateRenderQueue(transientArena, 256); 
+    light_list *lights = CreateLightList(transientArena, 64);
+    BeginSpriteCacheFrame(&gameState->SpriteCache);
+    UpdateVirtualTextures(&transientState->VirtualTextures);
         
     // background
     vector2D screenSize = { (real32)screenBuffer->Width, (real32)screenBuffer->Height };
     vector2D screenCenter = 0.5f*screenSize;
-    PushTexture(renderQueue, 
-                GetTexture(&transientState->Assets, "space/background.bmp"),
-                screenCenter, 
-                0, 
-                screenSize);
+    PushVirtualTexture(renderQueue, 
+                       transientState->Background,
+                       screenCenter, 
+                       0, 
+                       screenSize);
+
+    PushTilemap(renderQueue, 
+                &gameState->Background, 
+                &gameState->BackgroundTileset, 
+                screenCenter - METERS_TO_PIXELS*gameState->CameraPos, 
+                &screenTexture, 
+                0);
 
     real32 angle = gameState->TimePassed;
     
@@ -204,7 +312,7 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     vector2D basisX = Normalize({ (real32)cos(angle), (real32)sin(angle)});
     vector2D basisY = Perpendicular(basisX);
     PushTexture(renderQueue, 
-                GetTexture(&transientState->Assets, "space/player.bmp"), 
+                GetTexture(&transientState->Assets, transientState->PlayerTexture), 
                 screenCenter + METERS_TO_PIXELS*playerRelCamera, 
                 0,
                 { (real32)80, (real32)100 },
@@ -213,39 +321,140 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
                 { 1.0f, 1.0f, 1.0f, 0.5f });
 
     // enemy
-    vector2D enemyPos = { 350.0f*PIXELS_TO_METERS, -150.0f*PIXELS_TO_METERS };
     vector2D enemeyRelCamera = enemyPos - cameraPos;
     angle = 42.30f + gameState->TimePassed * 0.1f;
     basisX = Normalize({ (real32)cos(angle), (real32)sin(angle)});
     basisY = Perpendicular(basisX);
-    PushTexture(renderQueue, 
-                GetTexture(&transientState->Assets, "space/enemy.bmp"),
-                screenCenter + METERS_TO_PIXELS*enemeyRelCamera,
-                0,
-                { 200.0f, 200.0f }, 
-                basisX, 
-                basisY, 
-                { 1.0f, 1.0f, 1.0f, 1.0f });
+    PushTextureCached(renderQueue, 
+                      &gameState->SpriteCache,
+                      &transientState->Assets, 
+                      transientState->EnemyTexture,
+                      screenCenter + METERS_TO_PIXELS*enemeyRelCamera,
+                      0,
+                      { 200.0f, 200.0f }, 
+                      basisX, 
+                      basisY, 
+                      { 1.0f, 1.0f, 1.0f, 1.0f });
+                
+    // NOTE(Joey): muzzle flash and explosion lights fade out over a short period after triggering
+    const r32 MUZZLE_FLASH_DURATION = 0.05f;
+    const r32 EXPLOSION_FLASH_DURATION = 0.6f;
+    if(gameState->FireDelay < MUZZLE_FLASH_DURATION)
+        PushPointLight(lights, 
+                       screenCenter + METERS_TO_PIXELS*playerRelCamera, 
+                       150.0f, 
+                       { 1.0f, 0.8f, 0.4f }, 
+                       2.0f*(1.0f - gameState->FireDelay / MUZZLE_FLASH_DURATION));
+    if(gameState->ExplosionDelay < EXPLOSION_FLASH_DURATION)
+        PushPointLight(lights, 
+                       screenCenter + METERS_TO_PIXELS*enemeyRelCamera, 
+                       300.0f, 
+                       { 1.0f, 0.5f, 0.2f }, 
+                       3.0f*(1.0f - gameState->ExplosionDelay / EXPLOSION_FLASH_DURATION));
                 
     // render all sim entities
     for(u32 i = 0; i < simRegion->EntityCount; ++i)
     {
         sim_entity *entity = simRegion->Entities + i;
         vector2D relCamera = entity->Position - cameraPos;
-        PushTexture(renderQueue, 
-                    // GetTexture(&transientState->Assets, "space/enemy.bmp"),
-                    &gameState->letterN,
-                    screenCenter + METERS_TO_PIXELS*relCamera,
-                    0,
-                    METERS_TO_PIXELS*entity->Size,
-                    basisX,
-                    basisY,
-                    { 1.0f, 1.0f, 1.0f, 1.0f });
+        PushTextureSDFCached(renderQueue, 
+                             &gameState->SpriteCache,
+                             // GetTexture(&transientState->Assets, "space/enemy.bmp"),
+                             &gameState->letterN,
+                             screenCenter + METERS_TO_PIXELS*relCamera,
+                             0,
+                             METERS_TO_PIXELS*entity->Size,
+                             basisX,
+                             basisY,
+                             { 1.0f, 1.0f, 1.0f, 1.0f },
+                             8.0f);
                     
     }
+    
+    // particles
+    particle_render_batch *particles = PrepareParticleBatch(transientArena, 
+                                                            &gameState->Particles, 
+                                                            &screenTexture, 
+                                                            screenCenter - METERS_TO_PIXELS*cameraPos, 
+                                                            METERS_TO_PIXELS, 
+                                                            3.0f);
+    PushParticles(renderQueue, particles, 0);
                 
     // render to target
-    RenderPass(PlatformAPI.WorkQueueHighPriority, renderQueue, &screenTexture);
+    RenderPass(PlatformAPI.WorkQueueHighPriority, renderQueue, &screenTexture, 0, &gameState->RenderStats);
+    LightingPass(PlatformAPI.WorkQueueHighPriority, transientArena, lights, &screenTexture);
+    PostProcessPass(PlatformAPI.WorkQueueHighPriority, transientArena, &screenTexture, &gameState->PostProcess);
+#if INTERNAL
+    // NOTE(Joey): toggled w/ the start button; tints tiles by cost and exports the frame's tile counters
+    if(gameState->ShowRenderStats)
+    {
+        RenderTileStatsOverlay(&screenTexture, &gameState->RenderStats);
+        OutputRenderStats(&gameState->RenderStats);
+    }
+    // NOTE(Joey): debug shapes are drawn after lighting/post-processing s.t. they keep their colors
+    if(gameState->ShowDebugDraw)
+    {
+        RenderQueue *debugQueue = CreateRenderQueue(transientArena, 2);
+        debug_draw_batch *debugShapes = PrepareDebugDrawBatch(transientArena, 
+                                                              &gameState->DebugDraw, 
+                                                              screenCenter - METERS_TO_PIXELS*cameraPos, 
+                                                              METERS_TO_PIXELS);
+        PushDebugDraw(debugQueue, debugShapes, 0);
+        RenderPass(PlatformAPI.WorkQueueHighPriority, debugQueue, &screenTexture);
+    }
+    // NOTE(Joey): debug panels are rendered on top, after lighting/post-processing; toggled w/ the back button
+    if(gameState->ShowDebugUI)
+    {
+        debug_ui *ui = &gameState->DebugUI;
+        RenderQueue *uiQueue = CreateRenderQueue(transientArena, 4096);
+        BeginDebugUI(ui, uiQueue, input, &screenTexture);
+        
+        int32 top = screenTexture.Height - 8;
+        DebugUITimingPanel(ui, { 8, 8, 328, top });
+        
+        GameAssets *assets = &transientState->Assets;
+        BeginDebugUIPanel(ui, "assets", { 336, top - 150, 616, top });
+        DebugUIPrintf(ui, "textures %u  sounds %u  evictions %u", assets->LoadedTextureCount, 
+                      assets->LoadedSoundCount, assets->EvictionCount);
+        DebugUIPrintf(ui, "pack entries %u", assets->PackEntryCount);
+        DebugUIBar(ui, "asset budget", (real32)assets->MemoryInUse, (real32)assets->MemoryMax);
+        DebugUIBar(ui, "general memory", (real32)assets->Memory->MemoryUsed, (real32)assets->Memory->TotalMemory);
+        DebugUIBar(ui, "transient arena", (real32)transientArena->Used, (real32)transientArena->Size);
+        DebugUIPrintf(ui, "virtual pages %u  requests %u  loads %u", transientState->VirtualTextures.PageCount,
+                      transientState->VirtualTextures.RequestCount, transientState->VirtualTextures.LoadCount);
+        EndDebugUIPanel(ui);
+        
+        BeginDebugUIPanel(ui, "mixer", { 336, top - 320, 616, top - 158 });
+        DebugUIBar(ui, "master volume", gameState->Mixer.MasterVolume, 1.0f);
+        u32 voiceIndex = 0;
+        for(PlayingSound *voice = gameState->Mixer.FirstPlayingSound; voice; voice = voice->Next, ++voiceIndex)
+        {
+            r32 sampleCount = voice->Source ? (r32)voice->Source->SampleCount : 0.0f;
+            DebugUIPrintf(ui, "%2u: vol %.2f/%.2f pitch %.2f%s", voiceIndex, voice->CurrentVolume[0], 
+                          voice->CurrentVolume[1], voice->Pitch, voice->Loop ? " loop" : "");
+            DebugUIBar(ui, "  progress", voice->SamplesPlayed, sampleCount);
+        }
+        EndDebugUIPanel(ui);
+        
+        BeginDebugUIPanel(ui, "post-processing", { 624, top - 150, 952, top });
+        DebugUIToggle(ui, "bloom", &gameState->PostProcess.BloomEnabled);
+        DebugUISlider(ui, "threshold", &gameState->PostProcess.BloomThreshold, 0.0f, 1.0f);
+        DebugUISlider(ui, "intensity", &gameState->PostProcess.BloomIntensity, 0.0f, 2.0f);
+        DebugUIToggle(ui, "vignette", &gameState->PostProcess.VignetteEnabled);
+        DebugUISlider(ui, "strength", &gameState->PostProcess.VignetteStrength, 0.0f, 1.0f);
+        DebugUIToggle(ui, "color grade", &gameState->PostProcess.ColorGradeEnabled);
+        DebugUIPrintf(ui, "ui cache: %u hits %u misses", ui->CacheHits, ui->CacheMisses);
+        EndDebugUIPanel(ui);
+        
+        BeginDebugUIPanel(ui, "debug draw", { 624, top - 220, 952, top - 158 });
+        DebugUIToggle(ui, "bounds", &gameState->ShowDebugDraw);
+        DebugUIPrintf(ui, "shapes %u/%u", gameState->DebugDraw.ShapeCount, gameState->DebugDraw.MaxShapeCount);
+        EndDebugUIPanel(ui);
+        
+        EndDebugUI(ui);
+        RenderPass(PlatformAPI.WorkQueueHighPriority, uiQueue, &screenTexture);
+    }
+#endif
 
     // output to screen
     BlitTextureToScreen(screenBuffer, &screenTexture);
@@ -254,6 +463,9 @@ extern "C" GAME_UPDATE_AND_RENDER(GameUpdateAndRender)
     EndTempMemory(tempRenderMemory);
     EndTempMemory(simMemory);
     
+    // NOTE(Joey): after the frame's render work is done; nothing refers to this frame's assets anymore
+    EvictAssetsAsNecessary(&transientState->Assets);
+    
     CheckArena(&gameState->WorldArena);
     CheckArena(transientArena);
 
@@ -325,6 +537,8 @@ internal void DisplayTimingRecords()
         // NOTE(Joey): _InterlockedExchange returns original value
         u32 cycleCount = _InterlockedExchange((volatile long *)&record->CycleCount, 0);
         u32 hitCount   = _InterlockedExchange((volatile long *)&record->HitCount, 0);
+        record->LastCycleCount = cycleCount;
+        record->LastHitCount   = hitCount;
         
         PlatformAPI.WriteDebugOutput("%24s(%3d) | %12llucy | %5dh | %10llucy/h\n",
                                      record->FunctionName, record->LineNumber, cycleCount, hitCount, 
@@ -332,3 +546,19 @@ internal void DisplayTimingRecords()
                                      
     }   
 }
+
+#if INTERNAL
+internal void DebugUITimingPanel(debug_ui *ui, rectangle2Di rect)
+{
+    BeginDebugUIPanel(ui, "timing", rect);
+    for(u32 i = 0; i < ArrayCount(TimingRecords); ++i)
+    {
+        timing_record *record = TimingRecords + i;
+        if(record->FunctionName)
+        {
+            DebugUIPrintf(ui, "%-20.20s %9llucy %5uh", record->FunctionName, record->LastCycleCount, record->LastHitCount);
+        }
+    }
+    EndDebugUIPanel(ui);
+}
+#endif
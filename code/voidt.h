@@ -31,6 +31,11 @@
 #include "audio/sound.cpp"
 #include "renderer/font.h"
 #include "renderer/font.cpp"
+#if INTERNAL
+#include "renderer/debug_ui.h"
+#include "renderer/debug_ui.cpp"
+#endif
+#include "common/vpak.h"
 #include "common/asset.h"
 #include "common/asset.cpp"
 
@@ -69,6 +74,15 @@ struct game_state
     
     Texture letterN;
     
+    post_process_settings PostProcess;
+    particle_system Particles;
+    
+    // background star field
+    tilemap Background;
+    Texture BackgroundTileset;
+    
+    sprite_cache SpriteCache;
+    
     // audio/sound
     SoundMixer Mixer;
     PlayingSound *Music;
@@ -76,6 +90,14 @@ struct game_state
     // debug
     real32 FireDelay;
     real32 ExplosionDelay;
+    render_stats RenderStats; // NOTE(Joey): also picks the next frame's render tile grid
+#if INTERNAL
+    bool32 ShowRenderStats;
+    bool32 ShowDebugUI;
+    debug_ui DebugUI;
+    bool32 ShowDebugDraw;
+    debug_draw_buffer DebugDraw;
+#endif
 };
 
 struct TransientState 
@@ -86,6 +108,15 @@ struct TransientState
         
     // assets
     GameAssets Assets;        
+    asset_id   PlayerTexture; // NOTE(Joey): interned once at startup; see GetAssetID
+    asset_id   EnemyTexture;
+    asset_id   MusicSound;
+    asset_id   GunSound;
+    asset_id   ExplosionSound;
+    
+    // NOTE(Joey): backdrops too large to keep resident are streamed in as virtual textures
+    virtual_texture_cache VirtualTextures;
+    virtual_texture      *Background;
 };
 
 #include "entities/sim_region.h"
@@ -158,17 +158,30 @@ typedef PLATFORM_WRITE_DEBUG_OUTPUT(platform_write_debug_output);
 struct platform_file_handle 
 {
     b32 HasErrors;
+    u64 Size; // NOTE(Joey): of the file in bytes, as of opening it
 };
 
 typedef platform_file_handle* platform_open_file(char *fileName);
 typedef void                  platform_read_file(platform_file_handle *file, u64 offset, u64 size, void* dest);
 typedef void                  platform_close_file(platform_file_handle *file);
 
+// NOTE(Joey): read-only view of an entire file; the OS specific handles follow it (see platform_file_handle)
+struct platform_mapped_file
+{
+    b32   HasErrors;
+    u64   Size;
+    void *Memory;
+};
+
+typedef platform_mapped_file* platform_map_file(char *fileName);
+typedef void                  platform_unmap_file(platform_mapped_file *file);
+
 struct platform_api
 {
     // threading
     platform_work_queue *WorkQueueHighPriority;
     platform_work_queue *WorkQueueLowPriority;
+    uint32 HighPriorityThreadCount; // NOTE(Joey): worker threads of WorkQueueHighPriority (excluding the main thread)
     
     platform_add_work_entry    *AddWorkEntry;
     platform_complete_all_work *CompleteAllWork;
@@ -181,6 +194,8 @@ struct platform_api
     platform_open_file  *OpenFile;
     platform_read_file  *ReadFile;
     platform_close_file *CloseFile;
+    platform_map_file   *MapFile;
+    platform_unmap_file *UnmapFile;
     
     // output
     platform_write_debug_output *WriteDebugOutput;    
@@ -199,6 +214,10 @@ struct game_memory
     
     platform_api PlatformAPI;
     
+#if INTERNAL
+    bool32 RunRenderRegression; // NOTE(Joey): run the render regression suite; see RunRenderRegression
+#endif
+    
     // platform_work_queue *WorkQueueHighPriority;
     // platform_work_queue *WorkQueueLowPriority;
     
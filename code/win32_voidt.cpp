@@ -31,6 +31,7 @@
 #include <dsound.h> // DirectSound
 #include <stdio.h> // c standard runtime/library
 #include <stdarg.h> // va_args 
+#include <string.h> // strstr
 
 #include "win32_voidt.h"
 
@@ -887,6 +888,252 @@ void WorkTestEntry(platform_work_queue *queue, void *data)
     OutputDebugStringA((const char*)data);    
 }
 
+/* NOTE(Joey):
+
+  Frame capture. Each frame the main thread only copies the back buffer into
+  one of WIN32_CAPTURE_SLOT_COUNT preallocated slots; a capture thread then
+  converts slots to YUV420 and appends them to a .y4m file (a plain header
+  followed by raw planes per frame, which most video tools read directly).
+  If the capture thread falls behind and all slots are taken the frame is
+  dropped; the capture thread repeats the previous frame in its place s.t.
+  the video keeps its timing.
+
+  Conversion uses BT.601 limited range coefficients in 8.8 fixed point; 
+  chroma is the average of each 2x2 block of pixels. The back buffer is 
+  stored bottom-up, the video top-down.
+
+*/
+inline __m128i Win32LoadChannels_8x(uint32 *pixels, int shift)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i lo = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128((__m128i*)pixels), shift), mask);
+    __m128i hi = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128((__m128i*)(pixels + 4)), shift), mask);
+    return _mm_packs_epi32(lo, hi);
+}
+
+inline uint8 Win32GetLuma(uint32 color)
+{
+    uint32 r = (color >> 16) & 0xFF, g = (color >> 8) & 0xFF, b = color & 0xFF;
+    return (uint8)(((66*r + 129*g + 25*b + 128) >> 8) + 16);
+}
+
+internal void Win32ConvertBGRAToYUV420(void *memory, int32 width, int32 height, uint32 pitch, uint8 *planes)
+{
+    int32 chromaWidth  = (width + 1) / 2;
+    int32 chromaHeight = (height + 1) / 2;
+    uint8 *planeY = planes;
+    uint8 *planeU = planeY + width*height;
+    uint8 *planeV = planeU + chromaWidth*chromaHeight;
+    
+    const __m128i lumaR  = _mm_set1_epi16(66);
+    const __m128i lumaG  = _mm_set1_epi16(129);
+    const __m128i lumaB  = _mm_set1_epi16(25);
+    const __m128i lumaBias = _mm_set1_epi16(128 + (16 << 8));
+    const __m128i chromaUR = _mm_set1_epi16(-38);
+    const __m128i chromaUG = _mm_set1_epi16(-74);
+    const __m128i chromaVG = _mm_set1_epi16(-94);
+    const __m128i chromaVB = _mm_set1_epi16(-18);
+    const __m128i chroma112 = _mm_set1_epi16(112);
+    const __m128i chromaBias = _mm_set1_epi16(128);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i two = _mm_set1_epi32(2);
+    
+    for(int32 y = 0; y < height; y += 2)
+    {
+        // NOTE(Joey): last row is repeated for odd heights
+        uint32 *row0 = (uint32*)((uint8*)memory + (height - 1 - y)*pitch);
+        uint32 *row1 = y + 1 < height ? (uint32*)((uint8*)row0 - pitch) : row0;
+        uint8 *destY0 = planeY + y*width;
+        uint8 *destY1 = y + 1 < height ? destY0 + width : destY0;
+        uint8 *destU  = planeU + (y / 2)*chromaWidth;
+        uint8 *destV  = planeV + (y / 2)*chromaWidth;
+        
+        int32 x = 0;
+        for(; x + 8 <= width; x += 8)
+        {
+            __m128i r0 = Win32LoadChannels_8x(row0 + x, 16);
+            __m128i g0 = Win32LoadChannels_8x(row0 + x, 8);
+            __m128i b0 = Win32LoadChannels_8x(row0 + x, 0);
+            __m128i r1 = Win32LoadChannels_8x(row1 + x, 16);
+            __m128i g1 = Win32LoadChannels_8x(row1 + x, 8);
+            __m128i b1 = Win32LoadChannels_8x(row1 + x, 0);
+            
+            // NOTE(Joey): luma fits in unsigned 16 bit before the shift
+            __m128i y0 = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(r0, lumaR), _mm_mullo_epi16(g0, lumaG)),
+                                       _mm_add_epi16(_mm_mullo_epi16(b0, lumaB), lumaBias));
+            __m128i y1 = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(r1, lumaR), _mm_mullo_epi16(g1, lumaG)),
+                                       _mm_add_epi16(_mm_mullo_epi16(b1, lumaB), lumaBias));
+            __m128i luma = _mm_packus_epi16(_mm_srli_epi16(y0, 8), _mm_srli_epi16(y1, 8));
+            _mm_storel_epi64((__m128i*)(destY0 + x), luma);
+            _mm_storel_epi64((__m128i*)(destY1 + x), _mm_srli_si128(luma, 8));
+            
+            // NOTE(Joey): average 2x2 blocks; madd w/ ones sums horizontal pairs
+            __m128i r = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_add_epi16(r0, r1), one), two), 2);
+            __m128i g = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_add_epi16(g0, g1), one), two), 2);
+            __m128i b = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_add_epi16(b0, b1), one), two), 2);
+            __m128i rb = _mm_packs_epi32(r, b); // NOTE(Joey): 4 r, 4 b
+            __m128i gg = _mm_packs_epi32(g, g);
+            __m128i br = _mm_shuffle_epi32(rb, _MM_SHUFFLE(1, 0, 3, 2));
+            
+            // NOTE(Joey): low half computes U, high half V: (112*b - 38*r - 74*g) and (112*r - 94*g - 18*b)
+            __m128i coeffOther = _mm_unpacklo_epi64(chromaUR, chromaVB);
+            __m128i coeffG     = _mm_unpacklo_epi64(chromaUG, chromaVG);
+            __m128i chroma = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(br, chroma112), _mm_mullo_epi16(rb, coeffOther)),
+                                           _mm_add_epi16(_mm_mullo_epi16(gg, coeffG), chromaBias));
+            chroma = _mm_add_epi16(_mm_srai_epi16(chroma, 8), chromaBias);
+            chroma = _mm_packus_epi16(chroma, chroma);
+            *(uint32*)(destU + x/2) = (uint32)_mm_cvtsi128_si32(chroma);
+            *(uint32*)(destV + x/2) = (uint32)_mm_cvtsi128_si32(_mm_srli_si128(chroma, 4));
+        }
+        for(; x < width; x += 2)
+        {
+            int32 x1 = x + 1 < width ? x + 1 : x;
+            uint32 colors[4] = { row0[x], row0[x1], row1[x], row1[x1] };
+            destY0[x] = Win32GetLuma(colors[0]);
+            destY1[x] = Win32GetLuma(colors[2]);
+            destY0[x1] = Win32GetLuma(colors[1]);
+            destY1[x1] = Win32GetLuma(colors[3]);
+            
+            int32 r = 0, g = 0, b = 0;
+            for(int32 i = 0; i < 4; ++i)
+            {
+                r += (colors[i] >> 16) & 0xFF;
+                g += (colors[i] >> 8) & 0xFF;
+                b += colors[i] & 0xFF;
+            }
+            r = (r + 2) >> 2;
+            g = (g + 2) >> 2;
+            b = (b + 2) >> 2;
+            destU[x/2] = (uint8)(((112*b - 38*r - 74*g + 128) >> 8) + 128);
+            destV[x/2] = (uint8)(((112*r - 94*g - 18*b + 128) >> 8) + 128);
+        }
+    }
+}
+
+internal void Win32WriteCaptureFrame(win32_frame_capture *capture)
+{
+    DWORD bytesWritten;
+    WriteFile(capture->FileHandle, "FRAME\n", 6, &bytesWritten, 0);
+    WriteFile(capture->FileHandle, capture->Planes, capture->PlanesSize, &bytesWritten, 0);
+    ++capture->WrittenCount;
+}
+
+DWORD WINAPI Win32CaptureThread(LPVOID lpParameter)
+{
+    win32_frame_capture *capture = (win32_frame_capture*)lpParameter;
+    for(;;)
+    {
+        WaitForSingleObjectEx(capture->SemaphoreHandle, INFINITE, FALSE);
+        while(capture->NextSlotToRead != capture->NextSlotToWrite)
+        {
+            win32_capture_slot *slot = capture->Slots + (capture->NextSlotToRead % WIN32_CAPTURE_SLOT_COUNT);
+            
+            // NOTE(Joey): repeat the last frame for each dropped one
+            if(capture->WrittenCount > 0)
+            {
+                for(uint32 frame = capture->LastFrameIndex + 1; frame < slot->FrameIndex; ++frame)
+                    Win32WriteCaptureFrame(capture);
+            }
+            Win32ConvertBGRAToYUV420(slot->Memory, capture->Width, capture->Height, capture->Pitch, capture->Planes);
+            Win32WriteCaptureFrame(capture);
+            capture->LastFrameIndex = slot->FrameIndex;
+            
+            // NOTE(Joey): make sure the slot is fully read before handing it back
+            _ReadWriteBarrier();
+            InterlockedIncrement((LONG volatile *)&capture->NextSlotToRead);
+        }
+        if(capture->Stop)
+            break;
+    }
+    return 0;
+}
+
+// NOTE(Joey): starts capturing the back buffer's frames to a .y4m video at the given frame rate
+internal bool32 Win32BeginFrameCapture(win32_frame_capture *capture, char *fileName, win32_offscreen_buffer *buffer, int32 framesPerSecond)
+{
+    *capture = {};
+    capture->FileHandle = CreateFileA(fileName, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if(capture->FileHandle == INVALID_HANDLE_VALUE)
+    {
+        OutputDebugStringA("capture: failed to create file\n");
+        return false;
+    }
+    capture->Width  = buffer->Width;
+    capture->Height = buffer->Height;
+    capture->Pitch  = buffer->Pitch;
+    
+    char header[128];
+    int32 headerLength = _snprintf_s(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", 
+                                     capture->Width, capture->Height, framesPerSecond);
+    DWORD bytesWritten;
+    WriteFile(capture->FileHandle, header, headerLength, &bytesWritten, 0);
+    
+    // NOTE(Joey): all memory is allocated up front; capturing a frame never allocates
+    uint32 slotSize = capture->Height*capture->Pitch;
+    for(uint32 i = 0; i < WIN32_CAPTURE_SLOT_COUNT; ++i)
+        capture->Slots[i].Memory = VirtualAlloc(0, slotSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    uint32 chromaSize = ((capture->Width + 1) / 2) * ((capture->Height + 1) / 2);
+    capture->PlanesSize = capture->Width*capture->Height + 2*chromaSize;
+    capture->Planes = (uint8*)VirtualAlloc(0, capture->PlanesSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    
+    capture->SemaphoreHandle = CreateSemaphoreEx(0, 0, WIN32_CAPTURE_SLOT_COUNT + 1, 0, 0, SEMAPHORE_ALL_ACCESS);
+    capture->ThreadHandle = CreateThread(0, 0, Win32CaptureThread, capture, 0, 0);
+    return true;
+}
+
+// NOTE(Joey): main thread side; a copy of the back buffer w/ non-temporal stores (the main thread never reads it)
+internal void Win32CaptureFrame(win32_frame_capture *capture, win32_offscreen_buffer *buffer)
+{
+    LARGE_INTEGER start = Win32GetWallClock();
+    
+    uint32 frameIndex = capture->FrameIndex++;
+    if(capture->NextSlotToWrite - capture->NextSlotToRead >= WIN32_CAPTURE_SLOT_COUNT)
+    {
+        ++capture->DroppedCount;
+        return;
+    }
+    Assert(buffer->Width == capture->Width && buffer->Height == capture->Height);
+    
+    win32_capture_slot *slot = capture->Slots + (capture->NextSlotToWrite % WIN32_CAPTURE_SLOT_COUNT);
+    uint32 size = capture->Height*capture->Pitch;
+    __m128i *src  = (__m128i*)buffer->Memory;
+    __m128i *dest = (__m128i*)slot->Memory;
+    for(uint32 i = 0; i < size / 16; ++i)
+        _mm_stream_si128(dest + i, _mm_load_si128(src + i));
+    Win32CopyMemory((uint8*)buffer->Memory + (size & ~15), (uint8*)slot->Memory + (size & ~15), size & 15);
+    slot->FrameIndex = frameIndex;
+    
+    // NOTE(Joey): streaming stores aren't ordered w/ regular stores; fence before publishing the slot
+    _mm_sfence();
+    _WriteBarrier();
+    ++capture->NextSlotToWrite;
+    ReleaseSemaphore(capture->SemaphoreHandle, 1, 0);
+    
+    capture->CopySeconds += Win32GetSecondsElapsed(start, Win32GetWallClock());
+}
+
+// NOTE(Joey): waits for the capture thread to write out all captured frames and reports the capture's stats
+internal void Win32EndFrameCapture(win32_frame_capture *capture)
+{
+    capture->Stop = true;
+    ReleaseSemaphore(capture->SemaphoreHandle, 1, 0);
+    WaitForSingleObject(capture->ThreadHandle, INFINITE);
+    
+    CloseHandle(capture->ThreadHandle);
+    CloseHandle(capture->SemaphoreHandle);
+    CloseHandle(capture->FileHandle);
+    for(uint32 i = 0; i < WIN32_CAPTURE_SLOT_COUNT; ++i)
+        VirtualFree(capture->Slots[i].Memory, 0, MEM_RELEASE);
+    VirtualFree(capture->Planes, 0, MEM_RELEASE);
+    
+    uint32 capturedCount = capture->FrameIndex - capture->DroppedCount;
+    char report[256];
+    _snprintf_s(report, sizeof(report), "capture: %u frames written, %u dropped (repeated in the video), %.3fms/f main thread copy\n",
+                capture->WrittenCount, capture->DroppedCount, 
+                capturedCount ? 1000.0f*capture->CopySeconds / capturedCount : 0.0f);
+    OutputDebugStringA(report);
+}
+
 struct win32_file_handle 
 {
     platform_file_handle H;
@@ -904,7 +1151,12 @@ internal platform_file_handle* Win32OpenFile(char *filename)
     if(fileHandle)
     {
         fileHandle->Win32Handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
-        fileHandle->H.HasErrors = fileHandle->Win32Handle != INVALID_HANDLE_VALUE;
+        fileHandle->H.HasErrors = fileHandle->Win32Handle == INVALID_HANDLE_VALUE;
+        fileHandle->H.Size = 0;
+        
+        LARGE_INTEGER fileSize;
+        if(!fileHandle->H.HasErrors && GetFileSizeEx(fileHandle->Win32Handle, &fileSize))
+            fileHandle->H.Size = fileSize.QuadPart;
     }  
     
     return (platform_file_handle*)fileHandle;
@@ -948,7 +1200,51 @@ internal void Win32ReadFile(platform_file_handle *file, u64 offset, u64 size, vo
 internal void Win32CloseFile(platform_file_handle *file)
 {
     win32_file_handle *handle = (win32_file_handle*)file;
-    CloseHandle(handle->Win32Handle);
+    if(handle->Win32Handle != INVALID_HANDLE_VALUE)
+        CloseHandle(handle->Win32Handle);
+    VirtualFree(handle, 0, MEM_RELEASE);
+}
+
+struct win32_mapped_file
+{
+    platform_mapped_file H;
+    
+    HANDLE Win32Handle;
+    HANDLE Win32Mapping;
+};
+
+internal platform_mapped_file* Win32MapFile(char *filename)
+{
+    // NOTE(Joey): VirtualAlloc'd memory is zeroed, so the handle starts out w/o a mapping
+    win32_mapped_file *file = (win32_mapped_file*)VirtualAlloc(0, sizeof(win32_mapped_file), MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+    
+    if(file)
+    {
+        file->Win32Handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+        LARGE_INTEGER fileSize;
+        if(file->Win32Handle != INVALID_HANDLE_VALUE && GetFileSizeEx(file->Win32Handle, &fileSize) && fileSize.QuadPart > 0)
+        {
+            file->H.Size = fileSize.QuadPart;
+            file->Win32Mapping = CreateFileMappingA(file->Win32Handle, 0, PAGE_READONLY, 0, 0, 0);
+            if(file->Win32Mapping)
+                file->H.Memory = MapViewOfFile(file->Win32Mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+        file->H.HasErrors = file->H.Memory == 0;
+    }
+    
+    return (platform_mapped_file*)file;
+}
+
+internal void Win32UnmapFile(platform_mapped_file *file)
+{
+    win32_mapped_file *handle = (win32_mapped_file*)file;
+    if(handle->H.Memory)
+        UnmapViewOfFile(handle->H.Memory);
+    if(handle->Win32Mapping)
+        CloseHandle(handle->Win32Mapping);
+    if(handle->Win32Handle != INVALID_HANDLE_VALUE)
+        CloseHandle(handle->Win32Handle);
+    VirtualFree(handle, 0, MEM_RELEASE);
 }
 
 int CALLBACK WinMain(
@@ -993,8 +1289,12 @@ int CALLBACK WinMain(
          
     
     // initialize thread work queue(s)
+    // NOTE(Joey): the main thread also takes work while waiting on the high priority queue
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    uint32 highPriorityThreadCount = systemInfo.dwNumberOfProcessors > 1 ? systemInfo.dwNumberOfProcessors - 1 : 1;
     platform_work_queue queueHighPriority = {};
-    Win32MakeWorkQueue(&queueHighPriority, 6);
+    Win32MakeWorkQueue(&queueHighPriority, highPriorityThreadCount);
     platform_work_queue queueLowPriority = {};
     Win32MakeWorkQueue(&queueLowPriority, 2);
     
@@ -1066,13 +1366,24 @@ int CALLBACK WinMain(
             // win32State.GameReplayMemoryBlock= VirtualAlloc(0, (size_t)win32State.TotalSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
             gameMemory.PermanentStorage     = win32State.GameMemoryBlock;
             gameMemory.TransientStorage     = (uint8 *)gameMemory.PermanentStorage + gameMemory.PermanentStorageSize;            
+#if INTERNAL
+            // NOTE(Joey): -regression runs the render regression suite on the first frame and quits
+            gameMemory.RunRenderRegression  = strstr(cmdLine, "-regression") != 0;
+            bool32 regressionOnly           = gameMemory.RunRenderRegression;
+#endif
             gameMemory.PlatformAPI.DEBUGFreeFileMemory   = DEBUGPlatformFreeFileMemory;
             gameMemory.PlatformAPI.DEBUGReadEntireFile   = DEBUGPlatformReadEntireFile;
             gameMemory.PlatformAPI.DEBUGWriteEntireFile = DEBUGPlatformWriteEntireFile;
+            gameMemory.PlatformAPI.OpenFile             = Win32OpenFile;
+            gameMemory.PlatformAPI.ReadFile             = Win32ReadFile;
+            gameMemory.PlatformAPI.CloseFile            = Win32CloseFile;
+            gameMemory.PlatformAPI.MapFile              = Win32MapFile;
+            gameMemory.PlatformAPI.UnmapFile            = Win32UnmapFile;
             gameMemory.PlatformAPI.WriteDebugOutput      = Win32WriteDebugOutput;
             
             gameMemory.PlatformAPI.WorkQueueHighPriority = &queueHighPriority;
             gameMemory.PlatformAPI.WorkQueueLowPriority  = &queueLowPriority;
+            gameMemory.PlatformAPI.HighPriorityThreadCount = highPriorityThreadCount;
             gameMemory.PlatformAPI.AddWorkEntry          = Win32AddWorkEntry;
             gameMemory.PlatformAPI.CompleteAllWork       = Win32CompleteAllWork;
             
@@ -1095,6 +1406,16 @@ int CALLBACK WinMain(
                 real32 audioLatencySeconds = 0.0f;
                 
                 
+                // NOTE(Joey): -capture records all frames to capture.y4m next to the executable
+                win32_frame_capture capture = {};
+                bool32 capturing = false;
+                if(strstr(cmdLine, "-capture"))
+                {
+                    char captureFileName[MAX_PATH];
+                    Win32BuildEXEPathFileName(&win32State, "capture.y4m", sizeof(captureFileName), captureFileName);
+                    capturing = Win32BeginFrameCapture(&capture, captureFileName, &GlobalBackBuffer, monitorRefreshHz);
+                }
+                
                 GlobalRunning = true;                
                 LARGE_INTEGER lastCounter = Win32GetWallClock();
                 LARGE_INTEGER flipWallClock = Win32GetWallClock();
@@ -1230,6 +1551,12 @@ int CALLBACK WinMain(
                     if(win32State.InputPlayingIndex)
                         Win32PlaybackInput(&win32State, newInput);
                     game.UpdateAndRender(&thread, &gameMemory, newInput, &buffer);
+                    if(capturing)
+                        Win32CaptureFrame(&capture, &GlobalBackBuffer);
+#if INTERNAL
+                    if(regressionOnly)
+                        GlobalRunning = false;
+#endif
                     
                    
                     
@@ -1383,6 +1710,8 @@ int CALLBACK WinMain(
                     OutputDebugStringA(charBuffer);
   
                 }
+                if(capturing)
+                    Win32EndFrameCapture(&capture);
             }
             else
             {
@@ -60,6 +60,43 @@ struct win32_replay_buffer
 {
     void *MemoryBlock;
 };
+// NOTE(Joey): frame capture to a .y4m video; see Win32BeginFrameCapture
+const uint32 WIN32_CAPTURE_SLOT_COUNT = 8;
+
+struct win32_capture_slot
+{
+    void  *Memory;     // NOTE(Joey): BGRA copy of the back buffer
+    uint32 FrameIndex;
+};
+
+struct win32_frame_capture
+{
+    HANDLE FileHandle;
+    HANDLE ThreadHandle;
+    HANDLE SemaphoreHandle; // NOTE(Joey): released once per captured frame and once to stop
+    
+    int32  Width;
+    int32  Height;
+    uint32 Pitch;
+    
+    win32_capture_slot Slots[WIN32_CAPTURE_SLOT_COUNT];
+    uint8 *Planes;          // NOTE(Joey): Y, U and V planes of the last converted frame
+    uint32 PlanesSize;
+    
+    volatile uint32 NextSlotToWrite; // NOTE(Joey): only ever incremented; the slot is the index modulo the slot count
+    volatile uint32 NextSlotToRead;
+    volatile bool32 Stop;
+    
+    // NOTE(Joey): main thread
+    uint32 FrameIndex;      // NOTE(Joey): frames offered for capture, including the dropped ones
+    uint32 DroppedCount;
+    real32 CopySeconds;     
+    
+    // NOTE(Joey): capture thread
+    uint32 WrittenCount;    // NOTE(Joey): frames in the video, including repeats of dropped frames
+    uint32 LastFrameIndex;
+};
+
 struct win32_state 
 {
     uint64 TotalSize;